@@ -61,6 +61,9 @@ static void my_spp_cb(esp_spp_cb_event_t event, esp_spp_cb_param_t* param) {
         grbl_send(CLIENT_ALL, "[MSG:BT Disconnected]\r\n");
         BTConfig::_btclient = "";
         break;
+    case ESP_SPP_DATA_IND_EVT: // Data received. Wake the input task to read it.
+        serial_notify_rx();
+        break;
     default:
         break;
     }
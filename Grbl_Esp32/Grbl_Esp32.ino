@@ -63,6 +63,7 @@ void setup() {
     report_machine_type(CLIENT_SERIAL);
 #endif
     settings_init(); // Load Grbl settings from EEPROM
+    plan_init();     // Allocate the planner block buffer sized by $Planner/Blocks
     stepper_init();  // Configure stepper pins and interrupt timers
     init_motors();
     system_ini();   // Configure pinout pins and pin-change interrupt (Renamed due to conflict with esp32 files)
@@ -122,11 +123,15 @@ void loop() {
     sys_rt_exec_accessory_override = 0;
     // Reset Grbl primary systems.
     serial_reset_read_buffer(CLIENT_ALL); // Clear serial read buffer
+#ifdef ENABLE_SD_CARD
+    sd_close_deferred(); // A job stopped by a limit switch interrupt
+#endif
     gc_init(); // Set g-code parser to default state
     spindle->stop();
     coolant_init();
     limits_init();
     probe_init();
+    mc_line_queue_reset(); // Discard lines parsed ahead of the planner
     plan_reset(); // Clear block buffer and planner variables
     st_reset(); // Clear stepper subsystem variables
     // Sync cleared gcode and planner positions to current system position.
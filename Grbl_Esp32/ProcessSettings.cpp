@@ -300,6 +300,63 @@ err_t showState(const char* value, auth_t auth_level, ESPResponseStream* out) {
     grbl_sendf(out->client(), "State 0x%x\r\n", sys.state);
     return STATUS_OK;
 }
+err_t show_motion_stats(const char* value, auth_t auth_level, ESPResponseStream* out) {
+    // $MS=ON and $MS=OFF switch the stage profiler. Any other value, e.g. $MS=RST, clears the
+    // counters before a measurement run.
+    if (value) {
+        if (strcasecmp(value, "ON") == 0)
+            motion_profile_enable(true);
+        else if (strcasecmp(value, "OFF") == 0)
+            motion_profile_enable(false);
+        else
+            motion_stats_reset();
+        return STATUS_OK;
+    }
+    report_motion_stats(out->client());
+    return STATUS_OK;
+}
+err_t bench_stepper_kernel(const char* value, auth_t auth_level, ESPResponseStream* out) {
+    st_benchmark_kernel(out->client());
+    return STATUS_OK;
+}
+#ifdef STEPPER_ISR_TIMING
+err_t show_stepper_timing(const char* value, auth_t auth_level, ESPResponseStream* out) {
+    // Any value, e.g. $ST=RST, clears the samples before a measurement run.
+    if (value) {
+        st_timing_reset();
+        return STATUS_OK;
+    }
+    report_st_timing(out->client());
+    return STATUS_OK;
+}
+#endif
+err_t set_autoreport(const char* value, auth_t auth_level, ESPResponseStream* out) {
+    // $RA=<msec> pushes a status report to this client every <msec>, $RA=<msec>,C only the
+    // fields that changed, $RA=0 stops it. $RA shows the subscription.
+    if (!value) {
+        report_autoreport(out->client());
+        return STATUS_OK;
+    }
+    char* rest;
+    uint32_t interval = strtoul(value, &rest, 10);
+    if (rest == value)
+        return STATUS_BAD_NUMBER_FORMAT;
+    bool changed = false;
+    if (*rest == ',') {
+        if (strcasecmp(rest + 1, "C") != 0)
+            return STATUS_INVALID_VALUE;
+        changed = true;
+    } else if (*rest != '\0')
+        return STATUS_BAD_NUMBER_FORMAT;
+    return report_autoreport_set(out->client(), interval, changed);
+}
+err_t bench_report_writer(const char* value, auth_t auth_level, ESPResponseStream* out) {
+    report_benchmark(out->client());
+    return STATUS_OK;
+}
+err_t start_binary_stream(const char* value, auth_t auth_level, ESPResponseStream* out) {
+    return binary_stream_start(out->client());
+}
 err_t doJog(const char* value, auth_t auth_level, ESPResponseStream* out) {
     // For jogging, you must give gc_execute_line() a line that
     // begins with $J=.  There are several ways we can get here,
@@ -353,6 +410,7 @@ std::map<uint8_t, const char*> ErrorCodes = {
     { STATUS_GCODE_G43_DYNAMIC_AXIS_ERROR , "Gcode G43 dynamic axis error", },
     { STATUS_GCODE_MAX_VALUE_EXCEEDED , "Gcode max value exceeded", },
     { STATUS_P_PARAM_MAX_EXCEEDED , "P param max exceeded", },
+    { STATUS_GCODE_SPLINE_PLANE , "G5 requires G17", },
     { STATUS_SD_FAILED_MOUNT , "SD failed mount", },
     { STATUS_SD_FAILED_READ , "SD failed read", },
     { STATUS_SD_FAILED_OPEN_DIR , "SD failed to open directory", },
@@ -425,6 +483,14 @@ void make_grbl_commands() {
     new GrblCommand("X",   "Alarm/Disable",  disable_alarm_lock, ANY_STATE);
     new GrblCommand("NVX", "Settings/Erase", Setting::eraseNVS, IDLE_OR_ALARM, WA);
     new GrblCommand("V",   "Settings/Stats", Setting::report_nvs_stats, IDLE_OR_ALARM);
+    new GrblCommand("MS",  "Motion/Stats",   show_motion_stats, ANY_STATE);
+    new GrblCommand("SB",  "Stepper/Bench",  bench_stepper_kernel, IDLE_OR_ALARM);
+    new GrblCommand("BIN", "Stream/Binary",  start_binary_stream, IDLE_OR_ALARM);
+    new GrblCommand("RA",  "Report/Auto",    set_autoreport, ANY_STATE);
+    new GrblCommand("RB",  "Report/Bench",   bench_report_writer, IDLE_OR_ALARM);
+    #ifdef STEPPER_ISR_TIMING
+        new GrblCommand("ST",  "Stepper/Timing", show_stepper_timing, ANY_STATE);
+    #endif
     new GrblCommand("#",   "GCode/Offsets",  report_ngc, IDLE_OR_ALARM);
     new GrblCommand("H",   "Home",           home_all, IDLE_OR_ALARM);
     #ifdef HOMING_SINGLE_AXIS_COMMANDS
@@ -306,6 +306,7 @@ public:
     FloatSetting *steps_per_mm;
     FloatSetting *max_rate;
     FloatSetting *acceleration;
+    FloatSetting *jerk;
     FloatSetting *max_travel;
     FloatSetting *run_current;
     FloatSetting *hold_current;
@@ -48,6 +48,12 @@ FloatSetting* spindle_pwm_max_value;
 IntSetting* spindle_pwm_bit_precision;
 
 EnumSetting* spindle_type;
+EnumSetting* motion_profile;
+
+IntSetting* planner_blocks;
+IntSetting* segment_buffer_time;
+FloatSetting* arc_chord_time;
+IntSetting* sd_checkpoint_time;
 
 enum_opt_t spindleTypes = {
     { "NONE", SPINDLE_TYPE_NONE, },
@@ -60,6 +66,11 @@ enum_opt_t spindleTypes = {
     { "10V", SPINDLE_TYPE_10V, },
 };
 
+enum_opt_t motionProfiles = {
+    { "TRAPEZOID", MOTION_PROFILE_TRAPEZOID, },
+    { "SCURVE", MOTION_PROFILE_SCURVE, },
+};
+
 AxisSettings* x_axis_settings;
 AxisSettings* y_axis_settings;
 AxisSettings* z_axis_settings;
@@ -74,6 +85,7 @@ typedef struct {
     float steps_per_mm;
     float max_rate;
     float acceleration;
+    float jerk;
     float max_travel;
     float run_current;
     float hold_current;
@@ -86,6 +98,7 @@ axis_defaults_t axis_defaults[] = {
         DEFAULT_X_STEPS_PER_MM,
         DEFAULT_X_MAX_RATE,
         DEFAULT_X_ACCELERATION,
+        DEFAULT_X_JERK,
         DEFAULT_X_MAX_TRAVEL,
         DEFAULT_X_CURRENT,
         DEFAULT_X_HOLD_CURRENT,
@@ -97,6 +110,7 @@ axis_defaults_t axis_defaults[] = {
         DEFAULT_Y_STEPS_PER_MM,
         DEFAULT_Y_MAX_RATE,
         DEFAULT_Y_ACCELERATION,
+        DEFAULT_Y_JERK,
         DEFAULT_Y_MAX_TRAVEL,
         DEFAULT_Y_CURRENT,
         DEFAULT_Y_HOLD_CURRENT,
@@ -108,6 +122,7 @@ axis_defaults_t axis_defaults[] = {
         DEFAULT_Z_STEPS_PER_MM,
         DEFAULT_Z_MAX_RATE,
         DEFAULT_Z_ACCELERATION,
+        DEFAULT_Z_JERK,
         DEFAULT_Z_MAX_TRAVEL,
         DEFAULT_Z_CURRENT,
         DEFAULT_Z_HOLD_CURRENT,
@@ -119,6 +134,7 @@ axis_defaults_t axis_defaults[] = {
         DEFAULT_A_STEPS_PER_MM,
         DEFAULT_A_MAX_RATE,
         DEFAULT_A_ACCELERATION,
+        DEFAULT_A_JERK,
         DEFAULT_A_MAX_TRAVEL,
         DEFAULT_A_CURRENT,
         DEFAULT_A_HOLD_CURRENT,
@@ -130,6 +146,7 @@ axis_defaults_t axis_defaults[] = {
         DEFAULT_B_STEPS_PER_MM,
         DEFAULT_B_MAX_RATE,
         DEFAULT_B_ACCELERATION,
+        DEFAULT_B_JERK,
         DEFAULT_B_MAX_TRAVEL,
         DEFAULT_B_CURRENT,
         DEFAULT_B_HOLD_CURRENT,
@@ -141,6 +158,7 @@ axis_defaults_t axis_defaults[] = {
         DEFAULT_C_STEPS_PER_MM,
         DEFAULT_C_MAX_RATE,
         DEFAULT_C_ACCELERATION,
+        DEFAULT_C_JERK,
         DEFAULT_C_MAX_TRAVEL,
         DEFAULT_C_CURRENT,
         DEFAULT_C_HOLD_CURRENT,
@@ -249,6 +267,12 @@ void make_settings() {
         setting->setAxis(axis);
         axis_settings[axis]->max_travel = setting;
     }
+    for (axis = N_AXIS - 1; axis >= 0; axis--) {
+        def = &axis_defaults[axis];
+        auto setting = new FloatSetting(EXTENDED, WG, NULL, makename(def->name, "Jerk"), def->jerk, 1.0, 10000000.0); // mm/sec^3
+        setting->setAxis(axis);
+        axis_settings[axis]->jerk = setting;
+    }
     for (axis = N_AXIS - 1; axis >= 0; axis--) {
         def = &axis_defaults[axis];
         auto setting = new FloatSetting(GRBL, WG, makeGrblName(axis, 120), makename(def->name, "Acceleration"), def->acceleration, 1.0, 100000.0);
@@ -316,5 +340,11 @@ void make_settings() {
     stepper_idle_lock_time = new IntSetting(GRBL, WG, "1", "Stepper/IdleTime", DEFAULT_STEPPER_IDLE_LOCK_TIME, 0, 255);
     pulse_microseconds = new IntSetting(GRBL, WG, "0", "Stepper/Pulse", DEFAULT_STEP_PULSE_MICROSECONDS, 3, 1000);
     spindle_type = new EnumSetting(NULL, EXTENDED, WG, NULL, "Spindle/Type", SPINDLE_TYPE, &spindleTypes);
+    motion_profile = new EnumSetting(NULL, EXTENDED, WG, NULL, "Stepper/Profile", DEFAULT_MOTION_PROFILE, &motionProfiles);
     stallguard_debug_mask = new AxisMaskSetting(EXTENDED, WG, NULL, "Report/StallGuard", 0, checkStallguardDebugMask);
+    // Takes effect on the next boot, when plan_init() allocates the block ring buffer.
+    planner_blocks = new IntSetting(EXTENDED, WG, NULL, "Planner/Blocks", DEFAULT_PLANNER_BLOCKS, MIN_BLOCK_BUFFER_SIZE, MAX_BLOCK_BUFFER_SIZE);
+    segment_buffer_time = new IntSetting(EXTENDED, WG, NULL, "Stepper/BufferTime", DEFAULT_SEGMENT_BUFFER_TIME, 10, 500);
+    arc_chord_time = new FloatSetting(EXTENDED, WG, NULL, "GCode/ArcChordTime", DEFAULT_ARC_CHORD_TIME, 0, 100);
+    sd_checkpoint_time = new IntSetting(EXTENDED, WG, NULL, "SD/CheckpointTime", DEFAULT_SD_CHECKPOINT_TIME, 0, 3600);
 }
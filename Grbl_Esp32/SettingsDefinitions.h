@@ -49,5 +49,11 @@ extern FloatSetting* spindle_pwm_max_value;
 extern IntSetting* spindle_pwm_bit_precision;
 
 extern EnumSetting* spindle_type;
+extern EnumSetting* motion_profile;
+
+extern IntSetting* planner_blocks;
+extern IntSetting* segment_buffer_time;
+extern FloatSetting* arc_chord_time;
+extern IntSetting* sd_checkpoint_time;
 
 extern AxisMaskSetting* stallguard_debug_mask;
@@ -427,7 +427,9 @@ static err_t showSysStats(char *parameter, auth_t auth_level) { // ESP420
     webPrintln("Flash Size: ", ESPResponseStream::formatBytes(ESP.getFlashChipSize()));
 
     // Round baudRate to nearest 100 because ESP32 can say e.g. 115201
-    webPrintln("Baud rate: ", String((Serial.baudRate()/100) * 100));
+    uint32_t baud = 0;
+    uart_get_baudrate(SERIAL_UART, &baud);
+    webPrintln("Baud rate: ", String((baud / 100) * 100));
     webPrintln("Sleep mode: ", WiFi.getSleep() ? "Modem" : "None");
 
 #ifdef ENABLE_WIFI
@@ -681,11 +683,22 @@ static err_t runSDFile(char *parameter, auth_t auth_level) { // ESP220
         webPrintln("Busy");
         return STATUS_IDLE_ERROR;
     }
+    if (job_cache_open(parameter, (espresponse) ? espresponse->client() : CLIENT_ALL)) {
+        // The protocol loop runs the records, see job_cache.h
+        SD_client = (espresponse) ? espresponse->client() : CLIENT_ALL;
+        SD_ready_next = true;
+        job_checkpoint_start(parameter);
+        report_realtime_status((espresponse) ? espresponse->client() : CLIENT_ALL);
+        webPrintln("");
+        return STATUS_OK;
+    }
     if (!openFile(SD, parameter)) {
         report_status_message(STATUS_SD_FAILED_READ, (espresponse) ? espresponse->client() : CLIENT_ALL);
         webPrintln("");
         return STATUS_OK;
     }
+    job_index_start(parameter); // The job runs from its first line, see job_index.h
+    job_checkpoint_start(parameter);
     char fileLine[255];
     if (!readFileLine(fileLine, 255)) {
         //No need notification here it is just a macro
@@ -700,6 +713,117 @@ static err_t runSDFile(char *parameter, auth_t auth_level) { // ESP220
     return STATUS_OK;
 }
 
+static err_t compileSDFile(char *parameter, auth_t auth_level) {
+    parameter = trim(parameter);
+    if (*parameter == '\0') {
+        webPrintln("Missing file name!");
+        return STATUS_INVALID_VALUE;
+    }
+    int8_t state = get_sd_state(true);
+    if (state != SDCARD_IDLE) {
+        webPrintln((state == SDCARD_NOT_PRESENT) ? "No SD card" : "Busy");
+        return (state == SDCARD_NOT_PRESENT) ? STATUS_SD_FAILED_MOUNT : STATUS_SD_FAILED_BUSY;
+    }
+    if (sys.state != STATE_IDLE) {
+        webPrintln("Busy");
+        return STATUS_IDLE_ERROR;
+    }
+    return job_cache_compile(parameter, (espresponse) ? espresponse->client() : CLIENT_ALL);
+}
+
+#ifdef USE_GCODE_FAST_PATH
+// Parses a file in check mode with both the g-code fast path and the full parser, and reports
+// every line where they plan a different move. Run it over the files in tests/ after changing
+// either path.
+static err_t checkSDFastPath(char *parameter, auth_t auth_level) {
+    parameter = trim(parameter);
+    if (*parameter == '\0') {
+        webPrintln("Missing file name!");
+        return STATUS_INVALID_VALUE;
+    }
+    int8_t state = get_sd_state(true);
+    if (state != SDCARD_IDLE) {
+        webPrintln((state == SDCARD_NOT_PRESENT) ? "No SD card" : "Busy");
+        return (state == SDCARD_NOT_PRESENT) ? STATUS_SD_FAILED_MOUNT : STATUS_SD_FAILED_BUSY;
+    }
+    if (sys.state != STATE_IDLE) {
+        webPrintln("Busy");
+        return STATUS_IDLE_ERROR;
+    }
+    if (!openFile(SD, parameter)) {
+        closeFile();
+        return STATUS_SD_FAILED_READ;
+    }
+    uint8_t client = (espresponse) ? espresponse->client() : CLIENT_ALL;
+    parser_state_t machine_state;
+    memcpy(&machine_state, &gc_state, sizeof(machine_state));
+    sys.state = STATE_CHECK_MODE;
+    char fileLine[256];
+    uint32_t lines = 0, taken = 0, differ = 0;
+    while (readFileLine(fileLine, 255)) {
+        uint8_t result;
+        err_t status = gc_fast_path_compare(fileLine, client, &result);
+        lines++;
+        if (result != GC_FAST_PATH_NOT_TAKEN)
+            taken++;
+        if (result == GC_FAST_PATH_DIFFERS) {
+            differ++;
+            grbl_sendf(client, "[MSG:Fast path differs at line %d]\r\n", sd_get_current_line_number());
+        }
+        if (status != STATUS_OK && status != STATUS_GCODE_UNSUPPORTED_COMMAND)
+            grbl_sendf(client, "[MSG:Error %d at line %d]\r\n", status, sd_get_current_line_number());
+        protocol_execute_realtime();
+        if (sys.abort)
+            break;
+    }
+    closeFile();
+    if (!sys.abort)
+        sys.state = STATE_IDLE;
+    memcpy(&gc_state, &machine_state, sizeof(gc_state));
+    grbl_sendf(client, "[MSG:%d lines, %d on the fast path, %d differ]\r\n", lines, taken, differ);
+    return STATUS_OK;
+}
+#endif
+
+static err_t resumeSDFile(char *parameter, auth_t auth_level) {
+    parameter = trim(parameter);
+    char* path;
+    uint32_t line = strtoul(parameter, &path, 10);
+    path = trim(path);
+    if (line == 0 || *path == '\0') {
+        webPrintln("Missing line number or file name!");
+        return STATUS_INVALID_VALUE;
+    }
+    int8_t state = get_sd_state(true);
+    if (state != SDCARD_IDLE) {
+        webPrintln((state == SDCARD_NOT_PRESENT) ? "No SD card" : "Busy");
+        return (state == SDCARD_NOT_PRESENT) ? STATUS_SD_FAILED_MOUNT : STATUS_SD_FAILED_BUSY;
+    }
+    if (sys.state != STATE_IDLE) {
+        webPrintln("Busy");
+        return STATUS_IDLE_ERROR;
+    }
+    err_t err = job_index_resume(path, line, (espresponse) ? espresponse->client() : CLIENT_ALL);
+    webPrintln("");
+    return err;
+}
+
+static err_t recoverSDJob(char *parameter, auth_t auth_level) {
+    parameter = trim(parameter);
+    int8_t state = get_sd_state(true);
+    if (state != SDCARD_IDLE) {
+        webPrintln((state == SDCARD_NOT_PRESENT) ? "No SD card" : "Busy");
+        return (state == SDCARD_NOT_PRESENT) ? STATUS_SD_FAILED_MOUNT : STATUS_SD_FAILED_BUSY;
+    }
+    if (sys.state != STATE_IDLE) {
+        webPrintln("Busy");
+        return STATUS_IDLE_ERROR;
+    }
+    err_t err = job_checkpoint_recover(parameter, (espresponse) ? espresponse->client() : CLIENT_ALL);
+    webPrintln("");
+    return err;
+}
+
 static err_t deleteSDObject(char *parameter, auth_t auth_level) { // ESP215
     parameter = trim(parameter);
     if (*parameter == '\0') {
@@ -1001,6 +1125,14 @@ void make_web_settings()
     #endif
     #ifdef ENABLE_SD_CARD
         new WebCommand("path",    WEBCMD, WU, "ESP220", "SD/Run",       runSDFile);
+        new WebCommand("path",    WEBCMD, WU, NULL,     "SD/Compile",   compileSDFile);
+        new WebCommand("line path",
+                                  WEBCMD, WU, NULL,     "SD/Resume",    resumeSDFile);
+        new WebCommand("RUN|CLEAR",
+                                  WEBCMD, WU, NULL,     "SD/Recover",   recoverSDJob);
+    #ifdef USE_GCODE_FAST_PATH
+        new WebCommand("path",    WEBCMD, WU, NULL,     "SD/FastPathCheck", checkSDFastPath);
+    #endif
         new WebCommand("file_or_directory_path",
                                   WEBCMD, WU, "ESP215", "SD/Delete",    deleteSDObject);
         new WebCommand(NULL,      WEBCMD, WU, "ESP210", "SD/List",      listSDFiles);
@@ -0,0 +1,155 @@
+/*
+  binary_frame.cpp - Frame decoder of the binary motion stream
+  Part of Grbl_ESP32
+
+  Grbl is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  Grbl is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with Grbl.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "binary_frame.h"
+#include <math.h>
+#include <string.h>
+
+static uint8_t bin_queue_next(uint8_t index) {
+    if (++index == (BIN_STREAM_WINDOW + 1))
+        return (0);
+    return (index);
+}
+
+uint16_t bin_crc16(const uint8_t* data, uint8_t len) {
+    uint16_t crc = 0xFFFF;
+    while (len--) {
+        crc ^= (uint16_t)(*data++) << 8;
+        for (uint8_t i = 0; i < 8; i++)
+            crc = (crc & 0x8000) ? (crc << 1) ^ 0x1021 : (crc << 1);
+    }
+    return (crc);
+}
+
+void bin_decoder_init(bin_decoder_t* decoder) {
+    decoder->head = 0;
+    decoder->tail = 0;
+    decoder->count = 0;
+    decoder->in_frame = false;
+    decoder->resync = false;
+    decoder->last_byte = 0;
+    decoder->seq = 0;
+    decoder->nak_sent = false;
+    decoder->nak_seq = 0;
+}
+
+static uint8_t bin_decoder_nak(bin_decoder_t* decoder, uint8_t seq) {
+    if (decoder->nak_sent)
+        return (BIN_RX_BUSY);
+    decoder->nak_sent = true;
+    decoder->nak_seq = seq;
+    return (BIN_RX_NAK);
+}
+
+// The frame boundaries can no longer be trusted, e.g. after a dropped or corrupted byte. Bytes
+// that look like a sync or a realtime command may be payload, so nothing is read until the host
+// pauses. Asks for the expected frame again.
+static uint8_t bin_decoder_lost(bin_decoder_t* decoder) {
+    decoder->in_frame = false;
+    decoder->resync = true;
+    return (bin_decoder_nak(decoder, decoder->seq));
+}
+
+// Checks a complete frame and queues it.
+static uint8_t bin_decoder_accept(bin_decoder_t* decoder) {
+    uint8_t type = decoder->frame[0];
+    uint8_t seq = decoder->frame[1];
+    uint8_t len = decoder->frame[2];
+    uint16_t crc = decoder->frame[BIN_FRAME_HEADER + len] | (decoder->frame[BIN_FRAME_HEADER + len + 1] << 8);
+    if (crc != bin_crc16(decoder->frame, BIN_FRAME_HEADER + len))
+        return (bin_decoder_lost(decoder));
+    // The frame is intact, so the next byte is a frame boundary again.
+    if (seq != decoder->seq)
+        return (bin_decoder_nak(decoder, decoder->seq)); // Lost a frame. Wait for the host to go back to it.
+    if (!((type == BIN_FRAME_MOVE && len == BIN_MOVE_SIZE) || (type == BIN_FRAME_END && len == 0)))
+        return (bin_decoder_nak(decoder, seq));
+    uint8_t next_head = bin_queue_next(decoder->head);
+    if (next_head == decoder->tail)
+        return (bin_decoder_nak(decoder, seq)); // Sent beyond the window
+    bin_frame_t* frame = &decoder->queue[decoder->head];
+    frame->type = type;
+    frame->seq = seq;
+    memcpy(frame->payload, &decoder->frame[BIN_FRAME_HEADER], len);
+    decoder->head = next_head;
+    decoder->seq++;
+    decoder->nak_sent = false;
+    return ((type == BIN_FRAME_END) ? BIN_RX_END : BIN_RX_QUEUED);
+}
+
+uint8_t bin_decoder_receive(bin_decoder_t* decoder, uint8_t data, uint32_t now) {
+    bool quiet = (now - decoder->last_byte) >= BIN_FRAME_TIMEOUT_MS;
+    decoder->last_byte = now;
+    if (quiet) {
+        // The host paused, so it has seen any NAK sent before and may need another.
+        decoder->nak_sent = false;
+        decoder->resync = false;
+        if (decoder->in_frame)
+            return (bin_decoder_lost(decoder)); // The frame stalled. This may be the rest of it.
+    }
+    if (decoder->resync)
+        return (BIN_RX_BUSY);
+    if (!decoder->in_frame) {
+        if (data != BIN_FRAME_SYNC)
+            return (BIN_RX_IDLE);
+        decoder->in_frame = true;
+        decoder->count = 0;
+        return (BIN_RX_BUSY);
+    }
+    decoder->frame[decoder->count++] = data;
+    if (decoder->count < BIN_FRAME_HEADER)
+        return (BIN_RX_BUSY);
+    uint8_t len = decoder->frame[2];
+    if (len > BIN_FRAME_PAYLOAD_MAX)
+        return (bin_decoder_lost(decoder));
+    if (decoder->count < BIN_FRAME_HEADER + len + 2)
+        return (BIN_RX_BUSY);
+    decoder->in_frame = false;
+    return (bin_decoder_accept(decoder));
+}
+
+bin_frame_t* bin_decoder_peek(bin_decoder_t* decoder) {
+    if (decoder->tail == decoder->head)
+        return (NULL);
+    return (&decoder->queue[decoder->tail]);
+}
+
+void bin_decoder_pop(bin_decoder_t* decoder) {
+    if (decoder->tail != decoder->head)
+        decoder->tail = bin_queue_next(decoder->tail);
+}
+
+void bin_move_unpack(const uint8_t* payload, bin_move_t* move) {
+    memcpy(&move->line_id, &payload[0], 4);
+    memcpy(move->target, &payload[4], BIN_MOVE_AXES * sizeof(float));
+    memcpy(&move->feed_rate, &payload[28], 4);
+    memcpy(&move->spindle_speed, &payload[32], 4);
+    move->flags = payload[36];
+}
+
+uint8_t bin_move_check(const bin_move_t* move, uint8_t axes) {
+    for (uint8_t idx = 0; idx < axes; idx++) {
+        if (!isfinite(move->target[idx]))
+            return (BIN_MOVE_NOT_FINITE);
+    }
+    // The feed is checked even for a rapid, which ignores it. A sender that puts NaN there is broken.
+    if (!isfinite(move->feed_rate) || !isfinite(move->spindle_speed))
+        return (BIN_MOVE_NOT_FINITE);
+    if (move->spindle_speed < 0.0)
+        return (BIN_MOVE_NEGATIVE_SPEED);
+    return (BIN_MOVE_OK);
+}
@@ -0,0 +1,117 @@
+/*
+  binary_frame.h - Frame decoder of the binary motion stream
+  Part of Grbl_ESP32
+
+  Grbl is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  Grbl is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with Grbl.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifndef binary_frame_h
+#define binary_frame_h
+
+// The decoder only uses the C library, so it can be built and tested on a PC as well.
+// See tests/host/binary_frame_test.cpp. The frame layout is described in binary_stream.h.
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+
+#define BIN_FRAME_SYNC 0x02
+#define BIN_FRAME_MOVE 'M'
+#define BIN_FRAME_END 'E'
+
+#define BIN_FRAME_HEADER 3  // type, seq, len
+#define BIN_FRAME_PAYLOAD_MAX 64
+
+#define BIN_MOVE_SIZE 40
+#define BIN_MOVE_RAPID (1 << 0)         // G0. Runs at the rapid rate and ignores the feed.
+#define BIN_MOVE_INVERSE_TIME (1 << 1)  // G93 feed rate
+
+// Frames the host may have in flight past the last ACK.
+#ifndef BIN_STREAM_WINDOW
+    #define BIN_STREAM_WINDOW 16
+#endif
+
+// Quiet time that ends a frame. A frame that stalls this long is dropped, and after a framing
+// error every byte is dropped until the line has been quiet this long.
+#ifndef BIN_FRAME_TIMEOUT_MS
+    #define BIN_FRAME_TIMEOUT_MS 50
+#endif
+
+// Results of bin_decoder_receive()
+#define BIN_RX_BUSY 0    // Byte taken by a frame, or dropped while resyncing
+#define BIN_RX_IDLE 1    // Byte between frames that is not a sync. Only realtime commands mean anything.
+#define BIN_RX_QUEUED 2  // A move frame was completed and queued
+#define BIN_RX_END 3     // The END frame was queued. Bytes after it are not part of the stream.
+#define BIN_RX_NAK 4     // A frame was rejected. Send a NAK for nak_seq.
+
+// A checked frame, waiting for the protocol loop. END frames have no payload.
+typedef struct {
+    uint8_t type;
+    uint8_t seq;
+    uint8_t payload[BIN_MOVE_SIZE];
+} bin_frame_t;
+
+typedef struct {
+    // Checked frames. Written by the decoder, read by the consumer. One slot is kept free to tell
+    // full from empty, so a full queue holds exactly one window.
+    bin_frame_t queue[BIN_STREAM_WINDOW + 1];
+    volatile uint8_t head;
+    volatile uint8_t tail;
+    // Receive state
+    uint8_t frame[BIN_FRAME_HEADER + BIN_FRAME_PAYLOAD_MAX + 2];
+    uint8_t count;
+    bool in_frame;
+    bool resync;          // Framing was lost. Dropping bytes until the line goes quiet.
+    uint32_t last_byte;   // Arrival time of the last byte, msec
+    uint8_t seq;          // Next expected sequence number
+    bool nak_sent;        // Only NAK once per gap, the host resends everything after it
+    uint8_t nak_seq;      // Sequence number of the last BIN_RX_NAK
+} bin_decoder_t;
+
+// CRC-16/CCITT-FALSE, as sent in the frames.
+uint16_t bin_crc16(const uint8_t* data, uint8_t len);
+
+// Empties the queue and waits for frame 0.
+void bin_decoder_init(bin_decoder_t* decoder);
+
+// Feeds one received byte. now is a millisecond clock and may wrap.
+uint8_t bin_decoder_receive(bin_decoder_t* decoder, uint8_t data, uint32_t now);
+
+// Oldest queued frame, or NULL when the queue is empty.
+bin_frame_t* bin_decoder_peek(bin_decoder_t* decoder);
+
+// Frees the oldest queued frame once it has been executed.
+void bin_decoder_pop(bin_decoder_t* decoder);
+
+// A move payload, unpacked. The layout is described in binary_stream.h.
+#define BIN_MOVE_AXES 6
+typedef struct {
+    uint8_t flags;
+    uint32_t line_id;
+    float target[BIN_MOVE_AXES];
+    float feed_rate;
+    float spindle_speed;
+} bin_move_t;
+
+void bin_move_unpack(const uint8_t* payload, bin_move_t* move);
+
+// Results of bin_move_check()
+#define BIN_MOVE_OK 0
+#define BIN_MOVE_NOT_FINITE 1       // NaN or infinite target, feed rate or spindle speed
+#define BIN_MOVE_NEGATIVE_SPEED 2
+
+// Checks the numbers of a move for the first axes targets. The payload comes straight off the
+// wire, so this must pass before any of it reaches the spindle or the planner.
+uint8_t bin_move_check(const bin_move_t* move, uint8_t axes);
+
+#endif
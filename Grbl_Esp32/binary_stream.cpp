@@ -0,0 +1,164 @@
+/*
+  binary_stream.cpp - Pre-parsed binary motion stream
+  Part of Grbl_ESP32
+
+  Grbl is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  Grbl is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with Grbl.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "grbl.h"
+
+#define BIN_STREAM_ACK_EVERY 4  // Moves executed before an ACK is sent without waiting for the pass to end
+
+// Frames are decoded by serialCheckTask() and run by the protocol loop. Both, and the reset, hold
+// bin_mutex while they change the decoder.
+static bin_decoder_t bin_decoder;
+static portMUX_TYPE bin_mutex = portMUX_INITIALIZER_UNLOCKED;
+
+static volatile uint8_t bin_client = CLIENT_ALL;     // Streaming client, CLIENT_ALL when none
+static volatile uint8_t bin_rx_client = CLIENT_ALL;  // Same, until its END frame is decoded
+
+// Acknowledgement state. Protocol loop only.
+static uint8_t bin_ack_seq;
+static uint8_t bin_ack_pending;
+
+err_t binary_stream_start(uint8_t client) {
+    if (client >= CLIENT_COUNT || client == CLIENT_INPUT)
+        return (STATUS_INVALID_STATEMENT);
+    if (bin_client != CLIENT_ALL && bin_client != client)
+        return (STATUS_INVALID_STATEMENT); // Another client is streaming
+    vTaskEnterCritical(&bin_mutex);
+    bin_decoder_init(&bin_decoder);
+    bin_client = client;
+    bin_rx_client = client;
+    vTaskExitCritical(&bin_mutex);
+    bin_ack_pending = 0;
+    grbl_sendf(client, "[BIN:START axes=%d window=%d]\r\n", N_AXIS, BIN_STREAM_WINDOW);
+    return (STATUS_OK);
+}
+
+bool binary_stream_receiving(uint8_t client) {
+    return (bin_rx_client == client);
+}
+
+void binary_stream_receive(uint8_t data) {
+    uint32_t now = millis();
+    vTaskEnterCritical(&bin_mutex);
+    uint8_t result = bin_decoder_receive(&bin_decoder, data, now);
+    uint8_t nak_seq = bin_decoder.nak_seq;
+    if (result == BIN_RX_END)
+        bin_rx_client = CLIENT_ALL; // Anything after END is text again
+    vTaskExitCritical(&bin_mutex);
+    switch (result) {
+        case BIN_RX_IDLE:
+            // Between frames only realtime commands mean anything. Line ends and such are dropped.
+            if (is_realtime_command(data))
+                execute_realtime_command(data, bin_rx_client);
+            break;
+        case BIN_RX_NAK:
+            grbl_sendf(bin_client, "[BIN:NAK %d]\r\n", nak_seq);
+            break;
+    }
+}
+
+// Plans one move, like gc_execute_line() does for a G0 or G1 line with no modal changes.
+static err_t binary_stream_move(bin_move_t* move) {
+    if (sys.state & (STATE_ALARM | STATE_JOG))
+        return (STATUS_SYSTEM_GC_LOCK);
+    switch (bin_move_check(move, N_AXIS)) {
+        case BIN_MOVE_NOT_FINITE:
+            return (STATUS_BAD_NUMBER_FORMAT);
+        case BIN_MOVE_NEGATIVE_SPEED:
+            return (STATUS_NEGATIVE_VALUE);
+    }
+    bool rapid = move->flags & BIN_MOVE_RAPID;
+    if (!rapid && move->feed_rate <= 0.0)
+        return (STATUS_GCODE_UNDEFINED_FEED_RATE);
+    plan_line_data_t plan_data;
+    plan_line_data_t* pl_data = &plan_data;
+    memset(pl_data, 0, sizeof(plan_line_data_t));
+    pl_data->condition = gc_state.modal.spindle | gc_state.modal.coolant;
+    if (rapid)
+        pl_data->condition |= PL_COND_FLAG_RAPID_MOTION;
+    else {
+        pl_data->feed_rate = move->feed_rate;
+        if (move->flags & BIN_MOVE_INVERSE_TIME)
+            pl_data->condition |= PL_COND_FLAG_INVERSE_TIME;
+    }
+    pl_data->path_tolerance = gc_state.path_tolerance;
+#ifdef USE_LINE_NUMBERS
+    pl_data->line_number = move->line_id;
+#endif
+    float rpm = move->spindle_speed;
+    if (gc_state.spindle_speed != rpm) {
+        // In laser mode the speed goes with the motion. Otherwise sync it, like an S word would.
+        if (gc_state.modal.spindle != SPINDLE_DISABLE && !laser_mode->get())
+            spindle->spindle_sync(gc_state.modal.spindle, (uint32_t)rpm);
+        gc_state.spindle_speed = rpm;
+    }
+    // Laser mode rapids run with the laser off, as in gc_execute_line().
+    if (!(rapid && laser_mode->get()))
+        pl_data->spindle_speed = gc_state.spindle_speed;
+    mc_line_kins(move->target, pl_data, gc_state.position);
+    memcpy(gc_state.position, move->target, sizeof(gc_state.position));
+    return (STATUS_OK);
+}
+
+static void binary_stream_send_ack() {
+    if (bin_ack_pending) {
+        grbl_sendf(bin_client, "[BIN:ACK %d]\r\n", bin_ack_seq);
+        bin_ack_pending = 0;
+    }
+}
+
+void binary_stream_execute() {
+    if (bin_client == CLIENT_ALL)
+        return;
+    bin_frame_t* frame;
+    while ((frame = bin_decoder_peek(&bin_decoder)) != NULL) {
+        if (frame->type == BIN_FRAME_END) {
+            binary_stream_send_ack();
+            grbl_send(bin_client, "[BIN:END]\r\n");
+            bin_client = CLIENT_ALL;
+            vTaskEnterCritical(&bin_mutex);
+            bin_decoder_pop(&bin_decoder);
+            vTaskExitCritical(&bin_mutex);
+            return;
+        }
+        bin_move_t move;
+        bin_move_unpack(frame->payload, &move);
+        err_t status = binary_stream_move(&move);
+        if (sys.abort)
+            return; // The reset clears the stream
+        if (status != STATUS_OK)
+            grbl_sendf(bin_client, "[BIN:ERR %d %d]\r\n", frame->seq, status);
+        bin_ack_seq = frame->seq;
+        vTaskEnterCritical(&bin_mutex);
+        bin_decoder_pop(&bin_decoder);
+        vTaskExitCritical(&bin_mutex);
+        if (++bin_ack_pending >= BIN_STREAM_ACK_EVERY)
+            binary_stream_send_ack();
+    }
+    binary_stream_send_ack();
+}
+
+void binary_stream_reset(uint8_t client) {
+    if (client != CLIENT_ALL && client != bin_client)
+        return;
+    vTaskEnterCritical(&bin_mutex);
+    bin_client = CLIENT_ALL;
+    bin_rx_client = CLIENT_ALL;
+    bin_decoder_init(&bin_decoder);
+    vTaskExitCritical(&bin_mutex);
+    bin_ack_pending = 0;
+}
@@ -0,0 +1,87 @@
+/*
+  binary_stream.h - Pre-parsed binary motion stream
+  Part of Grbl_ESP32
+
+  Grbl is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  Grbl is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with Grbl.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifndef binary_stream_h
+#define binary_stream_h
+
+#include "grbl.h"
+#include "binary_frame.h"
+
+/*
+  A host that has already reduced a job to straight lines in machine coordinates can send them
+  as fixed size binary records instead of g-code text. The records skip the g-code parser and go
+  straight to mc_line(), and they are acknowledged in windows instead of with one "ok" per line.
+
+  $Stream/Binary (or $BIN) switches the client it is sent from to binary mode. Wait for its
+  "[BIN:START ...]" and "ok" before sending frames. Only one client can stream at a time. Serial,
+  telnet and the websocket are supported, since they all pass through serialCheckTask().
+
+  Frame:
+    0x02        sync
+    type        BIN_FRAME_MOVE or BIN_FRAME_END
+    seq         Frame sequence number. Starts at 0 and increments by one per frame, wrapping at 255.
+    len         Payload length
+    payload     len bytes
+    crc         CRC-16/CCITT-FALSE (poly 0x1021, init 0xFFFF) of type, seq, len and payload,
+                low byte first
+
+  Move payload, little endian, BIN_MOVE_SIZE bytes:
+    uint32      line id. Reported as the line number with USE_LINE_NUMBERS.
+    float[6]    target in machine coordinates, mm. Axes past N_AXIS are ignored.
+    float       feed rate in mm/min, or 1/min with BIN_MOVE_INVERSE_TIME
+    float       spindle speed, zero or more
+    uint8       flags, BIN_MOVE_*
+    uint8[3]    reserved, send as zero
+
+  Spindle direction, coolant, G64 tolerance and laser mode come from the g-code state when the
+  stream starts, so set them up with g-code first. Realtime commands can be sent between frames.
+
+  Payload bytes are not checked for realtime commands, so the decoder has to know where frames
+  start and end. When it can no longer tell, after a bad CRC or length or a frame that stalls for
+  BIN_FRAME_TIMEOUT_MS, it sends a NAK and drops every byte, realtime commands included, until the
+  line has been quiet for BIN_FRAME_TIMEOUT_MS. So after a NAK, stop sending for at least that
+  long before resending. The same pause also recovers a stream that gets neither ACK nor NAK.
+
+  Replies are text lines, so they mix safely with status reports:
+    [BIN:START axes=<N_AXIS> window=<frames>]
+    [BIN:ACK <seq>]         Frames up to and including seq have been executed. The host may have
+                            up to window frames after seq in flight.
+    [BIN:NAK <seq>]         Frame seq was not accepted: bad CRC or length, out of order, unknown
+                            type, stalled, or sent beyond the window. Frames after it are dropped,
+                            so pause and resend from seq.
+    [BIN:ERR <seq> <code>]  Move seq was rejected with the given status code, e.g. in alarm,
+                            or 2 for a NaN or infinite number and 4 for a negative speed.
+    [BIN:END]               The END frame was reached and the client is back in text mode.
+*/
+
+// Switches a client to binary mode. Called by $Stream/Binary.
+err_t binary_stream_start(uint8_t client);
+
+// True when bytes from this client must go to binary_stream_receive().
+bool binary_stream_receiving(uint8_t client);
+
+// Frame decoder. Called by serialCheckTask() for every byte from the streaming client.
+void binary_stream_receive(uint8_t data);
+
+// Runs decoded moves and sends the acknowledgements. Called by the protocol loop.
+void binary_stream_execute();
+
+// Leaves binary mode and drops any decoded moves. Called when the client's buffer is reset.
+void binary_stream_reset(uint8_t client);
+
+#endif
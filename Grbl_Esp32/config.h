@@ -349,6 +349,12 @@ Some features should not be changed. See notes below.
 // Enables code for debugging purposes. Not for general use and always in constant flux.
 // #define DEBUG // Uncomment to enable. Default disabled.
 
+// Records how long each step interrupt (or I2S step callback) takes, how late the step timer
+// interrupt starts and a histogram of the durations. Read with $Stepper/Timing, clear with
+// $Stepper/Timing=RST. Use it to check the headroom before raising step rates. It adds a little
+// work to every step, so leave it off on production builds.
+// #define STEPPER_ISR_TIMING // Uncomment to enable. Default disabled.
+
 // Configure rapid, feed, and spindle override settings. These values define the max and min
 // allowable override values and the coarse and fine increments per command received. Please
 // note the allowable values in the descriptions following each define.
@@ -406,8 +412,8 @@ Some features should not be changed. See notes below.
 // impact performance. The correct value for this parameter is machine dependent, so it's advised to
 // set this only as high as needed. Approximate successful values can widely range from 50 to 200 or more.
 // NOTE: Changing this value also changes the execution time of a segment in the step segment buffer.
-// When increasing this value, this stores less overall time in the segment buffer and vice versa. Make
-// certain the step segment buffer is increased/decreased to account for these changes.
+// The buffer is filled to $Stepper/BufferTime of motion, so increasing this value needs more segments
+// for the same time. Make certain SEGMENT_BUFFER_SIZE in stepper.h still holds that time.
 #define ACCELERATION_TICKS_PER_SECOND 100
 
 // Adaptive Multi-Axis Step Smoothing (AMASS) is an advanced feature that does what its name implies,
@@ -468,6 +474,13 @@ Some features should not be changed. See notes below.
 // received, including not only GCode lines, but also $ and [ESP commands.
 //#define REPORT_ECHO_RAW_LINE_RECEIVED // Default disabled. Uncomment to enable.
 
+// Lines that hold only axis words and F, S or N while G0 or G1 is active, which is most of a CAM
+// job, skip the general g-code parser and go straight to motion control. Any other line, and any
+// line the general parser would reject, still takes the full path. Comment out to parse every
+// line with the full parser, e.g. to rule the fast path out when chasing a parser problem.
+// $SD/FastPathCheck=<file> parses a file both ways in check mode and reports any difference.
+#define USE_GCODE_FAST_PATH // Default enabled. Comment to disable.
+
 // Minimum planner junction speed. Sets the default minimum junction speed the planner plans to at
 // every buffer block junction, except for starting from rest and end of the buffer, which are always
 // zero. This value controls how fast the machine moves through junctions with no regard for acceleration
@@ -488,6 +501,12 @@ Some features should not be changed. See notes below.
 // bogged down by too many trig calculations.
 #define N_ARC_CORRECTION 12 // Integer (1-255)
 
+// Bounds on the chords that $GCode/ArcChordTime may save on fast arcs. Such an arc still gets at
+// least ARC_MIN_CHORDS_PER_TURN chords per full turn, and no chord strays more than
+// ARC_CHORD_TIME_MAX_ERROR times arc_tolerance ($12) from the arc, so small circles keep their shape.
+#define ARC_MIN_CHORDS_PER_TURN 8 // Integer
+#define ARC_CHORD_TIME_MAX_ERROR 4.0 // Float, multiple of arc_tolerance
+
 // The arc G2/3 g-code standard is problematic by definition. Radius-based arcs have horrible numerical
 // errors when arc at semi-circles(pi) or full-circles(2*pi). Offset-based arcs are much more accurate
 // but still have a problem when arcs are full-circles (2*pi). This define accounts for the floating
@@ -526,11 +545,30 @@ Some features should not be changed. See notes below.
 // must use #define USE_RMT_STEPS for this to work
 //#define STEP_PULSE_DELAY 10 // Step pulse delay in microseconds. Default disabled.
 
+// With USE_I2S_OUT_STREAM, the I2S task normally calls the stepper pulse function once per step
+// period and pads the DMA buffer one sample at a time in between. This option renders a whole DMA
+// buffer of step periods in one call instead, writing the step bits straight into the samples.
+// It frees enough CPU for much higher step rates on 6 axis I2S boards. All step pins must be on
+// the I2S expander (I2SO(n)). If one is not, the pulse callback is used as before.
+// NOTE: Uncomment to enable. Ignored unless USE_I2S_OUT_STREAM is defined.
+//#define USE_I2S_OUT_SEGMENT_RENDER
+#ifndef USE_I2S_OUT_STREAM
+    #undef USE_I2S_OUT_SEGMENT_RENDER
+#endif
+
+// Refills the step segment buffer from a dedicated high priority task that the stepper wakes each
+// time it finishes a segment. Otherwise the buffer is only refilled when the protocol loop gets to
+// it, and a long status report, SD card read or WiFi burst can starve the steppers at high feeds.
+// NOTE: Comment out to refill only from the protocol loop, as Grbl on the AVR does.
+#define USE_SEGMENT_PREP_TASK
+
 // The number of linear motions in the planner buffer to be planned at any give time. The vast
 // majority of RAM that Grbl uses is based on this buffer size. Only increase if there is extra
 // available RAM, like when re-compiling for a Mega2560. Or decrease if the Arduino begins to
 // crash due to the lack of available RAM or if the CPU is having trouble keeping up with planning
 // new incoming motions as they are executed.
+// NOTE: On the ESP32 this is only the default for $Planner/Blocks, which sets the buffer size
+// at boot. Dense CAM output with very short segments benefits from a few hundred blocks.
 // #define BLOCK_BUFFER_SIZE 16 // Uncomment to override default in planner.h.
 
 // Governs the size of the intermediary step segment buffer between the step execution algorithm
@@ -561,7 +599,8 @@ Some features should not be changed. See notes below.
 // 115200 baud will take 5 msec to transmit a typical 55 character report. Worst case reports are
 // around 90-100 characters. As long as the serial TX buffer doesn't get continually maxed, Grbl
 // will continue operating efficiently. Size the TX buffer around the size of a worst-case report.
-// #define RX_BUFFER_SIZE 128 // (1-254) Uncomment to override defaults in serial.h
+// #define RX_BUFFER_SIZE 256 // (2-65535) Uncomment to override defaults in serial.h. Per client
+// sizes, such as SERIAL_RX_BUFFER_SIZE, can be overridden the same way.
 // #define TX_BUFFER_SIZE 100 // (1-254)
 
 // A simple software debouncing feature for hard limit switches. When enabled, the limit
@@ -155,6 +155,26 @@
         #define DEFAULT_SPINDLE_DELAY_SPINDOWN 0
     #endif
 
+    #ifndef DEFAULT_MOTION_PROFILE
+        #define DEFAULT_MOTION_PROFILE MOTION_PROFILE_TRAPEZOID // Stepper/Profile
+    #endif
+
+    #ifndef DEFAULT_PLANNER_BLOCKS
+        #define DEFAULT_PLANNER_BLOCKS BLOCK_BUFFER_SIZE // Planner/Blocks (applied at boot)
+    #endif
+
+    #ifndef DEFAULT_SEGMENT_BUFFER_TIME
+        #define DEFAULT_SEGMENT_BUFFER_TIME 100 // Stepper/BufferTime msec of queued segments
+    #endif
+
+    #ifndef DEFAULT_ARC_CHORD_TIME
+        #define DEFAULT_ARC_CHORD_TIME 1.0 // GCode/ArcChordTime shortest arc chord in msec at feed, 0 = off
+    #endif
+
+    #ifndef DEFAULT_SD_CHECKPOINT_TIME
+        #define DEFAULT_SD_CHECKPOINT_TIME 10 // SD/CheckpointTime sec between power loss checkpoints, 0 = off
+    #endif
+
     // ================  user settings =====================
     #ifndef DEFAULT_USER_INT_80
         #define DEFAULT_USER_INT_80 0 // $80 User integer setting
@@ -261,6 +281,29 @@
         #define DEFAULT_C_ACCELERATION 200.0
     #endif
 
+    // ============== Axis Jerk =========
+    // Only used when $Stepper/Profile is SCURVE
+    #define SEC_PER_MIN_CU  (60.0*60.0*60.0)  // Seconds Per Minute Cubed, for jerk conversion
+    // Default jerks are expressed in mm/sec^3
+    #ifndef  DEFAULT_X_JERK
+        #define DEFAULT_X_JERK 10000.0
+    #endif
+    #ifndef  DEFAULT_Y_JERK
+        #define DEFAULT_Y_JERK 10000.0
+    #endif
+    #ifndef  DEFAULT_Z_JERK
+        #define DEFAULT_Z_JERK 10000.0
+    #endif
+    #ifndef  DEFAULT_A_JERK
+        #define DEFAULT_A_JERK 10000.0
+    #endif
+    #ifndef  DEFAULT_B_JERK
+        #define DEFAULT_B_JERK 10000.0
+    #endif
+    #ifndef  DEFAULT_C_JERK
+        #define DEFAULT_C_JERK 10000.0
+    #endif
+
     // ========= AXIS MAX TRAVEL ============
 
     #ifndef  DEFAULT_X_MAX_TRAVEL
@@ -116,6 +116,206 @@ void collapseGCode(char *line) {
     *outPtr = '\0';
 }
 
+#ifdef USE_GCODE_FAST_PATH
+// A move caught by gc_fast_path_compare() instead of being planned
+static struct {
+    bool active;
+    uint8_t moves;
+    float target[N_AXIS];
+    plan_line_data_t pl_data;
+} gc_capture;
+#endif
+
+// Plans a G0 or G1 move of either parser path.
+static void gc_line_kins(float* target, plan_line_data_t* pl_data) {
+#ifdef USE_GCODE_FAST_PATH
+    if (gc_capture.active) {
+        if (gc_capture.moves++ == 0) {
+            memcpy(gc_capture.target, target, sizeof(gc_capture.target));
+            memcpy(&gc_capture.pl_data, pl_data, sizeof(plan_line_data_t));
+        }
+        return;
+    }
+#endif
+    mc_line_kins(target, pl_data, gc_state.position);
+}
+
+#ifdef USE_GCODE_FAST_PATH
+// Executes a collapsed line that holds only axis words and F, S and N, while G0 or G1 in G94 is
+// the active motion mode. This is what nearly every line of a CAM job looks like, and for it most
+// of gc_execute_line() is bookkeeping for words that are not there. The line is parsed into locals
+// first and anything unexpected, including every line the full path would reject, returns false
+// before any state is touched, so the full path runs and reports the error as before. The target,
+// feed, spindle and laser handling below is STEP 3 and STEP 4 reduced to that one case, in the same
+// order and with the same float operations, so both paths plan identical blocks.
+static bool gc_execute_fast_line(const char* line) {
+    if ((gc_state.modal.motion != MOTION_MODE_SEEK) && (gc_state.modal.motion != MOTION_MODE_LINEAR))
+        return false;
+    if ((gc_state.modal.feed_rate != FEED_RATE_MODE_UNITS_PER_MIN) || gc_state.modal.tool_change ||
+            gc_state.modal.io_control || gc_state.modal.program_flow)
+        return false;
+    float xyz[N_AXIS];
+    float feed_rate = gc_state.feed_rate;
+    float spindle_speed = gc_state.spindle_speed;
+    int32_t line_number = 0;
+    uint8_t axis_words = 0;
+    uint16_t value_words = 0;
+    uint8_t char_counter = 0;
+    uint8_t idx;
+    float value;
+    while (line[char_counter] != 0) {
+        char letter = line[char_counter++];
+        if (!read_float(line, &char_counter, &value))
+            return false;
+        switch (letter) {
+        case 'X':
+            idx = X_AXIS;
+            break;
+        case 'Y':
+            idx = Y_AXIS;
+            break;
+        case 'Z':
+            idx = Z_AXIS;
+            break;
+#if (N_AXIS > A_AXIS)
+        case 'A':
+            idx = A_AXIS;
+            break;
+#endif
+#if (N_AXIS > B_AXIS)
+        case 'B':
+            idx = B_AXIS;
+            break;
+#endif
+#if (N_AXIS > C_AXIS)
+        case 'C':
+            idx = C_AXIS;
+            break;
+#endif
+        case 'F':
+            if (bit_istrue(value_words, bit(WORD_F)) || (value < 0.0))
+                return false;
+            value_words |= bit(WORD_F);
+            feed_rate = value;
+            continue;
+        case 'S':
+            if (bit_istrue(value_words, bit(WORD_S)) || (value < 0.0))
+                return false;
+            value_words |= bit(WORD_S);
+            spindle_speed = value;
+            continue;
+        case 'N':
+            if (bit_istrue(value_words, bit(WORD_N)) || (value < 0.0))
+                return false;
+            value_words |= bit(WORD_N);
+            line_number = trunc(value);
+            if (line_number > MAX_LINE_NUMBER)
+                return false;
+            continue;
+        default:
+            return false; // Any other word needs the full parser.
+        }
+        if (bit_istrue(axis_words, bit(idx)))
+            return false;
+        axis_words |= bit(idx);
+        xyz[idx] = value;
+    }
+    // G0/G1 without axis words only update modal values, which the full path already handles.
+    if (!axis_words)
+        return false;
+    if (bit_istrue(value_words, bit(WORD_F)) && (gc_state.modal.units == UNITS_MODE_INCHES))
+        feed_rate *= MM_PER_INCH;
+    if ((gc_state.modal.motion == MOTION_MODE_LINEAR) && (feed_rate == 0.0))
+        return false; // [Feed rate undefined]
+    for (idx = 0; idx < N_AXIS; idx++) {
+        if (bit_isfalse(axis_words, bit(idx)))
+            xyz[idx] = gc_state.position[idx];
+        else {
+            if (gc_state.modal.units == UNITS_MODE_INCHES)
+                xyz[idx] *= MM_PER_INCH;
+            if (gc_state.modal.distance == DISTANCE_MODE_ABSOLUTE) {
+                xyz[idx] += gc_state.coord_system[idx] + gc_state.coord_offset[idx];
+                if (idx == TOOL_LENGTH_OFFSET_AXIS)
+                    xyz[idx] += gc_state.tool_length_offset;
+            } else
+                xyz[idx] += gc_state.position[idx];
+        }
+    }
+    // The line is valid. Everything from here on matches STEP 4 for a G0/G1 block with axis words.
+    plan_line_data_t plan_data;
+    plan_line_data_t* pl_data = &plan_data;
+    memset(pl_data, 0, sizeof(plan_line_data_t));
+    // In laser mode the move always carries its own power, so no spindle sync is needed, and G0
+    // moves run with the laser off.
+    bool laser_disable = laser_mode->get() && (gc_state.modal.motion == MOTION_MODE_SEEK);
+    gc_state.line_number = line_number;
+#ifdef USE_LINE_NUMBERS
+    pl_data->line_number = gc_state.line_number;
+#endif
+    gc_state.feed_rate = feed_rate;
+    pl_data->feed_rate = gc_state.feed_rate;
+    if (gc_state.spindle_speed != spindle_speed) {
+        if ((gc_state.modal.spindle != SPINDLE_DISABLE) && !laser_mode->get())
+            spindle->spindle_sync(gc_state.modal.spindle, (uint32_t)spindle_speed);
+        gc_state.spindle_speed = spindle_speed;
+    }
+    if (!laser_disable)
+        pl_data->spindle_speed = gc_state.spindle_speed;
+    pl_data->condition |= gc_state.modal.spindle;
+    pl_data->condition |= gc_state.modal.coolant;
+    pl_data->path_tolerance = gc_state.path_tolerance;
+    if (gc_state.modal.motion == MOTION_MODE_SEEK)
+        pl_data->condition |= PL_COND_FLAG_RAPID_MOTION;
+    gc_line_kins(xyz, pl_data);
+    memcpy(gc_state.position, xyz, sizeof(xyz));
+    return true;
+}
+#endif
+
+static uint8_t gc_execute_block(char* line, uint8_t client, bool fast_path);
+
+#ifdef USE_GCODE_FAST_PATH
+// Runs a line through gc_execute_fast_line() and then through the full parser, both from the same
+// g-code state, and checks that they plan the same move and leave the same state behind. Only the
+// full parser's run is kept. Lines the fast path does not take only run through the full parser.
+// The line is executed twice, so this is for check mode only. Used by $SD/FastPathCheck and by
+// grbl_sim -c in the host tests.
+uint8_t gc_fast_path_compare(char* line, uint8_t client, uint8_t* result) {
+    *result = GC_FAST_PATH_NOT_TAKEN;
+    collapseGCode(line);
+    if (line[0] == '$')
+        return (gc_execute_block(line, client, false));
+    parser_state_t start, fast_state;
+    float fast_target[N_AXIS];
+    plan_line_data_t fast_pl_data;
+    memcpy(&start, &gc_state, sizeof(gc_state));
+    gc_capture.active = true;
+    gc_capture.moves = 0;
+    bool fast = gc_execute_fast_line(line);
+    if (fast) {
+        memcpy(fast_target, gc_capture.target, sizeof(fast_target));
+        memcpy(&fast_pl_data, &gc_capture.pl_data, sizeof(fast_pl_data));
+        memcpy(&fast_state, &gc_state, sizeof(gc_state));
+        memcpy(&gc_state, &start, sizeof(gc_state));
+        gc_capture.moves = 0;
+    } else
+        gc_capture.active = false;
+    uint8_t status = gc_execute_block(line, client, false);
+    gc_capture.active = false;
+    if (!fast)
+        return (status);
+    // Both paths clear pl_data before filling it in, so the structs compare byte for byte.
+    if ((status != STATUS_OK) || (gc_capture.moves != 1) ||
+            memcmp(fast_target, gc_capture.target, sizeof(fast_target)) ||
+            memcmp(&fast_pl_data, &gc_capture.pl_data, sizeof(fast_pl_data)) ||
+            memcmp(&fast_state, &gc_state, sizeof(gc_state)))
+        *result = GC_FAST_PATH_DIFFERS;
+    else
+        *result = GC_FAST_PATH_SAME;
+    return (status);
+}
+#endif
+
 // Executes one line of NUL-terminated G-Code.
 // The line may contain whitespace and comments, which are first removed,
 // and lower case characters, which are converted to upper case.
@@ -123,11 +323,27 @@ void collapseGCode(char *line) {
 // exported to grbl's internal functions in terms of (mm, mm/min) and absolute machine
 // coordinates, respectively.
 uint8_t gc_execute_line(char* line, uint8_t client) {
+    uint32_t profile_start = motion_profile_start();
+    uint8_t status = gc_execute_block(line, client, true);
+    motion_profile_stop(PROFILE_PARSE, profile_start);
+    return (status);
+}
+
+static uint8_t gc_execute_block(char* line, uint8_t client, bool fast_path) {
     // Step 0 - remove whitespace and comments and convert to upper case
+    uint32_t profile_start = motion_profile_start();
     collapseGCode(line);
+    motion_profile_stop(PROFILE_COLLAPSE, profile_start);
+    motion_stats.lines_parsed++;
+    if (motion_profiler.enabled)
+        motion_profile_count_line();
 #ifdef REPORT_ECHO_LINE_RECEIVED
     report_echo_line_received(line, client);
 #endif
+#ifdef USE_GCODE_FAST_PATH
+    if (fast_path && line[0] != '$' && gc_execute_fast_line(line))
+        return (STATUS_OK);
+#endif
 
     /* -------------------------------------------------------------------------------------
        STEP 1: Initialize parser block struct and copy current g-code state modes. The parser
@@ -145,7 +361,7 @@ uint8_t gc_execute_line(char* line, uint8_t client) {
     uint8_t ijk_words = 0; // IJK tracking
     // Initialize command and value words and parser flags variables.
     uint16_t command_words = 0; // Tracks G and M command words. Also used for modal group violations.
-    uint16_t value_words = 0; // Tracks value words.
+    uint32_t value_words = 0; // Tracks value words.
     uint8_t gc_parser_flags = GC_PARSER_NONE;
     // Determine if the line is a jogging motion or a normal g-code block.
     if (line[0] == '$') { // NOTE: `$J=` already parsed when passed to this function.
@@ -228,6 +444,7 @@ uint8_t gc_execute_line(char* line, uint8_t client) {
             case 1:
             case 2:
             case 3:
+            case 5:
             case 38:
 #ifndef PROBE_PIN //only allow G38 "Probe" commands if a probe pin is defined.
                 if (int_value == 38) {
@@ -245,6 +462,10 @@ uint8_t gc_execute_line(char* line, uint8_t client) {
             case 80:
                 word_bit = MODAL_GROUP_G1;
                 gc_block.modal.motion = int_value;
+                if ((int_value == 5) && (mantissa == 10)) {
+                    gc_block.modal.motion = MOTION_MODE_QUADRATIC_SPLINE;
+                    mantissa = 0; // Set to zero to indicate valid non-integer G command.
+                }
                 if (int_value == 38) {
                     if (!((mantissa == 20) || (mantissa == 30) || (mantissa == 40) || (mantissa == 50))) {
                         FAIL(STATUS_GCODE_UNSUPPORTED_COMMAND); // [Unsupported G38.x command]
@@ -323,7 +544,11 @@ uint8_t gc_execute_line(char* line, uint8_t client) {
                 if (mantissa != 0) {
                     FAIL(STATUS_GCODE_UNSUPPORTED_COMMAND);    // [G61.1 not supported]
                 }
-                // gc_block.modal.control = CONTROL_MODE_EXACT_PATH; // G61
+                gc_block.modal.control = CONTROL_MODE_EXACT_PATH; // G61
+                break;
+            case 64:
+                word_bit = MODAL_GROUP_G13;
+                gc_block.modal.control = CONTROL_MODE_CONTINUOUS; // G64
                 break;
             default:
                 FAIL(STATUS_GCODE_UNSUPPORTED_COMMAND); // [Unsupported G command]
@@ -495,7 +720,10 @@ uint8_t gc_execute_line(char* line, uint8_t client) {
                 gc_block.values.p = value;
                 break;
             // NOTE: For certain commands, P value must be an integer, but none of these commands are supported.
-            // case 'Q': // Not supported
+            case 'Q':
+                word_bit = WORD_Q;
+                gc_block.values.q = value;
+                break;
             case 'R':
                 word_bit = WORD_R;
                 gc_block.values.r = value;
@@ -533,9 +761,10 @@ uint8_t gc_execute_line(char* line, uint8_t client) {
             if (bit_istrue(value_words, bit(word_bit))) {
                 FAIL(STATUS_GCODE_WORD_REPEATED);    // [Word repeated]
             }
-            // Check for invalid negative values for words F, N, P, T, and S.
-            // NOTE: Negative value check is done here simply for code-efficiency.
-            if (bit(word_bit) & (bit(WORD_F) | bit(WORD_N) | bit(WORD_P) | bit(WORD_T) | bit(WORD_S))) {
+            // Check for invalid negative values for words F, N, T, and S.
+            // NOTE: Negative value check is done here simply for code-efficiency. P is checked in STEP 3,
+            // since a G5 control point offset may be negative.
+            if (bit(word_bit) & (bit(WORD_F) | bit(WORD_N) | bit(WORD_T) | bit(WORD_S))) {
                 if (value < 0.0) {
                     FAIL(STATUS_NEGATIVE_VALUE);    // [Word value cannot be negative]
                 }
@@ -583,6 +812,12 @@ uint8_t gc_execute_line(char* line, uint8_t client) {
             FAIL(STATUS_GCODE_INVALID_LINE_NUMBER);    // [Exceeds max line number]
         }
     }
+    // Check for a negative P value. Only a G5 uses P as an offset, which may be negative. Any other
+    // command in the same block that uses P takes the word first, leaving the G5 without one.
+    if (bit_istrue(value_words, bit(WORD_P)) && (gc_block.values.p < 0.0)) {
+        if (!((gc_block.modal.motion == MOTION_MODE_CUBIC_SPLINE) && (axis_command == AXIS_COMMAND_MOTION_MODE)))
+            FAIL(STATUS_NEGATIVE_VALUE);    // [Word value cannot be negative]
+    }
     // bit_false(value_words,bit(WORD_N)); // NOTE: Single-meaning value word. Set at end of error-checking.
     // Track for unused words at the end of error-checking.
     // NOTE: Single-meaning value words are removed all at once at the end of error-checking, because
@@ -721,7 +956,23 @@ uint8_t gc_execute_line(char* line, uint8_t client) {
                 FAIL(STATUS_SETTING_READ_FAIL);
         }
     }
-    // [16. Set path control mode ]: N/A. Only G61. G61.1 and G64 NOT SUPPORTED.
+    // [16. Set path control mode ]: G61.1 NOT SUPPORTED. G64 P tolerance must be in length units.
+    // NOTE: P is how far nearly collinear lines may be merged off their points. It does not round
+    // corners. G64 without a P word merges within the junction deviation. A P word already taken by a
+    // dwell or user I/O command in the same block is left to that command. G10 also owns its P word.
+    float block_path_tolerance = gc_state.path_tolerance;
+    if (bit_istrue(command_words, bit(MODAL_GROUP_G13))) {
+        if (gc_block.modal.control == CONTROL_MODE_CONTINUOUS) {
+            block_path_tolerance = junction_deviation->get();
+            if (bit_istrue(value_words, bit(WORD_P)) && (gc_block.non_modal_command != NON_MODAL_SET_COORDINATE_DATA)) {
+                block_path_tolerance = gc_block.values.p;
+                if (gc_block.modal.units == UNITS_MODE_INCHES)
+                    block_path_tolerance *= MM_PER_INCH;
+                bit_false(value_words, bit(WORD_P));
+            }
+        } else
+            block_path_tolerance = 0.0;
+    }
     // [17. Set distance mode ]: N/A. Only G91.1. G90.1 NOT SUPPORTED.
     // [18. Set retract mode ]: NOT SUPPORTED.
     // [19. Remaining non-modal actions ]: Check go to predefined position, set G10, or set axis offsets.
@@ -1036,6 +1287,42 @@ uint8_t gc_execute_line(char* line, uint8_t client) {
                     }
                 }
                 break;
+            case MOTION_MODE_CUBIC_SPLINE:
+            case MOTION_MODE_QUADRATIC_SPLINE:
+                // [G5/G5.1 Errors]: Feed rate undefined. Plane is not XY. No axis words. No I,J for a G5.1, or
+                //   for a G5 that does not follow a G5. P or Q missing for a G5.
+                // NOTE: I,J and P,Q are always incremental, from the start point to the first control point
+                //   and from the target to the second control point. A G5 without I,J mirrors the second
+                //   control point of the previous G5, which makes the joint smooth.
+                if (gc_block.modal.plane_select != PLANE_SELECT_XY) {
+                    FAIL(STATUS_GCODE_SPLINE_PLANE);    // [Plane not G17]
+                }
+                if (!axis_words) {
+                    FAIL(STATUS_GCODE_NO_AXIS_WORDS);    // [No axis words]
+                }
+                if (!(value_words & (bit(WORD_I) | bit(WORD_J)))) {
+                    if ((gc_block.modal.motion == MOTION_MODE_QUADRATIC_SPLINE) ||
+                            (gc_state.modal.motion != MOTION_MODE_CUBIC_SPLINE)) {
+                        FAIL(STATUS_GCODE_VALUE_WORD_MISSING);    // [I,J missing]
+                    }
+                    gc_block.values.ijk[X_AXIS] = -gc_state.spline_pq[X_AXIS];
+                    gc_block.values.ijk[Y_AXIS] = -gc_state.spline_pq[Y_AXIS];
+                } else if (gc_block.modal.units == UNITS_MODE_INCHES) {
+                    gc_block.values.ijk[X_AXIS] *= MM_PER_INCH;
+                    gc_block.values.ijk[Y_AXIS] *= MM_PER_INCH;
+                }
+                bit_false(value_words, (bit(WORD_I) | bit(WORD_J)));
+                if (gc_block.modal.motion == MOTION_MODE_CUBIC_SPLINE) {
+                    if ((value_words & (bit(WORD_P) | bit(WORD_Q))) != (bit(WORD_P) | bit(WORD_Q))) {
+                        FAIL(STATUS_GCODE_VALUE_WORD_MISSING);    // [P,Q missing]
+                    }
+                    if (gc_block.modal.units == UNITS_MODE_INCHES) {
+                        gc_block.values.p *= MM_PER_INCH;
+                        gc_block.values.q *= MM_PER_INCH;
+                    }
+                    bit_false(value_words, (bit(WORD_P) | bit(WORD_Q)));
+                }
+                break;
             case MOTION_MODE_PROBE_TOWARD_NO_ERROR:
             case MOTION_MODE_PROBE_AWAY_NO_ERROR:
                 gc_parser_flags |= GC_PARSER_PROBE_IS_NO_ERROR; // No break intentional.
@@ -1105,7 +1392,8 @@ uint8_t gc_execute_line(char* line, uint8_t client) {
     // If in laser mode, setup laser power based on current and past parser conditions.
     if (laser_mode->get()) {
         if (!((gc_block.modal.motion == MOTION_MODE_LINEAR) || (gc_block.modal.motion == MOTION_MODE_CW_ARC)
-                || (gc_block.modal.motion == MOTION_MODE_CCW_ARC)))
+                || (gc_block.modal.motion == MOTION_MODE_CCW_ARC) || (gc_block.modal.motion == MOTION_MODE_CUBIC_SPLINE)
+                || (gc_block.modal.motion == MOTION_MODE_QUADRATIC_SPLINE)))
             gc_parser_flags |= GC_PARSER_LASER_DISABLE;
         // Any motion mode with axis words is allowed to be passed from a spindle speed update.
         // NOTE: G1 and G0 without axis words sets axis_command to none. G28/30 are intentionally omitted.
@@ -1117,7 +1405,8 @@ uint8_t gc_execute_line(char* line, uint8_t client) {
             // a G1/2/3 motion mode state and vice versa when there is no motion in the line.
             if (gc_state.modal.spindle == SPINDLE_ENABLE_CW) {
                 if ((gc_state.modal.motion == MOTION_MODE_LINEAR) || (gc_state.modal.motion == MOTION_MODE_CW_ARC)
-                        || (gc_state.modal.motion == MOTION_MODE_CCW_ARC)) {
+                        || (gc_state.modal.motion == MOTION_MODE_CCW_ARC) || (gc_state.modal.motion == MOTION_MODE_CUBIC_SPLINE)
+                        || (gc_state.modal.motion == MOTION_MODE_QUADRATIC_SPLINE)) {
                     if (bit_istrue(gc_parser_flags, GC_PARSER_LASER_DISABLE)) {
                         gc_parser_flags |= GC_PARSER_LASER_FORCE_SYNC; // Change from G1/2/3 motion mode.
                     }
@@ -1231,8 +1520,10 @@ uint8_t gc_execute_line(char* line, uint8_t client) {
         memcpy(gc_state.coord_system, block_coord_system, N_AXIS * sizeof(float));
         system_flag_wco_change();
     }
-    // [16. Set path control mode ]: G61.1/G64 NOT SUPPORTED
-    // gc_state.modal.control = gc_block.modal.control; // NOTE: Always default.
+    // [16. Set path control mode ]: G61.1 NOT SUPPORTED
+    gc_state.modal.control = gc_block.modal.control;
+    gc_state.path_tolerance = block_path_tolerance;
+    pl_data->path_tolerance = gc_state.path_tolerance; // Record data for planner use.
     // [17. Set distance mode ]:
     gc_state.modal.distance = gc_block.modal.distance;
     // [18. Set retract mode ]: NOT SUPPORTED
@@ -1281,14 +1572,32 @@ uint8_t gc_execute_line(char* line, uint8_t client) {
             uint8_t gc_update_pos = GC_UPDATE_POS_TARGET;
             if (gc_state.modal.motion == MOTION_MODE_LINEAR) {
                 //mc_line(gc_block.values.xyz, pl_data);
-                mc_line_kins(gc_block.values.xyz, pl_data, gc_state.position);
+                gc_line_kins(gc_block.values.xyz, pl_data);
             } else if (gc_state.modal.motion == MOTION_MODE_SEEK) {
                 pl_data->condition |= PL_COND_FLAG_RAPID_MOTION; // Set rapid motion condition flag.
                 //mc_line(gc_block.values.xyz, pl_data);
-                mc_line_kins(gc_block.values.xyz, pl_data, gc_state.position);
+                gc_line_kins(gc_block.values.xyz, pl_data);
             } else if ((gc_state.modal.motion == MOTION_MODE_CW_ARC) || (gc_state.modal.motion == MOTION_MODE_CCW_ARC)) {
                 mc_arc(gc_block.values.xyz, pl_data, gc_state.position, gc_block.values.ijk, gc_block.values.r,
                        axis_0, axis_1, axis_linear, bit_istrue(gc_parser_flags, GC_PARSER_ARC_IS_CLOCKWISE));
+            } else if ((gc_state.modal.motion == MOTION_MODE_CUBIC_SPLINE) || (gc_state.modal.motion == MOTION_MODE_QUADRATIC_SPLINE)) {
+                // Absolute XY control points. A quadratic is passed as the identical cubic.
+                float first_control[2];
+                float second_control[2];
+                first_control[0] = gc_state.position[X_AXIS] + gc_block.values.ijk[X_AXIS];
+                first_control[1] = gc_state.position[Y_AXIS] + gc_block.values.ijk[Y_AXIS];
+                if (gc_state.modal.motion == MOTION_MODE_CUBIC_SPLINE) {
+                    second_control[0] = gc_block.values.xyz[X_AXIS] + gc_block.values.p;
+                    second_control[1] = gc_block.values.xyz[Y_AXIS] + gc_block.values.q;
+                    gc_state.spline_pq[X_AXIS] = gc_block.values.p;
+                    gc_state.spline_pq[Y_AXIS] = gc_block.values.q;
+                } else {
+                    second_control[0] = gc_block.values.xyz[X_AXIS] + (2.0 / 3.0) * (first_control[0] - gc_block.values.xyz[X_AXIS]);
+                    second_control[1] = gc_block.values.xyz[Y_AXIS] + (2.0 / 3.0) * (first_control[1] - gc_block.values.xyz[Y_AXIS]);
+                    first_control[0] = gc_state.position[X_AXIS] + (2.0 / 3.0) * gc_block.values.ijk[X_AXIS];
+                    first_control[1] = gc_state.position[Y_AXIS] + (2.0 / 3.0) * gc_block.values.ijk[Y_AXIS];
+                }
+                mc_spline(gc_block.values.xyz, pl_data, gc_state.position, first_control, second_control);
             } else {
                 // NOTE: gc_block.values.xyz is returned from mc_probe_cycle with the updated position value. So
                 // upon a successful probing cycle, the machine position and the returned value should be the same.
@@ -1386,5 +1695,5 @@ uint8_t gc_execute_line(char* line, uint8_t client) {
    group 8 = {M7*} enable mist coolant (* Compile-option)
    group 9 = {M48, M49} enable/disable feed and speed override switches
    group 10 = {G98, G99} return mode canned cycles
-   group 13 = {G61.1, G64} path control mode (G61 is supported)
+   group 13 = {G61.1} path control mode (G61 and G64 are supported)
 */
@@ -32,7 +32,7 @@
 // and are similar/identical to other g-code interpreters by manufacturers (Haas,Fanuc,Mazak,etc).
 // NOTE: Modal group define values must be sequential and starting from zero.
 #define MODAL_GROUP_G0 0 // [G4,G10,G28,G28.1,G30,G30.1,G53,G92,G92.1] Non-modal
-#define MODAL_GROUP_G1 1 // [G0,G1,G2,G3,G38.2,G38.3,G38.4,G38.5,G80] Motion
+#define MODAL_GROUP_G1 1 // [G0,G1,G2,G3,G5,G5.1,G38.2,G38.3,G38.4,G38.5,G80] Motion
 #define MODAL_GROUP_G2 2 // [G17,G18,G19] Plane selection
 #define MODAL_GROUP_G3 3 // [G90,G91] Distance mode
 #define MODAL_GROUP_G4 4 // [G91.1] Arc IJK distance mode
@@ -78,6 +78,8 @@
 #define MOTION_MODE_LINEAR 1 // G1 (Do not alter value)
 #define MOTION_MODE_CW_ARC 2  // G2 (Do not alter value)
 #define MOTION_MODE_CCW_ARC 3  // G3 (Do not alter value)
+#define MOTION_MODE_CUBIC_SPLINE 5  // G5 (Do not alter value)
+#define MOTION_MODE_QUADRATIC_SPLINE 51  // G5.1 (Do not alter value)
 #define MOTION_MODE_PROBE_TOWARD 140 // G38.2 (Do not alter value)
 #define MOTION_MODE_PROBE_TOWARD_NO_ERROR 141 // G38.3 (Do not alter value)
 #define MOTION_MODE_PROBE_AWAY 142 // G38.4 (Do not alter value)
@@ -116,6 +118,7 @@
 
 // Modal Group G13: Control mode
 #define CONTROL_MODE_EXACT_PATH 0 // G61 (Default: Must be zero)
+#define CONTROL_MODE_CONTINUOUS 1 // G64
 
 // Modal Group M7: Spindle control
 #define SPINDLE_DISABLE 0 // M5 (Default: Must be zero)
@@ -167,6 +170,7 @@
 #define WORD_A  13
 #define WORD_B  14
 #define WORD_C  15
+#define WORD_Q  16
 
 // Define g-code parser position updating flags
 #define GC_UPDATE_POS_TARGET   0 // Must be zero
@@ -198,7 +202,7 @@
 
 // NOTE: When this struct is zeroed, the above defines set the defaults for the system.
 typedef struct {
-    uint8_t motion;          // {G0,G1,G2,G3,G38.2,G80}
+    uint8_t motion;          // {G0,G1,G2,G3,G5,G5.1,G38.2,G80}
     uint8_t feed_rate;       // {G93,G94}
     uint8_t units;           // {G20,G21}
     uint8_t distance;        // {G90,G91}
@@ -207,7 +211,7 @@ typedef struct {
     // uint8_t cutter_comp;  // {G40} NOTE: Don't track. Only default supported.
     uint8_t tool_length;     // {G43.1,G49}
     uint8_t coord_select;    // {G54,G55,G56,G57,G58,G59}
-    // uint8_t control;      // {G61} NOTE: Don't track. Only default supported.
+    uint8_t control;         // {G61,G64}
     uint8_t program_flow;    // {M0,M1,M2,M30}
     uint8_t coolant;         // {M7,M8,M9}
     uint8_t spindle;         // {M3,M4,M5}
@@ -222,7 +226,7 @@ typedef struct {
     uint8_t l;       // G10 or canned cycles parameters
     int32_t n;       // Line number
     float p;         // G10 or dwell parameters
-    // float q;      // G82 peck drilling
+    float q;         // G5 second control point Y offset
     float r;         // Arc radius
     float s;         // Spindle speed
     uint8_t t;       // Tool selection
@@ -245,6 +249,8 @@ typedef struct {
     float coord_offset[N_AXIS];    // Retains the G92 coordinate offset (work coordinates) relative to
     // machine zero in mm. Non-persistent. Cleared upon reset and boot.
     float tool_length_offset;      // Tracks tool length offset value when enabled.
+    float path_tolerance;          // G64 P merge tolerance in mm. Zero when G61 is active.
+    float spline_pq[2];            // P,Q of the last G5 in mm. A following G5 without I,J reflects it.
 } parser_state_t;
 extern parser_state_t gc_state;
 
@@ -254,6 +260,7 @@ typedef struct {
     gc_modal_t modal;
     gc_values_t values;
 } parser_block_t;
+extern parser_block_t gc_block;
 
 
 // Initialize the parser
@@ -262,6 +269,14 @@ void gc_init();
 // Execute one block of rs275/ngc/g-code
 uint8_t gc_execute_line(char* line, uint8_t client);
 
+#ifdef USE_GCODE_FAST_PATH
+// Results of gc_fast_path_compare()
+#define GC_FAST_PATH_NOT_TAKEN 0  // The line needs the full parser
+#define GC_FAST_PATH_SAME 1
+#define GC_FAST_PATH_DIFFERS 2
+uint8_t gc_fast_path_compare(char* line, uint8_t client, uint8_t* result);
+#endif
+
 // Set g-code parser position. Input in steps.
 void gc_sync_position();
 
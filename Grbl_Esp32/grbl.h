@@ -29,6 +29,7 @@
 #include <Arduino.h>
 #include <EEPROM.h>
 #include <driver/rmt.h>
+#include <driver/uart.h>
 #include <esp_task_wdt.h>
 #include <freertos/task.h>
 #include <Preferences.h>
@@ -60,7 +61,10 @@
 #include "Spindles/SpindleClass.h"
 #include "Motors/MotorClass.h"
 #include "stepper.h"
+#include "stepper_timing.h"
+#include "motion_stats.h"
 #include "jog.h"
+#include "binary_stream.h"
 #include "inputbuffer.h"
 #include "commands.h"
 #include "SettingsClass.h"
@@ -69,6 +73,9 @@
 
 // Do not guard this because it is needed for local files too
 #include "grbl_sd.h"
+#include "job_cache.h"
+#include "job_index.h"
+#include "job_checkpoint.h"
 
 #ifdef ENABLE_BLUETOOTH
     #include "BTconfig.h"
@@ -26,6 +26,107 @@ uint8_t SD_client = CLIENT_SERIAL;
 uint32_t sd_current_line_number; // stores the most recent line number read from the SD
 static char comment[LINE_BUFFER_SIZE]; // Line to be executed. Zero-terminated.
 
+// Read-ahead. sdReaderTask() fills whole buffers with one bulk read each while the protocol loop
+// splits lines out of the previous one in RAM. Buffer indexes travel through two queues tagged
+// with the generation of the file they were issued for, so a read that was in flight when the
+// file was closed or reopened is dropped instead of being parsed as part of the new file.
+static uint8_t sd_read_buffer[SD_READ_BUFFERS][SD_READ_BUFFER_SIZE] __attribute__((aligned(4)));
+static int sd_read_length[SD_READ_BUFFERS];
+static xQueueHandle sd_empty_queue = NULL;   // Buffers waiting for the reader
+static xQueueHandle sd_filled_queue = NULL;  // Buffers waiting for readFileLine()
+static SemaphoreHandle_t sd_file_mutex = NULL; // Guards myFile against the reader task
+static TaskHandle_t sdReaderTaskHandle = NULL;
+static volatile uint32_t sd_read_generation = 0;
+static volatile bool sd_close_pending = false; // Closed from an interrupt, see sd_close_deferred()
+
+// Consumer side, only touched by the caller of readFileLine()
+static int sd_line_buffer = -1;     // Buffer being split into lines, -1 for none
+static int sd_line_pos = 0;
+static int sd_line_length = 0;
+static bool sd_read_done = false;   // The reader hit the end of the file
+static uint32_t sd_file_size = 0;
+static uint32_t sd_bytes_consumed = 0;
+
+#define SD_READ_ITEM(generation, index) (((generation) << 8) | (index))
+#define SD_READ_ITEM_INDEX(item) ((item) & 0xff)
+#define SD_READ_ITEM_GENERATION(item) ((item) >> 8)
+#define SD_READ_WAIT_TICKS 10 // Longest wait for the reader before checking the file is still open
+
+static void sdReaderTask(void* pvParameters) {
+    uint32_t item;
+    while (true) {
+        xQueueReceive(sd_empty_queue, &item, portMAX_DELAY);
+        int index = SD_READ_ITEM_INDEX(item);
+        xSemaphoreTake(sd_file_mutex, portMAX_DELAY);
+        if (SD_READ_ITEM_GENERATION(item) != sd_read_generation || !myFile) {
+            xSemaphoreGive(sd_file_mutex);
+            continue; // issued for a file that has since been closed
+        }
+        int length = myFile.read(sd_read_buffer[index], SD_READ_BUFFER_SIZE);
+        xSemaphoreGive(sd_file_mutex);
+        sd_read_length[index] = (length < 0) ? 0 : length;
+        xQueueSend(sd_filled_queue, &item, portMAX_DELAY);
+    }
+}
+
+static void sd_reader_init() {
+    if (sdReaderTaskHandle != NULL)
+        return;
+    sd_empty_queue = xQueueCreate(SD_READ_BUFFERS * 2, sizeof(uint32_t));
+    sd_filled_queue = xQueueCreate(SD_READ_BUFFERS * 2, sizeof(uint32_t));
+    sd_file_mutex = xSemaphoreCreateMutex();
+    xTaskCreatePinnedToCore(sdReaderTask,     // task
+                            "sdReaderTask", // name for task
+                            4096,   // size of task stack
+                            NULL,   // parameters
+                            SD_READER_TASK_PRIORITY, // priority
+                            &sdReaderTaskHandle,
+                            1 // core
+                           );
+}
+
+// Hands the current buffer back to the reader and waits for the next one. Returns false at the
+// end of the file.
+static bool sd_next_buffer() {
+    uint32_t item;
+    uint32_t generation = sd_read_generation;
+    if (sd_read_done)
+        return false;
+    if (sd_line_buffer >= 0) {
+        item = SD_READ_ITEM(generation, sd_line_buffer);
+        xQueueSend(sd_empty_queue, &item, portMAX_DELAY);
+        sd_line_buffer = -1;
+    }
+    while (true) {
+        // a reset can close the file under us, and then the reader never answers
+        if (generation != sd_read_generation || !myFile) {
+            sd_read_done = true;
+            return false;
+        }
+        if (xQueueReceive(sd_filled_queue, &item, SD_READ_WAIT_TICKS) == pdTRUE &&
+                SD_READ_ITEM_GENERATION(item) == generation)
+            break;
+    }
+    int index = SD_READ_ITEM_INDEX(item);
+    if (sd_read_length[index] == 0) {
+        sd_read_done = true;
+        return false;
+    }
+    sd_line_buffer = index;
+    sd_line_pos = 0;
+    sd_line_length = sd_read_length[index];
+    return true;
+}
+
+// True while there are unread bytes, waiting for the reader if it is behind
+static bool sd_data_available() {
+    while (sd_line_pos >= sd_line_length) {
+        if (!sd_next_buffer())
+            return false;
+    }
+    return true;
+}
+
 // attempt to mount the SD card
 /*bool sd_mount()
 {
@@ -58,12 +159,34 @@ void listDir(fs::FS& fs, const char* dirname, uint8_t levels, uint8_t client) {
     }
 }
 
+// Starts reading ahead from the current file position. The caller has bumped the generation and
+// emptied the queues with the file mutex held.
+static void sd_read_restart(uint32_t position) {
+    sd_bytes_consumed = position;
+    sd_line_buffer = -1;
+    sd_line_pos = sd_line_length = 0;
+    sd_read_done = false;
+    for (int index = 0; index < SD_READ_BUFFERS; index++) {
+        uint32_t item = SD_READ_ITEM(sd_read_generation, index);
+        xQueueSend(sd_empty_queue, &item, 0);
+    }
+}
+
 boolean openFile(fs::FS& fs, const char* path) {
+    sd_close_deferred();
+    sd_reader_init();
+    xSemaphoreTake(sd_file_mutex, portMAX_DELAY);
+    sd_read_generation++;
+    xQueueReset(sd_empty_queue);
+    xQueueReset(sd_filled_queue);
     myFile = fs.open(path);
+    xSemaphoreGive(sd_file_mutex);
     if (!myFile) {
         //report_status_message(STATUS_SD_FAILED_READ, CLIENT_SERIAL);
         return false;
     }
+    sd_file_size = myFile.size();
+    sd_read_restart(0);
     set_sd_state(SDCARD_BUSY_PRINTING);
     SD_ready_next = false; // this will get set to true when Grbl issues "ok" message
     sd_current_line_number = 0;
@@ -71,15 +194,75 @@ boolean openFile(fs::FS& fs, const char* path) {
 }
 
 boolean closeFile() {
+    // mc_reset() can get here from the limit switch interrupt, where neither the mutex nor the file
+    // can be touched while the reader may be in the middle of a read. Bumping the generation makes
+    // the reader drop whatever it has in flight, and the file is closed by sd_close_deferred() once
+    // the reset reaches the protocol loop.
+    if (xPortInIsrContext()) {
+        set_sd_state(SDCARD_IDLE);
+        SD_ready_next = false;
+        sd_current_line_number = 0;
+        sd_read_generation++;
+        sd_close_pending = true;
+        return true;
+    }
+    sd_close_deferred();
     if (!myFile)
         return false;
     set_sd_state(SDCARD_IDLE);
     SD_ready_next = false;
     sd_current_line_number = 0;
+    job_index_finish(false); // Otherwise closed by the next job
+    if (sd_file_mutex != NULL)
+        xSemaphoreTake(sd_file_mutex, portMAX_DELAY);
+    sd_read_generation++;
     myFile.close();
+    if (sd_file_mutex != NULL)
+        xSemaphoreGive(sd_file_mutex);
     return true;
 }
 
+// Finishes a closeFile() that was called from an interrupt. Taking the mutex waits for a read
+// that was in flight.
+void sd_close_deferred() {
+    if (!sd_close_pending)
+        return;
+    sd_close_pending = false;
+    job_index_finish(false);
+    if (sd_file_mutex != NULL)
+        xSemaphoreTake(sd_file_mutex, portMAX_DELAY);
+    myFile.close();
+    if (sd_file_mutex != NULL)
+        xSemaphoreGive(sd_file_mutex);
+}
+
+// Moves the open file to a byte offset, dropping whatever was read ahead. The line number is
+// left to the caller.
+boolean seekFile(uint32_t position) {
+    if (!myFile)
+        return false;
+    xSemaphoreTake(sd_file_mutex, portMAX_DELAY);
+    sd_read_generation++;
+    xQueueReset(sd_empty_queue);
+    xQueueReset(sd_filled_queue);
+    bool found = myFile.seek(position);
+    xSemaphoreGive(sd_file_mutex);
+    sd_read_restart(position);
+    return found;
+}
+
+// Size and modification time of a file, to tell if a sidecar file still belongs to it
+boolean sd_file_stat(const char* path, uint32_t* size, uint32_t* mtime) {
+    File file = SD.open(path);
+    if (!file)
+        return false;
+    bool found = !file.isDirectory();
+    *size = file.size();
+    *mtime = file.getLastWrite();
+    file.close();
+    return found;
+}
+
 /*
   read a line from the SD card
   strip whitespace
@@ -94,31 +277,58 @@ boolean readFileLine(char* line, int maxlen) {
     }
     sd_current_line_number += 1;
     int len = 0;
-    while (myFile.available()) {
+    while (sd_data_available()) {
         if (len >= maxlen) {
             return false;
         }
-        char c = myFile.read();
+        char c = sd_read_buffer[sd_line_buffer][sd_line_pos++];
+        sd_bytes_consumed++;
         if (c == '\n') {
             break;
         }
         line[len++] = c;
     }
     line[len] = '\0';
-    return len || myFile.available();
+    return len || sd_data_available();
+}
+
+// Reads len bytes of a binary file. Returns false if the file ends first.
+boolean readFileBytes(void* data, int len) {
+    uint8_t* dest = (uint8_t*)data;
+    if (!myFile)
+        return false;
+    while (len) {
+        if (!sd_data_available())
+            return false;
+        int count = sd_line_length - sd_line_pos;
+        if (count > len)
+            count = len;
+        memcpy(dest, &sd_read_buffer[sd_line_buffer][sd_line_pos], count);
+        sd_line_pos += count;
+        sd_bytes_consumed += count;
+        dest += count;
+        len -= count;
+    }
+    return true;
 }
 
 // return a percentage complete 50.5 = 50.5%
 float sd_report_perc_complete() {
-    if (!myFile)
+    if (!myFile || sd_file_size == 0)
         return 0.0;
-    return ((float)myFile.position() / (float)myFile.size() * 100.0);
+    // the file position runs up to a buffer ahead, so count what has been handed out as lines
+    return ((float)sd_bytes_consumed / (float)sd_file_size * 100.0);
 }
 
 uint32_t sd_get_current_line_number() {
     return sd_current_line_number;
 }
 
+// Byte offset of the next line to be read
+uint32_t sd_get_current_offset() {
+    return sd_bytes_consumed;
+}
+
 
 uint8_t sd_state = SDCARD_IDLE;
 
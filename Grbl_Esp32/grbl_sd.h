@@ -33,10 +33,15 @@
 #define SDCARD_BUSY_UPLOADING 4
 #define SDCARD_BUSY_PARSING 8
 
+#define SD_READ_BUFFER_SIZE 4096   // Bytes fetched from the card by one read
+#define SD_READ_BUFFERS 2          // Double buffered: one is parsed while the other is filled
+#define SD_READER_TASK_PRIORITY 1  // Same as the protocol loop, it spends its time waiting on the card
+#define SD_LINES_PER_PASS 32       // Most lines run per pass through the main loop, see protocol.cpp
 
 
 extern bool SD_ready_next; // Grbl has processed a line and is waiting for another
 extern  uint8_t SD_client;
+extern uint32_t sd_current_line_number; // Reported with errors in a SD job
 
 //bool sd_mount();
 uint8_t get_sd_state(bool refresh);
@@ -44,10 +49,15 @@ uint8_t set_sd_state(uint8_t flag);
 void listDir(fs::FS& fs, const char* dirname, uint8_t levels, uint8_t client);
 boolean openFile(fs::FS& fs, const char* path);
 boolean closeFile();
+void sd_close_deferred();
 boolean readFileLine(char* line, int len);
+boolean readFileBytes(void* data, int len);
+boolean seekFile(uint32_t position);
+boolean sd_file_stat(const char* path, uint32_t* size, uint32_t* mtime);
 void readFile(fs::FS& fs, const char* path);
 float sd_report_perc_complete();
 uint32_t sd_get_current_line_number();
+uint32_t sd_get_current_offset();
 void sd_get_current_filename(char* name);
 
 #endif
@@ -104,6 +104,7 @@ static int i2s_out_initialized = 0;
 static volatile uint32_t i2s_out_pulse_period;
 static uint32_t i2s_out_remain_time_until_next_pulse; // Time remaining until the next pulse (μsec)
 static volatile i2s_out_pulse_func_t i2s_out_pulse_func;
+static volatile i2s_out_render_func_t i2s_out_render_func;
 #endif
 
 static uint8_t i2s_out_ws_pin = 255;
@@ -333,6 +334,27 @@ static int IRAM_ATTR i2s_fillout_dma_buffer(lldesc_t *dma_desc) {
     // and the pulse generation is postponed until the next buffer is filled.
     //
     o_dma.rw_pos = 0;
+    if (i2s_out_render_func != NULL) {
+      //
+      // Let the renderer fill the whole buffer in one call.
+      // The pulser lock is released because the renderer may change the pulser status.
+      //
+      I2S_OUT_PULSER_EXIT_CRITICAL();
+      o_dma.rw_pos = (*i2s_out_render_func)(buf, DMA_SAMPLE_COUNT);
+      I2S_OUT_PULSER_ENTER_CRITICAL();
+      if (i2s_out_pulser_status == WAITING) {
+        // i2s_out_set_passthrough() has called from the render function.
+        // This DMA descriptor must be a tail of the chain.
+        dma_desc->qe.stqe_next = NULL;
+      } else if (i2s_out_pulser_status == PASSTHROUGH) {
+        // i2s_out_reset() has called during the execution of the render function.
+        // The buffers have already been cleared, so treat this one as full.
+        o_dma.rw_pos = DMA_SAMPLE_COUNT;
+      }
+      dma_desc->length = o_dma.rw_pos * I2S_SAMPLE_SIZE;
+      I2S_OUT_PULSER_EXIT_CRITICAL(); // Unlock pulser status
+      return 0;
+    }
     while (o_dma.rw_pos < (DMA_SAMPLE_COUNT - SAMPLE_SAFE_COUNT)) {
         // no data to read (buffer empty)
         if (i2s_out_remain_time_until_next_pulse < I2S_OUT_USEC_PER_PULSE) {
@@ -535,6 +557,10 @@ uint8_t IRAM_ATTR i2s_out_state(uint8_t pin) {
   return (!!(port_data & bit(pin)));
 }
 
+uint32_t IRAM_ATTR i2s_out_get_port_data() {
+  return atomic_load(&i2s_out_port_data);
+}
+
 uint32_t IRAM_ATTR i2s_out_push_sample(uint32_t num) {
 #ifdef USE_I2S_OUT_STREAM
   if (num > SAMPLE_SAFE_COUNT) {
@@ -624,6 +650,13 @@ int IRAM_ATTR i2s_out_set_pulse_callback(i2s_out_pulse_func_t func) {
   return 0;
 }
 
+int IRAM_ATTR i2s_out_set_render_callback(i2s_out_render_func_t func) {
+#ifdef USE_I2S_OUT_STREAM
+  i2s_out_render_func = func;
+#endif
+  return 0;
+}
+
 int IRAM_ATTR i2s_out_reset() {
   I2S_OUT_PULSER_ENTER_CRITICAL();
   i2s_out_stop();
@@ -75,6 +75,7 @@
 #define I2S_OUT_DELAY_MS        (I2S_OUT_DELAY_DMABUF_MS * (I2S_OUT_DMABUF_COUNT + 1))
 
 typedef void (*i2s_out_pulse_func_t)(void);
+typedef uint32_t (*i2s_out_render_func_t)(uint32_t* buf, uint32_t num);
 
 typedef struct {
     /*
@@ -124,6 +125,11 @@ int i2s_out_init();
 */
 uint8_t i2s_out_state(uint8_t pin);
 
+/*
+  Get all the bits of the internal pin state var.
+ */
+uint32_t i2s_out_get_port_data();
+
 /*
    Set a bit in the internal pin state var. (not written electrically)
    pin: expanded pin No. (0..31)
@@ -174,6 +180,16 @@ int i2s_out_set_pulse_period(uint32_t period);
  */
 int i2s_out_set_pulse_callback(i2s_out_pulse_func_t func);
 
+/*
+   Register a callback function that renders pulse data for a whole DMA buffer
+   (used instead of the pulse callback when set)
+     buf: sample buffer to fill
+     num: number of samples wanted
+     return: number of samples written (1..num).
+             Less than num only when stepping is being stopped.
+ */
+int i2s_out_set_render_callback(i2s_out_render_func_t func);
+
 /*
    Reset i2s I/O expander
    - Stop ISR/DMA
@@ -23,6 +23,7 @@
 
 #include "config.h"
 #include "inputbuffer.h"
+#include "grbl.h"
 
 InputBuffer inputBuffer;
 
@@ -94,6 +95,7 @@ bool InputBuffer::push(const char* data) {
             current ++;
         }
         _RXbufferSize += strlen(data);
+        serial_notify_rx();
         return true;
     }
     return false;
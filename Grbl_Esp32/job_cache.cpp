@@ -0,0 +1,367 @@
+/*
+  job_cache.cpp - Precompiled SD card jobs
+  Part of Grbl_ESP32
+
+  Grbl is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  Grbl is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with Grbl.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "grbl.h"
+
+bool job_cache_recording = false;
+
+// Records of the line being compiled. Written out once the line is known to be motion only.
+static uint8_t jc_line_records[JOB_CACHE_LINE_BUFFER];
+static uint16_t jc_line_used;
+static uint16_t jc_line_moves;
+static bool jc_line_overflow;
+static bool jc_line_probe;
+static uint32_t jc_source_line;
+
+static bool jc_active = false;  // The SD job was opened from a cache
+
+// FNV-1a. Used for the state key and to compare the records of the two compile passes.
+static uint32_t job_cache_hash(uint32_t hash, const void* data, size_t length) {
+    const uint8_t* bytes = (const uint8_t*)data;
+    while (length--) {
+        hash ^= *bytes++;
+        hash *= 16777619;
+    }
+    return (hash);
+}
+#define JOB_CACHE_HASH_INIT 2166136261
+
+// Everything the records were computed from. The position, feed and spindle speed only count
+// when the compile found the job depends on them.
+static uint32_t job_cache_state_key(uint8_t flags) {
+    uint32_t hash = JOB_CACHE_HASH_INIT;
+    hash = job_cache_hash(hash, &gc_state.modal, sizeof(gc_state.modal));
+    hash = job_cache_hash(hash, gc_state.coord_system, sizeof(gc_state.coord_system));
+    hash = job_cache_hash(hash, gc_state.coord_offset, sizeof(gc_state.coord_offset));
+    hash = job_cache_hash(hash, &gc_state.tool_length_offset, sizeof(gc_state.tool_length_offset));
+    hash = job_cache_hash(hash, &gc_state.path_tolerance, sizeof(gc_state.path_tolerance));
+    float arc_settings[2] = { arc_tolerance->get(), arc_chord_time->get() };
+    hash = job_cache_hash(hash, arc_settings, sizeof(arc_settings));
+    bool laser = laser_mode->get();
+    hash = job_cache_hash(hash, &laser, sizeof(laser));
+    if (flags & JOB_CACHE_KEY_POSITION) {
+        hash = job_cache_hash(hash, gc_state.position, sizeof(gc_state.position));
+        hash = job_cache_hash(hash, &gc_state.feed_rate, sizeof(gc_state.feed_rate));
+        hash = job_cache_hash(hash, &gc_state.spindle_speed, sizeof(gc_state.spindle_speed));
+        hash = job_cache_hash(hash, gc_state.spline_pq, sizeof(gc_state.spline_pq));
+    }
+    return (hash);
+}
+
+static bool job_cache_append(uint8_t type, const void* data, uint16_t length) {
+    if (jc_line_overflow || jc_line_used + sizeof(job_cache_record_t) + length > JOB_CACHE_LINE_BUFFER) {
+        jc_line_overflow = true;
+        return (false);
+    }
+    job_cache_record_t record = { type, 0, length, jc_source_line };
+    memcpy(&jc_line_records[jc_line_used], &record, sizeof(record));
+    memcpy(&jc_line_records[jc_line_used + sizeof(record)], data, length);
+    jc_line_used += sizeof(record) + length;
+    return (true);
+}
+
+// Copies the fields one by one, so the padding is zero in both compile passes.
+static void job_cache_copy_pl_data(plan_line_data_t* to, plan_line_data_t* from) {
+    to->feed_rate = from->feed_rate;
+    to->spindle_speed = from->spindle_speed;
+    to->condition = from->condition;
+    to->path_tolerance = from->path_tolerance;
+#ifdef USE_LINE_NUMBERS
+    to->line_number = from->line_number;
+#endif
+}
+
+void job_cache_record_line(float* target, plan_line_data_t* pl_data) {
+    job_cache_line_t line;
+    memset(&line, 0, sizeof(line));
+    memcpy(line.target, target, sizeof(line.target));
+    job_cache_copy_pl_data(&line.pl_data, pl_data);
+    if (job_cache_append(JOB_CACHE_LINE, &line, sizeof(line)))
+        jc_line_moves++;
+}
+
+void job_cache_record_arc(float* target, plan_line_data_t* pl_data, float* offset, float radius,
+                          uint8_t axis_0, uint8_t axis_1, uint8_t axis_linear, uint8_t is_clockwise_arc) {
+    job_cache_arc_t arc;
+    memset(&arc, 0, sizeof(arc));
+    memcpy(arc.target, target, sizeof(arc.target));
+    job_cache_copy_pl_data(&arc.pl_data, pl_data);
+    memcpy(arc.offset, offset, sizeof(arc.offset));
+    arc.radius = radius;
+    arc.axis_0 = axis_0;
+    arc.axis_1 = axis_1;
+    arc.axis_linear = axis_linear;
+    arc.is_clockwise_arc = is_clockwise_arc;
+    if (job_cache_append(JOB_CACHE_ARC, &arc, sizeof(arc)))
+        jc_line_moves++;
+}
+
+void job_cache_record_probe() {
+    jc_line_probe = true;
+}
+
+// True when the block changed nothing but what a state record restores.
+static bool job_cache_motion_only(parser_state_t* before) {
+    if (gc_block.non_modal_command != NON_MODAL_NO_ACTION &&
+            gc_block.non_modal_command != NON_MODAL_ABSOLUTE_OVERRIDE)
+        return (false);
+    if (gc_block.modal.program_flow != PROGRAM_FLOW_RUNNING || gc_block.modal.tool_change == TOOL_CHANGE ||
+            gc_block.modal.io_control != 0)
+        return (false);
+    parser_state_t after;
+    memcpy(&after, &gc_state, sizeof(after));
+    after.modal.motion = before->modal.motion;
+    after.feed_rate = before->feed_rate;
+    after.spindle_speed = before->spindle_speed;
+    after.line_number = before->line_number;
+    memcpy(after.position, before->position, sizeof(after.position));
+    memcpy(after.spline_pq, before->spline_pq, sizeof(after.spline_pq));
+    return (memcmp(&after, before, sizeof(after)) == 0);
+}
+
+// Writes a record to the cache file, if there is one, and adds it to the pass digest.
+static void job_cache_emit(File* out, uint32_t* digest, const void* data, size_t length) {
+    *digest = job_cache_hash(*digest, data, length);
+    if (out)
+        out->write((const uint8_t*)data, length);
+}
+
+// One pass over the source file. The caller has put the parser in check mode.
+static err_t job_cache_pass(const char* path, File* out, uint32_t* digest, uint32_t* records, uint8_t client) {
+    char line[256];
+    char raw[256];
+    if (!openFile(SD, path))
+        return (STATUS_SD_FAILED_READ);
+    *digest = JOB_CACHE_HASH_INIT;
+    *records = 0;
+    jc_source_line = 0;
+    while (readFileLine(line, 255)) {
+        jc_source_line++;
+        protocol_execute_realtime();
+        if (sys.abort) {
+            closeFile();
+            return (STATUS_OK);
+        }
+        strcpy(raw, line); // gc_execute_line() collapses the line in place
+        parser_state_t before;
+        memcpy(&before, &gc_state, sizeof(before));
+        memset(&gc_block, 0, sizeof(gc_block)); // The fast path leaves it alone
+        jc_line_used = 0;
+        jc_line_moves = 0;
+        jc_line_overflow = false;
+        jc_line_probe = false;
+        job_cache_recording = true;
+        err_t status = gc_execute_line(line, client);
+        job_cache_recording = false;
+        if (status != STATUS_OK && status != STATUS_GCODE_UNSUPPORTED_COMMAND) {
+            closeFile();
+            grbl_sendf(client, "[MSG:Compile error:%d at line %d]\r\n", status, jc_source_line);
+            return (status);
+        }
+        if (jc_line_probe) {
+            closeFile();
+            grbl_sendf(client, "[MSG:Cannot compile probing at line %d]\r\n", jc_source_line);
+            return (STATUS_GCODE_UNSUPPORTED_COMMAND);
+        }
+        job_cache_record_t record = { 0, 0, 0, jc_source_line };
+        bool motion_only = status == STATUS_OK && !jc_line_overflow && job_cache_motion_only(&before);
+        job_cache_state_t state;
+        memset(&state, 0, sizeof(state));
+        state.feed_rate = gc_state.feed_rate;
+        state.spindle_speed = gc_state.spindle_speed;
+        state.line_number = gc_state.line_number;
+        memcpy(state.spline_pq, gc_state.spline_pq, sizeof(state.spline_pq));
+        if (motion_only && jc_line_moves == 0 && gc_state.modal.motion == before.modal.motion &&
+                state.feed_rate == before.feed_rate && state.spindle_speed == before.spindle_speed &&
+                state.line_number == before.line_number &&
+                memcmp(state.spline_pq, before.spline_pq, sizeof(state.spline_pq)) == 0)
+            continue; // Blank, a comment, or modes that were already set
+        // A line that sets S or the motion mode without moving stays text. With M3 on, the parser
+        // syncs the spindle to it, or in laser mode turns the laser off or back on for G0/G1.
+        if (motion_only && jc_line_moves > 0) {
+            record.type = JOB_CACHE_STATE;
+            record.motion = gc_state.modal.motion;
+            record.length = sizeof(state);
+            job_cache_emit(out, digest, &record, sizeof(record));
+            job_cache_emit(out, digest, &state, sizeof(state));
+            job_cache_emit(out, digest, jc_line_records, jc_line_used);
+            *records += 1 + jc_line_moves;
+        } else {
+            record.type = JOB_CACHE_TEXT;
+            record.length = strlen(raw);
+            job_cache_emit(out, digest, &record, sizeof(record));
+            job_cache_emit(out, digest, raw, record.length);
+            *records += 1;
+            // Check mode skips the coordinate reload at program end, run time does not.
+            if (gc_block.modal.program_flow == PROGRAM_FLOW_COMPLETED_M2 ||
+                    gc_block.modal.program_flow == PROGRAM_FLOW_COMPLETED_M30)
+                settings_read_coord_data(gc_state.modal.coord_select, gc_state.coord_system);
+        }
+    }
+    job_cache_record_t end = { JOB_CACHE_END, 0, 0, jc_source_line };
+    job_cache_emit(out, digest, &end, sizeof(end));
+    closeFile();
+    return (STATUS_OK);
+}
+
+err_t job_cache_compile(const char* path, uint8_t client) {
+    uint32_t source_size, source_mtime;
+    if (!sd_file_stat(path, &source_size, &source_mtime))
+        return (STATUS_SD_FILE_NOT_FOUND);
+    String cache_path = String(path) + JOB_CACHE_SUFFIX;
+    File out = SD.open(cache_path.c_str(), FILE_WRITE);
+    if (!out)
+        return (STATUS_SD_FAILED_OPEN_FILE);
+    // The header is only written once the compile succeeded, so an aborted compile leaves a
+    // cache that never matches.
+    job_cache_header_t header;
+    memset(&header, 0, sizeof(header));
+    out.write((const uint8_t*)&header, sizeof(header));
+    parser_state_t saved_state;
+    memcpy(&saved_state, &gc_state, sizeof(saved_state));
+    uint8_t saved_sys_state = sys.state;
+    sys.state = STATE_CHECK_MODE;
+    uint32_t digest, perturbed_digest, records, perturbed_records;
+    uint32_t start_time = millis();
+    err_t status = job_cache_pass(path, &out, &digest, &records, client);
+    if (status == STATUS_OK && !sys.abort) {
+        // Again from somewhere else, to find out if the records depend on where the job starts
+        memcpy(&gc_state, &saved_state, sizeof(gc_state));
+        for (uint8_t idx = 0; idx < N_AXIS; idx++)
+            gc_state.position[idx] += 1.25;
+        gc_state.feed_rate = gc_state.feed_rate * 1.5 + 1.0;
+        gc_state.spindle_speed += 1.0;
+        gc_state.spline_pq[0] += 1.25;
+        status = job_cache_pass(path, NULL, &perturbed_digest, &perturbed_records, client);
+    }
+    memcpy(&gc_state, &saved_state, sizeof(gc_state));
+    sys.state = saved_sys_state;
+    if (status != STATUS_OK || sys.abort) {
+        out.close();
+        SD.remove(cache_path.c_str());
+        return (status);
+    }
+    header.magic = JOB_CACHE_MAGIC;
+    header.version = JOB_CACHE_VERSION;
+    header.n_axis = N_AXIS;
+    header.flags = (digest == perturbed_digest) ? 0 : JOB_CACHE_KEY_POSITION;
+    header.plan_data_size = sizeof(plan_line_data_t);
+    header.source_size = source_size;
+    header.source_mtime = source_mtime;
+    header.state_key = job_cache_state_key(header.flags);
+    header.records = records;
+    out.seek(0);
+    out.write((const uint8_t*)&header, sizeof(header));
+    out.close();
+    grbl_sendf(client, "[MSG:Compiled %d lines to %d records in %d ms%s]\r\n", jc_source_line, records,
+               millis() - start_time, (header.flags & JOB_CACHE_KEY_POSITION) ? ", start position bound" : "");
+    return (STATUS_OK);
+}
+
+bool job_cache_open(const char* path, uint8_t client) {
+    jc_active = false;
+    uint32_t source_size, source_mtime;
+    if (!sd_file_stat(path, &source_size, &source_mtime))
+        return (false);
+    String cache_path = String(path) + JOB_CACHE_SUFFIX;
+    if (!SD.exists(cache_path.c_str()))
+        return (false);
+    if (!openFile(SD, cache_path.c_str()))
+        return (false);
+    job_cache_header_t header;
+    if (!readFileBytes(&header, sizeof(header)) || header.magic != JOB_CACHE_MAGIC ||
+            header.version != JOB_CACHE_VERSION || header.n_axis != N_AXIS ||
+            header.plan_data_size != sizeof(plan_line_data_t) ||
+            header.source_size != source_size || header.source_mtime != source_mtime) {
+        closeFile();
+        grbl_send(client, "[MSG:Job cache is out of date, running from text]\r\n");
+        return (false);
+    }
+    if (header.state_key != job_cache_state_key(header.flags)) {
+        closeFile();
+        grbl_send(client, "[MSG:Job cache was compiled from another state, running from text]\r\n");
+        return (false);
+    }
+    jc_active = true;
+    return (true);
+}
+
+bool job_cache_running() {
+    return (jc_active && get_sd_state(false) == SDCARD_BUSY_PRINTING);
+}
+
+bool job_cache_execute_next(err_t* status) {
+    job_cache_record_t record;
+    *status = STATUS_OK;
+    if (!readFileBytes(&record, sizeof(record)) || record.type == JOB_CACHE_END)
+        return (false);
+    sd_current_line_number = record.source_line;
+    switch (record.type) {
+    case JOB_CACHE_TEXT: {
+        char line[256];
+        if (record.length >= sizeof(line) || !readFileBytes(line, record.length)) {
+            *status = STATUS_SD_FAILED_READ;
+            break;
+        }
+        line[record.length] = '\0';
+        *status = gc_execute_line(line, SD_client);
+        break;
+    }
+    case JOB_CACHE_STATE: {
+        job_cache_state_t state;
+        if (record.length != sizeof(state) || !readFileBytes(&state, sizeof(state))) {
+            *status = STATUS_SD_FAILED_READ;
+            break;
+        }
+        // An S word changes the speed right away unless it goes with the motion, as in gc_execute_line().
+        if (gc_state.spindle_speed != state.spindle_speed && gc_state.modal.spindle != SPINDLE_DISABLE &&
+                !laser_mode->get())
+            spindle->spindle_sync(gc_state.modal.spindle, state.spindle_speed);
+        gc_state.modal.motion = record.motion;
+        gc_state.feed_rate = state.feed_rate;
+        gc_state.spindle_speed = state.spindle_speed;
+        gc_state.line_number = state.line_number;
+        memcpy(gc_state.spline_pq, state.spline_pq, sizeof(gc_state.spline_pq));
+        break;
+    }
+    case JOB_CACHE_LINE: {
+        job_cache_line_t line;
+        if (record.length != sizeof(line) || !readFileBytes(&line, sizeof(line))) {
+            *status = STATUS_SD_FAILED_READ;
+            break;
+        }
+        mc_line_kins(line.target, &line.pl_data, gc_state.position);
+        memcpy(gc_state.position, line.target, sizeof(line.target));
+        break;
+    }
+    case JOB_CACHE_ARC: {
+        job_cache_arc_t arc;
+        if (record.length != sizeof(arc) || !readFileBytes(&arc, sizeof(arc))) {
+            *status = STATUS_SD_FAILED_READ;
+            break;
+        }
+        mc_arc(arc.target, &arc.pl_data, gc_state.position, arc.offset, arc.radius,
+               arc.axis_0, arc.axis_1, arc.axis_linear, arc.is_clockwise_arc);
+        memcpy(gc_state.position, arc.target, sizeof(arc.target));
+        break;
+    }
+    default:
+        *status = STATUS_SD_FAILED_READ;
+    }
+    return (true);
+}
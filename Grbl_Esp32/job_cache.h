@@ -0,0 +1,129 @@
+/*
+  job_cache.h - Precompiled SD card jobs
+  Part of Grbl_ESP32
+
+  Grbl is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  Grbl is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with Grbl.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifndef job_cache_h
+#define job_cache_h
+
+#include "grbl.h"
+
+/*
+  $SD/Compile=<path> runs a g-code file through the parser in check mode and writes what the
+  parser handed to motion control into <path>.cache. $SD/Run (ESP220) on the same path then
+  replays the cache instead of parsing the text again, as long as it is still valid.
+
+  A line whose only effect is motion becomes a state record (motion mode, feed, spindle speed,
+  line number) followed by the resolved lines and arcs in machine coordinates. They are replayed
+  into mc_line() and mc_arc() directly. Every other line (spindle and coolant changes, offsets,
+  dwells, program flow, tool changes, and modes or S words without a move) is kept as text and
+  goes through gc_execute_line() again, so its side effects happen at run time just as they would
+  from the text file.
+
+  The cache is keyed by the size and modification time of the source file and by the parser
+  state and settings it was compiled from. The compile runs twice, the second time from a shifted
+  position, feed and spindle speed. If both runs give the same records the job does not depend on
+  where it starts, otherwise those are part of the key as well. Probing cannot be compiled, since
+  the rest of the job depends on where the probe stops.
+
+  Like $C, the compile executes G10, G28.1 and G30.1 and so stores their offsets.
+*/
+
+#define JOB_CACHE_SUFFIX ".cache"
+#define JOB_CACHE_MAGIC 0x43424A47  // "GJBC"
+#define JOB_CACHE_VERSION 2         // Bump when the records or what is compiled into them change
+
+#define JOB_CACHE_TEXT 'T'   // Line to parse again
+#define JOB_CACHE_STATE 'S'  // Parser state after a motion line
+#define JOB_CACHE_LINE 'L'   // mc_line()
+#define JOB_CACHE_ARC 'A'    // mc_arc()
+#define JOB_CACHE_END 'E'
+
+#define JOB_CACHE_KEY_POSITION bit(0)  // The records depend on the start position, feed and speed
+
+// Record bytes collected for one line. A line with more motion than fits, like a long spline,
+// is kept as text.
+#ifndef JOB_CACHE_LINE_BUFFER
+    #define JOB_CACHE_LINE_BUFFER 2048
+#endif
+
+typedef struct {
+    uint32_t magic;
+    uint16_t version;
+    uint8_t n_axis;
+    uint8_t flags;            // JOB_CACHE_KEY_*
+    uint16_t plan_data_size;  // sizeof(plan_line_data_t), which changes with the build options
+    uint16_t reserved;
+    uint32_t source_size;
+    uint32_t source_mtime;
+    uint32_t state_key;
+    uint32_t records;
+} job_cache_header_t;
+
+typedef struct {
+    uint8_t type;          // JOB_CACHE_*
+    uint8_t motion;        // Motion mode, state records only
+    uint16_t length;       // Bytes that follow
+    uint32_t source_line;  // Line in the source file, for error reports
+} job_cache_record_t;
+
+typedef struct {
+    float feed_rate;
+    float spindle_speed;
+    int32_t line_number;
+    float spline_pq[2];
+} job_cache_state_t;
+
+typedef struct {
+    float target[N_AXIS];
+    plan_line_data_t pl_data;
+} job_cache_line_t;
+
+typedef struct {
+    float target[N_AXIS];
+    plan_line_data_t pl_data;
+    float offset[N_AXIS];
+    float radius;
+    uint8_t axis_0;
+    uint8_t axis_1;
+    uint8_t axis_linear;
+    uint8_t is_clockwise_arc;
+} job_cache_arc_t;
+
+// True while a compile runs. mc_line() and mc_arc() hand their arguments to the recorder then,
+// and mc_probe_cycle() reports that the job probes.
+extern bool job_cache_recording;
+
+void job_cache_record_line(float* target, plan_line_data_t* pl_data);
+void job_cache_record_arc(float* target, plan_line_data_t* pl_data, float* offset, float radius,
+                          uint8_t axis_0, uint8_t axis_1, uint8_t axis_linear, uint8_t is_clockwise_arc);
+void job_cache_record_probe();
+
+// Compiles path into its cache file. Called by $SD/Compile.
+err_t job_cache_compile(const char* path, uint8_t client);
+
+// Opens the cache of path for a SD job if it is valid for the file and the current state.
+// Returns false to run the text file instead.
+bool job_cache_open(const char* path, uint8_t client);
+
+// True while the running SD job is a cache replay.
+bool job_cache_running();
+
+// Runs the next record of the cache. Returns false at the end of the job, otherwise sets status
+// like gc_execute_line() does for a text line.
+bool job_cache_execute_next(err_t* status);
+
+#endif
@@ -0,0 +1,172 @@
+/*
+  job_checkpoint.cpp - Power loss checkpoints of SD card jobs
+  Part of Grbl_ESP32
+
+  Grbl is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  Grbl is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with Grbl.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "grbl.h"
+#include "nvs.h"
+
+#define JOB_CHECKPOINT_KEY "job"
+
+static job_checkpoint_t cp_job;       // Job being checkpointed. Line and position are filled in when saved.
+static portMUX_TYPE cp_mutex = portMUX_INITIALIZER_UNLOCKED;
+static volatile bool cp_active = false;
+static volatile bool cp_clear = false;  // The job ended, erase the checkpoint
+static uint32_t cp_saved_line;          // Checkpointing task only, except for the reset at a job start
+static uint32_t cp_saved_time;
+static nvs_handle cp_handle;
+static bool cp_nvs_open = false;
+static TaskHandle_t jobCheckpointTaskHandle = NULL;
+
+static bool job_checkpoint_nvs() {
+    if (!cp_nvs_open)
+        cp_nvs_open = (nvs_open("GrblJob", NVS_READWRITE, &cp_handle) == ESP_OK);
+    return cp_nvs_open;
+}
+
+static void job_checkpoint_save(uint32_t line) {
+    job_checkpoint_t checkpoint;
+    int32_t steps[N_AXIS];
+    vTaskEnterCritical(&cp_mutex);
+    memcpy(&checkpoint, &cp_job, sizeof(checkpoint));
+    vTaskExitCritical(&cp_mutex);
+    memcpy(steps, (void*)sys_position, sizeof(steps));
+    checkpoint.line = line;
+    system_convert_array_steps_to_mpos(checkpoint.position, steps);
+    nvs_set_blob(cp_handle, JOB_CHECKPOINT_KEY, &checkpoint, sizeof(checkpoint));
+    nvs_commit(cp_handle);
+}
+
+// A flash write stops the cache and masks the step timer interrupts, so NVS is only written while
+// the steppers are stopped: idle, as in a dwell or a spindle delay, or in a completed feed hold.
+static bool job_checkpoint_stopped() {
+    if (sys.state == STATE_HOLD)
+        return (sys.suspend & SUSPEND_HOLD_COMPLETE);
+    return (sys.state == STATE_IDLE);
+}
+
+// Saves the running job when it stops, its line moved on and the last save is old enough. Only
+// reads the planner, without the prep lock, so segment prep never waits for a flash write.
+static void jobCheckpointTask(void* pvParameters) {
+    while (true) {
+        vTaskDelay(JOB_CHECKPOINT_POLL_MS / portTICK_PERIOD_MS);
+        if (!job_checkpoint_stopped())
+            continue;
+        if (cp_clear) {
+            cp_clear = false;
+            if (nvs_erase_key(cp_handle, JOB_CHECKPOINT_KEY) == ESP_OK)
+                nvs_commit(cp_handle);
+            continue;
+        }
+        if (!cp_active)
+            continue;
+        if (get_sd_state(false) != SDCARD_BUSY_PRINTING) {
+            cp_active = false; // Stopped by an error or a reset. The last checkpoint stays.
+            continue;
+        }
+        int32_t interval = sd_checkpoint_time->get();
+        if (interval == 0)
+            continue;
+        uint32_t now = millis();
+        if (cp_saved_line && (now - cp_saved_time) < (uint32_t)interval * 1000)
+            continue;
+        // Between moves, e.g. in a dwell, the line being parsed is the one that runs
+        plan_block_t* block = plan_get_current_block();
+        uint32_t line = block ? block->job_line : sd_get_current_line_number();
+        if (line == 0 || line == cp_saved_line)
+            continue;
+        job_checkpoint_save(line);
+        cp_saved_line = line;
+        cp_saved_time = now;
+    }
+}
+
+void job_checkpoint_start(const char* path) {
+    if (!job_checkpoint_nvs())
+        return;
+    if (jobCheckpointTaskHandle == NULL) {
+        xTaskCreatePinnedToCore(jobCheckpointTask,     // task
+                                "jobCheckpointTask", // name for task
+                                4096,   // size of task stack
+                                NULL,   // parameters
+                                JOB_CHECKPOINT_TASK_PRIORITY, // priority
+                                &jobCheckpointTaskHandle,
+                                1 // core
+                               );
+    }
+    job_checkpoint_t checkpoint;
+    memset(&checkpoint, 0, sizeof(checkpoint));
+    checkpoint.magic = JOB_CHECKPOINT_MAGIC;
+    checkpoint.version = JOB_CHECKPOINT_VERSION;
+    checkpoint.n_axis = N_AXIS;
+    strncpy(checkpoint.path, path, JOB_CHECKPOINT_PATH_MAX - 1);
+    if (strlen(path) >= JOB_CHECKPOINT_PATH_MAX || !sd_file_stat(path, &checkpoint.source_size, &checkpoint.source_mtime)) {
+        cp_active = false;
+        return;
+    }
+    vTaskEnterCritical(&cp_mutex);
+    memcpy(&cp_job, &checkpoint, sizeof(cp_job));
+    vTaskExitCritical(&cp_mutex);
+    cp_saved_line = 0;
+    cp_clear = false;
+    cp_active = true;
+}
+
+void job_checkpoint_finish() {
+    if (jobCheckpointTaskHandle == NULL)
+        return;
+    cp_active = false;
+    cp_clear = true;
+}
+
+err_t job_checkpoint_recover(const char* value, uint8_t client) {
+    if (!job_checkpoint_nvs())
+        return (STATUS_NVS_SET_FAILED);
+    job_checkpoint_t checkpoint;
+    size_t length = sizeof(checkpoint);
+    if (nvs_get_blob(cp_handle, JOB_CHECKPOINT_KEY, &checkpoint, &length) != ESP_OK || length != sizeof(checkpoint) ||
+            checkpoint.magic != JOB_CHECKPOINT_MAGIC || checkpoint.version != JOB_CHECKPOINT_VERSION ||
+            checkpoint.n_axis != N_AXIS) {
+        grbl_send(client, "[MSG:No job to recover]\r\n");
+        return (STATUS_OK);
+    }
+    if (*value == '\0') {
+        char position[N_AXIS * 12];
+        position[0] = '\0';
+        for (uint8_t idx = 0; idx < N_AXIS; idx++) {
+            char axis[12];
+            sprintf(axis, (idx == 0) ? "%4.3f" : ",%4.3f", checkpoint.position[idx]);
+            strcat(position, axis);
+        }
+        grbl_sendf(client, "[JOB:%s|Line:%d|MPos:%s]\r\n", checkpoint.path, checkpoint.line, position);
+        return (STATUS_OK);
+    }
+    if (strcasecmp(value, "CLEAR") == 0) {
+        if (nvs_erase_key(cp_handle, JOB_CHECKPOINT_KEY) == ESP_OK)
+            nvs_commit(cp_handle);
+        return (STATUS_OK);
+    }
+    if (strcasecmp(value, "RUN") != 0)
+        return (STATUS_INVALID_VALUE);
+    uint32_t size, mtime;
+    if (!sd_file_stat(checkpoint.path, &size, &mtime))
+        return (STATUS_SD_FILE_NOT_FOUND);
+    if (size != checkpoint.source_size || mtime != checkpoint.source_mtime) {
+        grbl_sendf(client, "[MSG:%s changed since the checkpoint]\r\n", checkpoint.path);
+        return (STATUS_SD_FAILED_OPEN_FILE);
+    }
+    return (job_index_resume(checkpoint.path, checkpoint.line, client));
+}
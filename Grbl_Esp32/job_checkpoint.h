@@ -0,0 +1,65 @@
+/*
+  job_checkpoint.h - Power loss checkpoints of SD card jobs
+  Part of Grbl_ESP32
+
+  Grbl is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  Grbl is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with Grbl.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifndef job_checkpoint_h
+#define job_checkpoint_h
+
+#include "grbl.h"
+
+/*
+  While a SD job runs, a low priority task saves the file, the job line of the planner block that
+  is executing and the machine position to NVS, at most once every $SD/CheckpointTime seconds
+  and only when the line has moved on. Writing the flash pauses step generation, so the task
+  only saves while the machine is stopped: in a dwell, a spindle or coolant delay, a pause or a
+  completed feed hold. A job that never stops is not checkpointed. NVS spreads its writes over
+  its pages, and the task only reads the planner, so the protocol loop and the planner never wait
+  for the flash. A job that runs to its end clears the checkpoint once the machine stops.
+
+  After a power loss, home the machine and use $SD/Recover to show the checkpoint,
+  $SD/Recover=RUN to continue the job at the saved line with the $SD/Resume machinery, which
+  rebuilds the modal state from the job index, or $SD/Recover=CLEAR to forget it.
+*/
+
+#define JOB_CHECKPOINT_MAGIC 0x50434A47  // "GJCP"
+#define JOB_CHECKPOINT_VERSION 1
+#define JOB_CHECKPOINT_PATH_MAX 96
+#define JOB_CHECKPOINT_POLL_MS 500          // How often the task looks at the running job
+#define JOB_CHECKPOINT_TASK_PRIORITY 1      // Same as the protocol loop
+
+typedef struct {
+    uint32_t magic;
+    uint16_t version;
+    uint8_t n_axis;
+    uint8_t reserved;
+    char path[JOB_CHECKPOINT_PATH_MAX];
+    uint32_t source_size;
+    uint32_t source_mtime;
+    uint32_t line;             // Job line of the block that was executing
+    float position[N_AXIS];    // Machine position in mm
+} job_checkpoint_t;
+
+// Starts checkpointing a SD job. Called when a job is started or resumed.
+void job_checkpoint_start(const char* path);
+
+// Clears the checkpoint of a job that ran to its end.
+void job_checkpoint_finish();
+
+// $SD/Recover. Shows, runs or clears the saved checkpoint.
+err_t job_checkpoint_recover(const char* value, uint8_t client);
+
+#endif
@@ -0,0 +1,197 @@
+/*
+  job_index.cpp - Line index for resuming SD card jobs
+  Part of Grbl_ESP32
+
+  Grbl is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  Grbl is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with Grbl.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "grbl.h"
+
+static File jx_file;               // Index being written
+static bool jx_writing = false;
+static bool jx_appending = false;  // Opened to add to an existing index, so the header stays
+static job_index_header_t jx_header;
+
+static bool job_index_valid(job_index_header_t* header, uint32_t size, uint32_t mtime) {
+    return (header->magic == JOB_INDEX_MAGIC && header->version == JOB_INDEX_VERSION &&
+            header->n_axis == N_AXIS && header->state_size == sizeof(parser_state_t) &&
+            header->stride == JOB_INDEX_STRIDE && header->source_size == size && header->source_mtime == mtime);
+}
+
+static bool job_index_read_header(File* file, job_index_header_t* header, uint32_t size, uint32_t mtime) {
+    if (!*file)
+        return (false);
+    if (file->read((uint8_t*)header, sizeof(job_index_header_t)) != sizeof(job_index_header_t))
+        return (false);
+    return (job_index_valid(header, size, mtime));
+}
+
+// Creates a new index for the file, replacing any old one.
+static bool job_index_create(const char* index_path, uint32_t size, uint32_t mtime) {
+    jx_file = SD.open(index_path, FILE_WRITE);
+    if (!jx_file)
+        return (false);
+    memset(&jx_header, 0, sizeof(jx_header));
+    jx_header.magic = JOB_INDEX_MAGIC;
+    jx_header.version = JOB_INDEX_VERSION;
+    jx_header.n_axis = N_AXIS;
+    jx_header.state_size = sizeof(parser_state_t);
+    jx_header.stride = JOB_INDEX_STRIDE;
+    jx_header.source_size = size;
+    jx_header.source_mtime = mtime;
+    jx_file.write((const uint8_t*)&jx_header, sizeof(jx_header));
+    jx_writing = true;
+    jx_appending = false;
+    return (true);
+}
+
+void job_index_start(const char* path) {
+    uint32_t size, mtime;
+    job_index_finish(false);
+    if (!sd_file_stat(path, &size, &mtime))
+        return;
+    String index_path = String(path) + JOB_INDEX_SUFFIX;
+    File old_index = SD.open(index_path.c_str());
+    job_index_header_t header;
+    bool keep = job_index_read_header(&old_index, &header, size, mtime) && header.complete;
+    if (old_index)
+        old_index.close();
+    if (keep)
+        return; // Already covers the whole file
+    job_index_create(index_path.c_str(), size, mtime);
+}
+
+void job_index_before_line() {
+    if (!jx_writing)
+        return;
+    uint32_t line = sd_get_current_line_number() + 1;
+    if ((line - 1) % JOB_INDEX_STRIDE)
+        return;
+    job_index_entry_t entry;
+    memset(&entry, 0, sizeof(entry));
+    entry.line = line;
+    entry.offset = sd_get_current_offset();
+    memcpy(&entry.state, &gc_state, sizeof(entry.state));
+    jx_file.write((const uint8_t*)&entry, sizeof(entry));
+}
+
+void job_index_finish(bool complete) {
+    if (!jx_writing)
+        return;
+    if (complete && !jx_appending) {
+        jx_header.complete = 1;
+        jx_file.seek(0);
+        jx_file.write((const uint8_t*)&jx_header, sizeof(jx_header));
+    }
+    jx_file.close();
+    jx_writing = false;
+}
+
+err_t job_index_resume(const char* path, uint32_t line, uint8_t client) {
+    uint32_t size, mtime;
+    if (line == 0)
+        return (STATUS_INVALID_VALUE);
+    job_index_finish(false);
+    if (!sd_file_stat(path, &size, &mtime))
+        return (STATUS_SD_FILE_NOT_FOUND);
+    // Find the last checkpoint at or before the line
+    String index_path = String(path) + JOB_INDEX_SUFFIX;
+    job_index_entry_t checkpoint;
+    bool found = false;
+    bool valid = false;
+    uint32_t indexed_line = 0; // Last checkpoint read
+    File index = SD.open(index_path.c_str());
+    job_index_header_t header;
+    if (job_index_read_header(&index, &header, size, mtime)) {
+        valid = true;
+        job_index_entry_t entry;
+        while (index.read((uint8_t*)&entry, sizeof(entry)) == sizeof(entry)) {
+            indexed_line = entry.line;
+            if (entry.line > line)
+                break;
+            memcpy(&checkpoint, &entry, sizeof(checkpoint));
+            found = true;
+        }
+    }
+    if (index)
+        index.close();
+    // Lines parsed past the end of the index are added to it
+    if (!valid)
+        job_index_create(index_path.c_str(), size, mtime);
+    else if (!header.complete && indexed_line < line) {
+        jx_file = SD.open(index_path.c_str(), FILE_APPEND);
+        jx_writing = (bool)jx_file;
+        jx_appending = true;
+    }
+    parser_state_t machine_state;
+    memcpy(&machine_state, &gc_state, sizeof(machine_state));
+    uint32_t start_line = 1;
+    uint32_t offset = 0;
+    if (found) {
+        memcpy(&gc_state, &checkpoint.state, sizeof(gc_state));
+        start_line = checkpoint.line;
+        offset = checkpoint.offset;
+    }
+    if (!openFile(SD, path) || !seekFile(offset)) {
+        closeFile();
+        memcpy(&gc_state, &machine_state, sizeof(gc_state));
+        return (STATUS_SD_FAILED_READ);
+    }
+    sd_current_line_number = start_line - 1;
+    // Bring the modes up to date from the checkpoint to the line before the resume line
+    char fileLine[256];
+    err_t status = STATUS_OK;
+    uint8_t saved_sys_state = sys.state;
+    sys.state = STATE_CHECK_MODE;
+    while (sd_current_line_number + 1 < line) {
+        if (sd_current_line_number + 1 > indexed_line)
+            job_index_before_line();
+        if (!readFileLine(fileLine, 255)) {
+            status = STATUS_SD_FILE_EMPTY; // The file ends before the line
+            break;
+        }
+        status = gc_execute_line(fileLine, client);
+        if (status == STATUS_GCODE_UNSUPPORTED_COMMAND)
+            status = STATUS_OK; // Skipped when the job runs too
+        if (status != STATUS_OK)
+            break;
+        protocol_execute_realtime();
+        if (sys.abort)
+            break;
+    }
+    sys.state = saved_sys_state;
+    job_index_finish(false);
+    if (status != STATUS_OK || sys.abort) {
+        if (status != STATUS_OK)
+            grbl_sendf(client, "[MSG:Resume failed with error:%d at line %d]\r\n", status, sd_current_line_number);
+        closeFile();
+        memcpy(&gc_state, &machine_state, sizeof(gc_state));
+        return (status);
+    }
+    // Continue from where the machine is now, in the work coordinates as they are set now
+    memcpy(gc_state.position, machine_state.position, sizeof(gc_state.position));
+    settings_read_coord_data(gc_state.modal.coord_select, gc_state.coord_system);
+    system_flag_wco_change();
+    gc_state.modal.program_flow = PROGRAM_FLOW_RUNNING;
+    // In laser mode the power goes with the next move
+    if (!laser_mode->get())
+        spindle->spindle_sync(gc_state.modal.spindle, (uint32_t)gc_state.spindle_speed);
+    coolant_sync(gc_state.modal.coolant);
+    grbl_sendf(client, "[MSG:Resuming at line %d from line %d%s]\r\n", line, start_line,
+               (gc_state.modal.distance == DISTANCE_MODE_INCREMENTAL) ? ", incremental mode" : "");
+    SD_client = client;
+    SD_ready_next = true;
+    job_checkpoint_start(path);
+    return (STATUS_OK);
+}
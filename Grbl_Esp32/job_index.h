@@ -0,0 +1,75 @@
+/*
+  job_index.h - Line index for resuming SD card jobs
+  Part of Grbl_ESP32
+
+  Grbl is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  Grbl is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with Grbl.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifndef job_index_h
+#define job_index_h
+
+#include "grbl.h"
+
+/*
+  While a SD job runs from its first line, every JOB_INDEX_STRIDE lines the byte offset of the
+  next line and the parser state before it are appended to <path>.idx. The index is kept when
+  the job stops early, so it covers at least the part that ran.
+
+  $SD/Resume=<line> <path> restarts a job at a line, e.g. after a broken tool. It loads the
+  parser state of the last checkpoint before the line, seeks the file there and only parses the
+  few lines up to the resume line, in check mode, to bring the modes up to date. Lines past the
+  end of the index are parsed the same way and added to it, so opening a job for a resume builds
+  its index too. The work coordinate system is reloaded from the settings, in case it was set
+  again after the tool change. Spindle and coolant are restarted, then the job continues at the
+  resume line from wherever the machine is, so move to a safe height first.
+*/
+
+#define JOB_INDEX_SUFFIX ".idx"
+#define JOB_INDEX_MAGIC 0x58444A47  // "GJDX"
+#define JOB_INDEX_VERSION 1
+
+#ifndef JOB_INDEX_STRIDE
+    #define JOB_INDEX_STRIDE 100  // Lines between checkpoints
+#endif
+
+typedef struct {
+    uint32_t magic;
+    uint16_t version;
+    uint8_t n_axis;
+    uint8_t complete;         // The job ran to its end, so the index covers the whole file
+    uint16_t state_size;      // sizeof(parser_state_t)
+    uint16_t stride;
+    uint32_t source_size;
+    uint32_t source_mtime;
+} job_index_header_t;
+
+typedef struct {
+    uint32_t line;           // First line after the checkpoint
+    uint32_t offset;         // Byte offset of that line
+    parser_state_t state;    // Parser state before it
+} job_index_entry_t;
+
+// Starts indexing a SD job that runs from its first line. Called by $SD/Run.
+void job_index_start(const char* path);
+
+// Adds a checkpoint when one is due. Called by the protocol loop before each line of a text job.
+void job_index_before_line();
+
+// Stops indexing. complete is true when the job reached its end.
+void job_index_finish(bool complete);
+
+// Opens path and continues it at line. Called by $SD/Resume.
+err_t job_index_resume(const char* path, uint32_t line, uint8_t client);
+
+#endif
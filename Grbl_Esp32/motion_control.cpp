@@ -36,6 +36,10 @@ uint8_t ganged_mode = SQUARING_MODE_DUAL;
 
 // this allows kinematics to be used.
 void mc_line_kins(float* target, plan_line_data_t* pl_data, float* position) {
+    if (job_cache_recording) {
+        job_cache_record_line(target, pl_data); // Replayed through here, so before the kinematics
+        return;
+    }
 #ifndef USE_KINEMATICS
     mc_line(target, pl_data);
 #else // else use kinematics
@@ -43,6 +47,128 @@ void mc_line_kins(float* target, plan_line_data_t* pl_data, float* position) {
 #endif
 }
 
+// Lines that were parsed while the planner was full, waiting for a free planner block. This lets
+// the protocol loop keep parsing ahead instead of stalling in mc_line(), and lets a freed block be
+// refilled without parsing another line first. The segment prep task flushes the queue as well,
+// so both ends are only moved with the prep lock held.
+// An entry can also be an arc or a G5 spline. It stays at the tail and hands the planner one chord
+// per free block until its last chord, which ends exactly on the target, so mc_arc() and mc_spline()
+// return as soon as the curve is queued no matter how many chords it has.
+#define MC_QUEUED_LINE 0
+#define MC_QUEUED_ARC 1
+#define MC_QUEUED_SPLINE 2
+
+// Arc chord generator
+typedef struct {
+    uint16_t segments;            // Chords in the arc
+    uint16_t segment;             // Chords planned so far
+    uint8_t  count;               // Chords since the last exact radius vector correction
+    uint8_t  axis_0;
+    uint8_t  axis_1;
+    uint8_t  axis_linear;
+    float    center[2];           // Circle center in the arc plane
+    float    offset[2];           // Radius vector from the center to the arc start
+    float    r[2];                // Radius vector from the center to position
+    float    theta_per_segment;
+    float    linear_per_segment;
+    float    cos_T;
+    float    sin_T;
+} mc_arc_chords_t;
+
+// Spline chord generator, see mc_spline_next()
+typedef struct {
+    float start[N_AXIS];          // Start point of the curve
+    float control[2][2];          // First and second XY control points
+    float d2_start[2];            // B''(t) = d2_start + t * d2_delta
+    float d2_delta[2];
+    float t;                      // Curve parameter at position
+    float tolerance;
+} mc_spline_chords_t;
+
+typedef struct {
+    float target[N_AXIS];
+    plan_line_data_t pl_data;
+    uint8_t generator;            // MC_QUEUED_*
+    float position[N_AXIS];       // End point of the last planned chord. Unused for a line.
+    union {
+        mc_arc_chords_t arc;
+        mc_spline_chords_t spline;
+    };
+} mc_queued_line_t;
+
+static bool mc_arc_plan_chord(mc_queued_line_t* line);
+static bool mc_spline_plan_chord(mc_queued_line_t* line);
+#ifndef USE_KINEMATICS
+static void mc_arc_soft_check(float* target, float* position, float center_axis0, float center_axis1, float radius,
+                              float r_axis0, float r_axis1, float angular_travel, uint8_t axis_0, uint8_t axis_1);
+#endif
+static mc_queued_line_t line_queue[MC_LINE_QUEUE_SIZE];
+static volatile uint8_t line_queue_head;
+static volatile uint8_t line_queue_tail;
+
+static uint8_t mc_line_queue_next(uint8_t index) {
+    if (++index == MC_LINE_QUEUE_SIZE)
+        return (0);
+    return (index);
+}
+
+void mc_line_queue_reset() {
+    st_prep_lock();
+    line_queue_tail = 0;
+    line_queue_head = 0;
+    st_prep_unlock();
+}
+
+uint8_t mc_line_queue_count() {
+    uint8_t head = line_queue_head;
+    uint8_t tail = line_queue_tail;
+    if (head >= tail)
+        return (head - tail);
+    return (MC_LINE_QUEUE_SIZE - (tail - head));
+}
+
+void mc_line_queue_flush() {
+    if (line_queue_head == line_queue_tail)
+        return;
+    // Only plan g-code lines in the states where mc_line() itself could have. In a hold or door
+    // suspend the head block may hold a parking motion, and a reset discards the queue.
+    if (sys.abort || sys.suspend)
+        return;
+    if ((sys.state != STATE_IDLE) && (sys.state != STATE_CYCLE) && (sys.state != STATE_JOG))
+        return;
+    st_prep_lock();
+    while ((line_queue_tail != line_queue_head) && !plan_check_full_buffer()) {
+        mc_queued_line_t* line = &line_queue[line_queue_tail];
+        if (line->generator == MC_QUEUED_ARC && mc_arc_plan_chord(line))
+            continue;  // More chords to come from this arc
+        if (line->generator == MC_QUEUED_SPLINE && mc_spline_plan_chord(line))
+            continue;  // More chords to come from this spline
+        plan_buffer_line(line->target, &line->pl_data);
+        line_queue_tail = mc_line_queue_next(line_queue_tail);
+    }
+    st_prep_unlock();
+}
+
+// Waits for a free line queue entry and returns it. The caller fills it in and then calls
+// mc_line_queue_push(). Returns NULL on a system abort.
+static mc_queued_line_t* mc_line_queue_reserve() {
+    protocol_auto_cycle_start(); // Auto-cycle start when buffer is full.
+    uint32_t profile_start = motion_profile_start();
+    while (mc_line_queue_next(line_queue_head) == line_queue_tail) {
+        protocol_execute_realtime(); // Check for any run-time commands. Flushes the line queue.
+        if (sys.abort)  return (NULL);   // Bail, if system abort.
+        protocol_auto_cycle_start();
+    }
+    motion_profile_stop(PROFILE_LINE_WAIT, profile_start);
+    return (&line_queue[line_queue_head]);
+}
+
+static void mc_line_queue_push() {
+    st_prep_lock(); // The prep task must not see the new head before the line is written
+    line_queue_head = mc_line_queue_next(line_queue_head);
+    st_prep_unlock();
+}
+
 // Execute linear motion in absolute millimeter coordinates. Feed rate given in millimeters/second
 // unless invert_feed_rate is true. Then the feed_rate means that the motion should be completed in
 // (1 minute)/feed_rate time.
@@ -50,7 +176,15 @@ void mc_line_kins(float* target, plan_line_data_t* pl_data, float* position) {
 // segments, must pass through this routine before being passed to the planner. The seperation of
 // mc_line and plan_buffer_line is done primarily to place non-planner-type functions from being
 // in the planner and to let backlash compensation or canned cycle integration simple and direct.
+// NOTE: Chords of queued arcs and splines are the exception. They are planned from the line queue,
+// see mc_arc() and mc_spline().
 void mc_line(float* target, plan_line_data_t* pl_data) {
+    // A job being compiled runs in check mode. Its moves go to the job cache instead.
+    if (job_cache_recording) {
+        job_cache_record_line(target, pl_data);
+        return;
+    }
+    pl_data->job_line = sd_current_line_number;
     // If enabled, check for soft limit violations. Placed here all line motions are picked up
     // from everywhere in Grbl.
     if (soft_limits->get()) {
@@ -72,17 +206,23 @@ void mc_line(float* target, plan_line_data_t* pl_data) {
     // indicates to Grbl what is a backlash compensation motion, so that Grbl executes the move but
     // doesn't update the machine position values. Since the position values used by the g-code
     // parser and planner are separate from the system machine positions, this is doable.
+    // Earlier lines waiting in the line queue must be planned first to keep the order.
+    mc_line_queue_flush();
+    if ((line_queue_head == line_queue_tail) && !plan_check_full_buffer()) {
+        // Plan and queue motion into planner buffer
+        // uint8_t plan_status; // Not used in normal operation.
+        plan_buffer_line(target, pl_data);
+        return;
+    }
     // If the buffer is full: good! That means we are well ahead of the robot.
-    // Remain in this loop until there is room in the buffer.
-    do {
-        protocol_execute_realtime(); // Check for any run-time commands
-        if (sys.abort)  return;   // Bail, if system abort.
-        if (plan_check_full_buffer())  protocol_auto_cycle_start();     // Auto-cycle start when buffer is full.
-        else  break;
-    } while (1);
-    // Plan and queue motion into planner buffer
-    // uint8_t plan_status; // Not used in normal operation.
-    plan_buffer_line(target, pl_data);
+    // Park the line in the line queue and go on parsing. Only wait when the queue is full too.
+    mc_queued_line_t* line = mc_line_queue_reserve();
+    if (line == NULL)
+        return;
+    memcpy(line->target, target, sizeof(line->target));
+    memcpy(&line->pl_data, pl_data, sizeof(plan_line_data_t));
+    line->generator = MC_QUEUED_LINE;
+    mc_line_queue_push();
 }
 
 
@@ -93,20 +233,22 @@ void mc_line(float* target, plan_line_data_t* pl_data) {
 // The arc is approximated by generating a huge number of tiny, linear segments. The chordal tolerance
 // of each segment is configured in the arc_tolerance setting, which is defined to be the maximum normal
 // distance from segment to the circle when the end points both lie on the circle.
+// Without kinematics the chords are not generated here. The arc is put in the line queue and
+// mc_line_queue_flush() pulls its chords as planner blocks free up, so the planner look-ahead still
+// sees every chord junction, but the caller only waits when the line queue itself is full.
 void mc_arc(float* target, plan_line_data_t* pl_data, float* position, float* offset, float radius,
             uint8_t axis_0, uint8_t axis_1, uint8_t axis_linear, uint8_t is_clockwise_arc) {
+    if (job_cache_recording) {
+        job_cache_record_arc(target, pl_data, offset, radius, axis_0, axis_1, axis_linear, is_clockwise_arc);
+        return;
+    }
+    pl_data->job_line = sd_current_line_number; // The chords are planned from the line queue
     float center_axis0 = position[axis_0] + offset[axis_0];
     float center_axis1 = position[axis_1] + offset[axis_1];
     float r_axis0 = -offset[axis_0];  // Radius vector from center to current location
     float r_axis1 = -offset[axis_1];
     float rt_axis0 = target[axis_0] - center_axis0;
     float rt_axis1 = target[axis_1] - center_axis1;
-#ifdef USE_KINEMATICS
-    float previous_position[N_AXIS];
-    uint16_t n;
-    for (n = 0; n < N_AXIS; n++)
-        previous_position[n] = position[n];
-#endif
     // CCW angle between position and target from circle center. Only one atan2() trig computation required.
     float angular_travel = atan2(r_axis0 * rt_axis1 - r_axis1 * rt_axis0, r_axis0 * rt_axis0 + r_axis1 * rt_axis1);
     if (is_clockwise_arc) { // Correct atan2 output per direction
@@ -120,6 +262,30 @@ void mc_arc(float* target, plan_line_data_t* pl_data, float* position, float* of
     // For the intended uses of Grbl, this value shouldn't exceed 2000 for the strictest of cases.
     uint16_t segments = floor(fabs(0.5 * angular_travel * radius) /
                               sqrt(arc_tolerance->get() * (2 * radius - arc_tolerance->get())));
+    // Chords that take less than $GCode/ArcChordTime at the programmed feed are planned faster than
+    // the planner can usefully take them, so the machine would slow down to well below the feed on
+    // small arcs anyway. Use fewer, longer chords there. Slow arcs keep the arc_tolerance density.
+    // The fewer chords are still held to ARC_CHORD_TIME_MAX_ERROR and ARC_MIN_CHORDS_PER_TURN, so a
+    // fast full circle does not fold into a single chord back to its start.
+    float chord_time = arc_chord_time->get() / 60000.0; // msec to min
+    if (segments && (chord_time > 0.0) && (pl_data->feed_rate > 0.0)) {
+        float arc_time;
+        if (pl_data->condition & PL_COND_FLAG_INVERSE_TIME)
+            arc_time = 1.0 / pl_data->feed_rate;
+        else {
+            arc_time = hypot_f(angular_travel * radius, target[axis_linear] - position[axis_linear]) /
+                       pl_data->feed_rate;
+        }
+        float max_segments = arc_time / chord_time;
+        float min_segments = ceil(fabs(angular_travel) * (ARC_MIN_CHORDS_PER_TURN / (2 * M_PI)));
+        float max_error = ARC_CHORD_TIME_MAX_ERROR * arc_tolerance->get();
+        if (max_error < radius)
+            min_segments = MAX(min_segments, ceil(fabs(0.5 * angular_travel * radius) / sqrt(max_error * (2 * radius - max_error))));
+        if (max_segments < min_segments)
+            max_segments = min_segments;
+        if (segments > max_segments)
+            segments = max_segments;
+    }
     if (segments) {
         // Multiply inverse feed_rate to compensate for the fact that this movement is approximated
         // by a number of discrete segments. The inverse feed_rate should be correct for the sum of
@@ -128,33 +294,15 @@ void mc_arc(float* target, plan_line_data_t* pl_data, float* position, float* of
             pl_data->feed_rate *= segments;
             bit_false(pl_data->condition, PL_COND_FLAG_INVERSE_TIME); // Force as feed absolute mode over arc segments.
         }
+    }
+#ifdef USE_KINEMATICS
+    float previous_position[N_AXIS];
+    uint16_t n;
+    for (n = 0; n < N_AXIS; n++)
+        previous_position[n] = position[n];
+    if (segments) {
         float theta_per_segment = angular_travel / segments;
         float linear_per_segment = (target[axis_linear] - position[axis_linear]) / segments;
-        /* Vector rotation by transformation matrix: r is the original vector, r_T is the rotated vector,
-           and phi is the angle of rotation. Solution approach by Jens Geisler.
-               r_T = [cos(phi) -sin(phi);
-                      sin(phi)  cos(phi] * r ;
-
-           For arc generation, the center of the circle is the axis of rotation and the radius vector is
-           defined from the circle center to the initial position. Each line segment is formed by successive
-           vector rotations. Single precision values can accumulate error greater than tool precision in rare
-           cases. So, exact arc path correction is implemented. This approach avoids the problem of too many very
-           expensive trig operations [sin(),cos(),tan()] which can take 100-200 usec each to compute.
-
-           Small angle approximation may be used to reduce computation overhead further. A third-order approximation
-           (second order sin() has too much error) holds for most, if not, all CNC applications. Note that this
-           approximation will begin to accumulate a numerical drift error when theta_per_segment is greater than
-           ~0.25 rad(14 deg) AND the approximation is successively used without correction several dozen times. This
-           scenario is extremely unlikely, since segment lengths and theta_per_segment are automatically generated
-           and scaled by the arc tolerance setting. Only a very large arc tolerance setting, unrealistic for CNC
-           applications, would cause this numerical drift error. However, it is best to set N_ARC_CORRECTION from a
-           low of ~4 to a high of ~20 or so to avoid trig operations while keeping arc generation accurate.
-
-           This approximation also allows mc_arc to immediately insert a line segment into the planner
-           without the initial overhead of computing cos() or sin(). By the time the arc needs to be applied
-           a correction, the planner should have caught up to the lag caused by the initial mc_arc overhead.
-           This is important when there are successive arc motions.
-        */
         // Computes: cos_T = 1 - theta_per_segment^2/2, sin_T = theta_per_segment - theta_per_segment^3/6) in ~52usec
         float cos_T = 2.0 - theta_per_segment * theta_per_segment;
         float sin_T = theta_per_segment * 0.16666667 * (cos_T + 4.0);
@@ -184,18 +332,315 @@ void mc_arc(float* target, plan_line_data_t* pl_data, float* position, float* of
             position[axis_0] = center_axis0 + r_axis0;
             position[axis_1] = center_axis1 + r_axis1;
             position[axis_linear] += linear_per_segment;
-#ifdef USE_KINEMATICS
             mc_line_kins(position, pl_data, previous_position);
             previous_position[axis_0] = position[axis_0];
             previous_position[axis_1] = position[axis_1];
             previous_position[axis_linear] = position[axis_linear];
+            // Bail mid-circle on system abort. Runtime command check already performed by mc_line.
+            if (sys.abort)  return;
+        }
+    }
+    // Ensure last segment arrives at target location.
+    mc_line_kins(target, pl_data, previous_position);
 #else
-            mc_line(position, pl_data);
+    if (segments <= 1) {
+        mc_line(target, pl_data);
+        return;
+    }
+    // mc_line() checks each line against the soft limits, but the chords are planned later from
+    // the queue, where an alarm cannot be raised. The chord ends all lie on the arc, so check the
+    // target and the points where the arc crosses an axis of its plane instead.
+    if (soft_limits->get()) {
+        mc_arc_soft_check(target, position, center_axis0, center_axis1, radius, r_axis0, r_axis1,
+                          angular_travel, axis_0, axis_1);
+        if (sys.abort)  return;
+    }
+    if (sys.state == STATE_CHECK_MODE)  return;
+    mc_line_queue_flush(); // Earlier lines must be planned first to keep the order.
+    mc_queued_line_t* line = mc_line_queue_reserve();
+    if (line == NULL)
+        return;
+    memcpy(line->target, target, sizeof(line->target));
+    memcpy(&line->pl_data, pl_data, sizeof(plan_line_data_t));
+    memcpy(line->position, position, sizeof(line->position));
+    line->generator = MC_QUEUED_ARC;
+    mc_arc_chords_t* arc = &line->arc;
+    arc->segments = segments;
+    arc->segment = 0;
+    arc->count = 0;
+    arc->axis_0 = axis_0;
+    arc->axis_1 = axis_1;
+    arc->axis_linear = axis_linear;
+    arc->center[0] = center_axis0;
+    arc->center[1] = center_axis1;
+    arc->offset[0] = offset[axis_0];
+    arc->offset[1] = offset[axis_1];
+    arc->r[0] = r_axis0;
+    arc->r[1] = r_axis1;
+    arc->theta_per_segment = angular_travel / segments;
+    arc->linear_per_segment = (target[axis_linear] - position[axis_linear]) / segments;
+    // Computes: cos_T = 1 - theta_per_segment^2/2, sin_T = theta_per_segment - theta_per_segment^3/6) in ~52usec
+    arc->cos_T = 2.0 - arc->theta_per_segment * arc->theta_per_segment;
+    arc->sin_T = arc->theta_per_segment * 0.16666667 * (arc->cos_T + 4.0);
+    arc->cos_T *= 0.5;
+    mc_line_queue_push();
+    mc_line_queue_flush(); // Start feeding chords now if the planner has room
 #endif
-            // Bail mid-circle on system abort. Runtime command check already performed by mc_line.
+}
+
+#ifndef USE_KINEMATICS
+// Soft limit check for a queued arc. The target covers the helical axis and any other axes, and
+// the axis crossings inside the swept angle cover the furthest reach of the arc in its plane.
+static void mc_arc_soft_check(float* target, float* position, float center_axis0, float center_axis1, float radius,
+                              float r_axis0, float r_axis1, float angular_travel, uint8_t axis_0, uint8_t axis_1) {
+    limits_soft_check(target);
+    if (sys.abort)  return;
+    float point[N_AXIS];
+    memcpy(point, position, sizeof(point));
+    const float extremes[4][2] = { { 1.0, 0.0 }, { 0.0, 1.0 }, { -1.0, 0.0 }, { 0.0, -1.0 } };
+    for (uint8_t q = 0; q < 4; q++) {
+        // Angle from the start radius vector to this crossing, in the direction of travel
+        float angle = atan2(r_axis0 * extremes[q][1] - r_axis1 * extremes[q][0],
+                            r_axis0 * extremes[q][0] + r_axis1 * extremes[q][1]);
+        if (angular_travel > 0.0) {
+            if (angle < 0.0)  angle += 2 * M_PI;
+            if (angle > angular_travel)  continue;
+        } else {
+            if (angle > 0.0)  angle -= 2 * M_PI;
+            if (angle < angular_travel)  continue;
+        }
+        point[axis_0] = center_axis0 + radius * extremes[q][0];
+        point[axis_1] = center_axis1 + radius * extremes[q][1];
+        limits_soft_check(point);
+        if (sys.abort)  return;
+    }
+}
+#endif
+
+// Plans the next chord of a queued arc from the line queue. Returns false without planning anything
+// once only the last chord is left, which the caller plans to the exact target.
+static bool mc_arc_plan_chord(mc_queued_line_t* line) {
+    mc_arc_chords_t* arc = &line->arc;
+    uint16_t i = arc->segment + 1;
+    if (i >= arc->segments)
+        return (false);
+    arc->segment = i;
+    /* Vector rotation by transformation matrix: r is the original vector, r_T is the rotated vector,
+       and phi is the angle of rotation. Solution approach by Jens Geisler.
+           r_T = [cos(phi) -sin(phi);
+                  sin(phi)  cos(phi] * r ;
+
+       For arc generation, the center of the circle is the axis of rotation and the radius vector is
+       defined from the circle center to the initial position. Each line segment is formed by successive
+       vector rotations. Single precision values can accumulate error greater than tool precision in rare
+       cases. So, exact arc path correction is implemented. This approach avoids the problem of too many very
+       expensive trig operations [sin(),cos(),tan()] which can take 100-200 usec each to compute.
+
+       Small angle approximation may be used to reduce computation overhead further. A third-order approximation
+       (second order sin() has too much error) holds for most, if not, all CNC applications. Note that this
+       approximation will begin to accumulate a numerical drift error when theta_per_segment is greater than
+       ~0.25 rad(14 deg) AND the approximation is successively used without correction several dozen times. This
+       scenario is extremely unlikely, since segment lengths and theta_per_segment are automatically generated
+       and scaled by the arc tolerance setting. Only a very large arc tolerance setting, unrealistic for CNC
+       applications, would cause this numerical drift error. However, it is best to set N_ARC_CORRECTION from a
+       low of ~4 to a high of ~20 or so to avoid trig operations while keeping arc generation accurate.
+    */
+    if (arc->count < N_ARC_CORRECTION) {
+        // Apply vector rotation matrix. ~40 usec
+        float r_axisi = arc->r[0] * arc->sin_T + arc->r[1] * arc->cos_T;
+        arc->r[0] = arc->r[0] * arc->cos_T - arc->r[1] * arc->sin_T;
+        arc->r[1] = r_axisi;
+        arc->count++;
+    } else {
+        // Arc correction to radius vector. Computed only every N_ARC_CORRECTION increments. ~375 usec
+        // Compute exact location by applying transformation matrix from initial radius vector(=-offset).
+        float cos_Ti = cos(i * arc->theta_per_segment);
+        float sin_Ti = sin(i * arc->theta_per_segment);
+        arc->r[0] = -arc->offset[0] * cos_Ti + arc->offset[1] * sin_Ti;
+        arc->r[1] = -arc->offset[0] * sin_Ti - arc->offset[1] * cos_Ti;
+        arc->count = 0;
+    }
+    // Update arc_target location
+    line->position[arc->axis_0] = arc->center[0] + arc->r[0];
+    line->position[arc->axis_1] = arc->center[1] + arc->r[1];
+    line->position[arc->axis_linear] += arc->linear_per_segment;
+    plan_buffer_line(line->position, &line->pl_data);
+    return (true);
+}
+
+
+// Returns the curve parameter at the end of the next spline chord from t. Linear interpolation over
+// a step h is within h^2/8 * max|B''| of the curve, and B'' of a cubic is linear in t, so its largest
+// magnitude on the step is at one end. The step is sized from |B''| at t and shortened once if it
+// is larger at the far end. Chords come out short where the curve bends hard and long where it is
+// nearly straight.
+static float mc_spline_next(float* d2_start, float* d2_delta, float t, float tolerance) {
+    float limit = 8.0 * tolerance;
+    float h = 1.0 - t;
+    float d2 = hypot_f(d2_start[0] + t * d2_delta[0], d2_start[1] + t * d2_delta[1]);
+    if (d2 * h * h > limit)
+        h = sqrt(limit / d2);
+    float d2_end = hypot_f(d2_start[0] + (t + h) * d2_delta[0], d2_start[1] + (t + h) * d2_delta[1]);
+    if (d2_end * h * h > limit)
+        h = sqrt(limit / d2_end);
+    if (h < SPLINE_MIN_STEP)
+        h = SPLINE_MIN_STEP;
+    t += h;
+    if (t > 1.0 - SPLINE_MIN_STEP)
+        return (1.0);   // Take a sliver at the end with this chord
+    return (t);
+}
+
+// Point of the curve at parameter t. The XY plane follows the Bezier curve, any other axis moves
+// in proportion to t from start to target.
+static void mc_spline_point(float* point, float t, float* start, float* target, float (*control)[2]) {
+    float mt = 1.0 - t;
+    float w0 = mt * mt * mt;
+    float w1 = 3.0 * mt * mt * t;
+    float w2 = 3.0 * mt * t * t;
+    float w3 = t * t * t;
+    point[X_AXIS] = w0 * start[X_AXIS] + w1 * control[0][0] + w2 * control[1][0] + w3 * target[X_AXIS];
+    point[Y_AXIS] = w0 * start[Y_AXIS] + w1 * control[0][1] + w2 * control[1][1] + w3 * target[Y_AXIS];
+    for (uint8_t idx = Z_AXIS; idx < N_AXIS; idx++)
+        point[idx] = start[idx] + t * (target[idx] - start[idx]);
+}
+
+// Plans the next chord of a queued spline from the line queue. Returns false without planning
+// anything once only the last chord is left, which the caller plans to the exact target.
+static bool mc_spline_plan_chord(mc_queued_line_t* line) {
+    mc_spline_chords_t* spline = &line->spline;
+    float t = mc_spline_next(spline->d2_start, spline->d2_delta, spline->t, spline->tolerance);
+    if (t >= 1.0)
+        return (false);
+    spline->t = t;
+    mc_spline_point(line->position, t, spline->start, line->target, spline->control);
+    plan_buffer_line(line->position, &line->pl_data);
+    return (true);
+}
+
+#ifndef USE_KINEMATICS
+// Soft limit check for a queued spline. Besides the target, the curve reaches furthest along X or
+// Y where that coordinate turns around, at the roots of its derivative. Each coordinate's derivative
+// is a quadratic in t, so those points are found exactly.
+static void mc_spline_soft_check(float* target, float* start, float (*control)[2]) {
+    limits_soft_check(target);
+    if (sys.abort)  return;
+    float point[N_AXIS];
+    for (uint8_t idx = 0; idx < 2; idx++) {
+        float p0 = (idx == 0) ? start[X_AXIS] : start[Y_AXIS];
+        float p3 = (idx == 0) ? target[X_AXIS] : target[Y_AXIS];
+        // B'(t) / 3 = a * t^2 + b * t + c
+        float d0 = control[0][idx] - p0;
+        float d1 = control[1][idx] - control[0][idx];
+        float d2 = p3 - control[1][idx];
+        float a = d0 - 2.0 * d1 + d2;
+        float b = 2.0 * (d1 - d0);
+        float c = d0;
+        float roots[2];
+        uint8_t n_roots = 0;
+        if (fabs(a) < 1e-9) {
+            if (fabs(b) > 1e-9)
+                roots[n_roots++] = -c / b;
+        } else {
+            float discriminant = b * b - 4.0 * a * c;
+            if (discriminant >= 0.0) {
+                discriminant = sqrt(discriminant);
+                roots[n_roots++] = (-b + discriminant) / (2.0 * a);
+                roots[n_roots++] = (-b - discriminant) / (2.0 * a);
+            }
+        }
+        for (uint8_t i = 0; i < n_roots; i++) {
+            if (roots[i] <= 0.0 || roots[i] >= 1.0)
+                continue;
+            mc_spline_point(point, roots[i], start, target, control);
+            limits_soft_check(point);
             if (sys.abort)  return;
         }
     }
+}
+#endif
+
+// Execute a cubic Bezier spline in the XY plane from position to target. first_control and
+// second_control are the absolute XY control points. Any other axis moves in proportion to the
+// curve parameter, like the linear axis of a helix. The chords stay within arc_tolerance of the
+// curve. See mc_spline_next().
+// Without kinematics the spline is queued like an arc and mc_line_queue_flush() pulls its chords
+// as planner blocks free up, so a long curve does not hold up the parser.
+void mc_spline(float* target, plan_line_data_t* pl_data, float* position, float* first_control, float* second_control) {
+    pl_data->job_line = sd_current_line_number; // The chords are planned from the line queue
+    float control[2][2] = { { first_control[0], first_control[1] }, { second_control[0], second_control[1] } };
+    float d2_start[2];
+    float d2_delta[2];
+    uint8_t idx;
+    for (idx = 0; idx < 2; idx++) {
+        float p0 = (idx == 0) ? position[X_AXIS] : position[Y_AXIS];
+        float p3 = (idx == 0) ? target[X_AXIS] : target[Y_AXIS];
+        float a = p0 - 2.0 * first_control[idx] + second_control[idx];
+        float b = first_control[idx] - 2.0 * second_control[idx] + p3;
+        d2_start[idx] = 6.0 * a;
+        d2_delta[idx] = 6.0 * (b - a);
+    }
+    float tolerance = arc_tolerance->get();
+    float t;
+    if (pl_data->condition & PL_COND_FLAG_INVERSE_TIME) {
+        // Count the chords first. An inverse time feed applies to the whole curve.
+        uint16_t segments = 0;
+        t = 0.0;
+        while (t < 1.0) {
+            t = mc_spline_next(d2_start, d2_delta, t, tolerance);
+            segments++;
+        }
+        pl_data->feed_rate *= segments;
+        bit_false(pl_data->condition, PL_COND_FLAG_INVERSE_TIME); // Force as feed absolute mode over spline segments.
+    }
+#ifndef USE_KINEMATICS
+    // A job being compiled records its chords as lines through mc_line() below.
+    if (!job_cache_recording) {
+        // The chords are planned later from the queue, where an alarm cannot be raised, so check
+        // the whole curve against the soft limits now, as mc_line() would have.
+        if (soft_limits->get()) {
+            mc_spline_soft_check(target, position, control);
+            if (sys.abort)  return;
+        }
+        if (sys.state == STATE_CHECK_MODE)  return;
+        mc_line_queue_flush(); // Earlier lines must be planned first to keep the order.
+        mc_queued_line_t* line = mc_line_queue_reserve();
+        if (line == NULL)
+            return;
+        memcpy(line->target, target, sizeof(line->target));
+        memcpy(&line->pl_data, pl_data, sizeof(plan_line_data_t));
+        memcpy(line->position, position, sizeof(line->position));
+        line->generator = MC_QUEUED_SPLINE;
+        mc_spline_chords_t* spline = &line->spline;
+        memcpy(spline->start, position, sizeof(spline->start));
+        memcpy(spline->control, control, sizeof(spline->control));
+        memcpy(spline->d2_start, d2_start, sizeof(spline->d2_start));
+        memcpy(spline->d2_delta, d2_delta, sizeof(spline->d2_delta));
+        spline->t = 0.0;
+        spline->tolerance = tolerance;
+        mc_line_queue_push();
+        mc_line_queue_flush(); // Start feeding chords now if the planner has room
+        return;
+    }
+#endif
+    float point[N_AXIS];
+#ifdef USE_KINEMATICS
+    float previous_position[N_AXIS];
+    memcpy(previous_position, position, sizeof(previous_position));
+#endif
+    t = mc_spline_next(d2_start, d2_delta, 0.0, tolerance);
+    while (t < 1.0) {
+        mc_spline_point(point, t, position, target, control);
+#ifdef USE_KINEMATICS
+        mc_line_kins(point, pl_data, previous_position);
+        memcpy(previous_position, point, sizeof(previous_position));
+#else
+        mc_line(point, pl_data);
+#endif
+        // Bail mid-curve on system abort. Runtime command check already performed by mc_line.
+        if (sys.abort)  return;
+        t = mc_spline_next(d2_start, d2_delta, t, tolerance);
+    }
     // Ensure last segment arrives at target location.
 #ifdef USE_KINEMATICS
     mc_line_kins(target, pl_data, previous_position);
@@ -340,6 +785,8 @@ void mc_homing_cycle(uint8_t cycle_mask) {
 // NOTE: Upon probe failure, the program will be stopped and placed into ALARM state.
 uint8_t mc_probe_cycle(float* target, plan_line_data_t* pl_data, uint8_t parser_flags) {
     // TODO: Need to update this cycle so it obeys a non-auto cycle start.
+    if (job_cache_recording)
+        job_cache_record_probe();
     if (sys.state == STATE_CHECK_MODE)  return (GC_PROBE_CHECK_MODE);
     // Finish all queued commands and empty planner buffer before starting probe cycle.
     protocol_buffer_synchronize();
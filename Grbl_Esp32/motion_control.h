@@ -42,6 +42,14 @@
 #define HOMING_CYCLE_B    bit(B_AXIS)
 #define HOMING_CYCLE_C    bit(C_AXIS)
 
+// Smallest curve parameter step of a G5 chord. Limits a spline to 1/SPLINE_MIN_STEP chords.
+#define SPLINE_MIN_STEP 0.0005
+
+// Number of parsed lines and arcs that can wait for a free planner block. Must be < 256.
+#ifndef MC_LINE_QUEUE_SIZE
+    #define MC_LINE_QUEUE_SIZE 32
+#endif
+
 
 // Execute linear motion in absolute millimeter coordinates. Feed rate given in millimeters/second
 // unless invert_feed_rate is true. Then the feed_rate means that the motion should be completed in
@@ -49,13 +57,29 @@
 void mc_line_kins(float* target, plan_line_data_t* pl_data, float* position);
 void mc_line(float* target, plan_line_data_t* pl_data);
 
+// Plans lines and arc chords from the line queue while the planner has room. Called by the realtime
+// execution system and the segment prep task.
+void mc_line_queue_flush();
+
+// Discards the line queue. Called with the planner reset.
+void mc_line_queue_reset();
+
+// Returns the number of lines waiting in the line queue.
+uint8_t mc_line_queue_count();
+
 // Execute an arc in offset mode format. position == current xyz, target == target xyz,
 // offset == offset from current xyz, axis_XXX defines circle plane in tool space, axis_linear is
 // the direction of helical travel, radius == circle radius, is_clockwise_arc boolean. Used
-// for vector transformation direction.
+// for vector transformation direction. Without kinematics the arc is queued and its chords are
+// planned on demand, so this returns before the arc is in the planner.
 void mc_arc(float* target, plan_line_data_t* pl_data, float* position, float* offset, float radius,
             uint8_t axis_0, uint8_t axis_1, uint8_t axis_linear, uint8_t is_clockwise_arc);
 
+// Execute a cubic Bezier spline (G5, and G5.1 raised to a cubic) in the XY plane. The control
+// points are absolute XY positions. Flattened into chords within arc_tolerance of the curve. Like an
+// arc, without kinematics the spline is queued and its chords are planned on demand.
+void mc_spline(float* target, plan_line_data_t* pl_data, float* position, float* first_control, float* second_control);
+
 // Dwell for a specific number of seconds
 void mc_dwell(float seconds);
 
@@ -0,0 +1,99 @@
+/*
+  motion_stats.cpp - Throughput counters for the g-code parser, planner and segment generator
+  Part of Grbl_ESP32
+
+  Grbl is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  Grbl is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with Grbl.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "grbl.h"
+
+motion_stats_t motion_stats;  // Zeroed at boot, so the first window starts at power up.
+motion_profile_t motion_profiler;
+
+static const char* const profile_stage_names[N_PROFILE_STAGES] = {
+    "Collapse", "Parse", "LineWait", "Plan", "Recalc", "Prep"
+};
+
+static int64_t profile_window_start;  // Second the rolling window was last cleared
+
+// Moves the rolling window up to the given second, clearing the bins it passes over.
+static void motion_profile_advance(int64_t second) {
+    if (second - motion_profiler.window_second >= PROFILE_WINDOW_SECONDS)
+        memset(motion_profiler.window_lines, 0, sizeof(motion_profiler.window_lines));
+    else {
+        while (motion_profiler.window_second < second)
+            motion_profiler.window_lines[++motion_profiler.window_second % PROFILE_WINDOW_SECONDS] = 0;
+    }
+    motion_profiler.window_second = second;
+}
+
+static void motion_profile_clear() {
+    memset(motion_profiler.stage, 0, sizeof(motion_profiler.stage));
+    memset(motion_profiler.window_lines, 0, sizeof(motion_profiler.window_lines));
+    motion_profiler.window_second = esp_timer_get_time() / 1000000;
+    profile_window_start = motion_profiler.window_second;
+}
+
+void motion_profile_count_line() {
+    motion_profile_advance(esp_timer_get_time() / 1000000);
+    motion_profiler.window_lines[motion_profiler.window_second % PROFILE_WINDOW_SECONDS]++;
+}
+
+void motion_profile_enable(bool on) {
+    if (on) {
+        motion_profiler.enabled = false;  // Keep probes out while the counters are cleared
+        motion_stats_reset();
+    }
+    motion_profiler.enabled = on;
+}
+
+void motion_stats_reset() {
+    memset(&motion_stats, 0, sizeof(motion_stats_t));
+    motion_stats.start_time = esp_timer_get_time();
+    motion_profile_clear();
+}
+
+void report_motion_stats(uint8_t client) {
+    float elapsed = (esp_timer_get_time() - motion_stats.start_time) / 1000000.0;
+    if (elapsed <= 0.0)
+        elapsed = 1.0;  // Avoid a divide by zero right after a reset
+    grbl_sendf(client, "[MSG:Elapsed %.3f s]\r\n", elapsed);
+    grbl_sendf(client, "[MSG:Lines %u %.1f/s]\r\n", motion_stats.lines_parsed, motion_stats.lines_parsed / elapsed);
+    grbl_sendf(client, "[MSG:Blocks %u %.1f/s]\r\n", motion_stats.blocks_planned, motion_stats.blocks_planned / elapsed);
+    grbl_sendf(client, "[MSG:Merged %u]\r\n", motion_stats.lines_merged);
+    grbl_sendf(client, "[MSG:Segments %u %.1f/s]\r\n", motion_stats.segments_prepped, motion_stats.segments_prepped / elapsed);
+    if (!motion_profiler.enabled)
+        return;
+    // Rolling rate over the complete seconds in the window
+    int64_t now = esp_timer_get_time() / 1000000;
+    motion_profile_advance(now);
+    int64_t seconds = now - profile_window_start;
+    if (seconds > PROFILE_WINDOW_SECONDS - 1)
+        seconds = PROFILE_WINDOW_SECONDS - 1;
+    uint32_t lines = 0;
+    for (int64_t s = now - seconds; s < now; s++)
+        lines += motion_profiler.window_lines[s % PROFILE_WINDOW_SECONDS];
+    grbl_sendf(client, "[MSG:Rolling %.1f lines/s over %d s]\r\n", seconds ? (float)lines / seconds : 0.0, (int)seconds);
+    float cycles_per_us = ESP.getCpuFreqMHz();
+    for (uint8_t i = 0; i < N_PROFILE_STAGES; i++) {
+        profile_stage_t stage = motion_profiler.stage[i];  // Copy, the stages keep running
+        float total_us = stage.total_cycles / cycles_per_us;
+        grbl_sendf(client, "[MSG:%s %u avg %.1fus max %.1fus load %.1f%%]\r\n",
+                   profile_stage_names[i],
+                   stage.calls,
+                   stage.calls ? total_us / stage.calls : 0.0,
+                   stage.max_cycles / cycles_per_us,
+                   total_us / (elapsed * 10000.0));
+    }
+}
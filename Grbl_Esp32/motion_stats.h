@@ -0,0 +1,99 @@
+/*
+  motion_stats.h - Throughput counters for the g-code parser, planner and segment generator
+  Part of Grbl_ESP32
+
+  Grbl is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  Grbl is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with Grbl.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifndef motion_stats_h
+#define motion_stats_h
+
+#include "grbl.h"
+
+// Running totals for the motion pipeline. Each counter is a single increment in its stage,
+// so they are always compiled in. Rates are computed against start_time when reported, which
+// gives a repeatable lines/s, blocks/s and segments/s figure for a known job without a logic
+// analyzer. Reset before a job with $Motion/Stats=RST and read back with $Motion/Stats.
+typedef struct {
+    uint32_t lines_parsed;      // Lines handed to gc_execute_line()
+    uint32_t blocks_planned;    // Blocks accepted by plan_buffer_line()
+    uint32_t lines_merged;      // G64 lines folded into an already queued block
+    uint32_t segments_prepped;  // Step segments generated by st_prep_buffer()
+    int64_t  start_time;        // esp_timer_get_time() at the last reset (usec)
+} motion_stats_t;
+extern motion_stats_t motion_stats;
+
+// Stage profiler. Always compiled, but off until $Motion/Stats=ON, so a disabled probe costs one
+// load and a branch. When on, each stage is timed with the CPU cycle counter. Stage times are
+// inclusive and wall clock: the parse time contains the collapse, line queue wait and planning
+// done for that line, and any stage can be stretched by higher priority tasks preempting it. The
+// load column is time in the stage per second of elapsed time, which is what shows where a slow
+// job is spending its time.
+#define PROFILE_COLLAPSE     0  // collapseGCode()
+#define PROFILE_PARSE        1  // gc_execute_line()
+#define PROFILE_LINE_WAIT    2  // mc_line() waiting for line queue space
+#define PROFILE_PLAN         3  // plan_buffer_line()
+#define PROFILE_RECALCULATE  4  // planner_recalculate()
+#define PROFILE_PREP         5  // st_prep_buffer()
+#define N_PROFILE_STAGES     6
+
+// The rolling line rate is counted in one second bins over this many seconds, including the
+// current partial one, which is left out of the rate.
+#define PROFILE_WINDOW_SECONDS 6
+
+typedef struct {
+    uint32_t calls;
+    uint32_t max_cycles;
+    uint64_t total_cycles;
+} profile_stage_t;
+
+typedef struct {
+    volatile bool enabled;
+    profile_stage_t stage[N_PROFILE_STAGES];
+    uint32_t window_lines[PROFILE_WINDOW_SECONDS];
+    int64_t  window_second;     // Second of the newest bin
+} motion_profile_t;
+extern motion_profile_t motion_profiler;
+
+// Returns the start mark for motion_profile_stop(), or 0 if the profiler is off.
+inline uint32_t motion_profile_start() {
+    return motion_profiler.enabled ? xthal_get_ccount() : 0;
+}
+
+// Adds the time since start to a stage. Does nothing for a start taken while the profiler was off.
+inline void motion_profile_stop(uint8_t stage, uint32_t start) {
+    if (start == 0 || !motion_profiler.enabled)
+        return;
+    uint32_t cycles = xthal_get_ccount() - start;
+    profile_stage_t* s = &motion_profiler.stage[stage];
+    s->calls++;
+    s->total_cycles += cycles;
+    if (cycles > s->max_cycles)
+        s->max_cycles = cycles;
+}
+
+// Counts a parsed line in the rolling window. Called by gc_execute_line() when profiling.
+void motion_profile_count_line();
+
+// Clears all counters and restarts the rate measurement window.
+void motion_stats_reset();
+
+// Turns the stage profiler on or off. Turning it on clears the stage times.
+void motion_profile_enable(bool on);
+
+// Prints the counters and their average rates since the last reset, and the stage times
+// and rolling line rate if the profiler is on.
+void report_motion_stats(uint8_t client);
+
+#endif
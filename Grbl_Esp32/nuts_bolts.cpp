@@ -149,6 +149,17 @@ float limit_acceleration_by_axis_maximum(float* unit_vec) {
     return (limit_value * SEC_PER_MIN_SQ);
 }
 
+// Same as above for the S-curve jerk limit, stored in mm/sec^3 and used in mm/min^3.
+float limit_jerk_by_axis_maximum(float* unit_vec) {
+    uint8_t idx;
+    float limit_value = SOME_LARGE_VALUE;
+    for (idx = 0; idx < N_AXIS; idx++) {
+        if (unit_vec[idx] != 0)    // Avoid divide by zero.
+            limit_value = MIN(limit_value, fabs(axis_settings[idx]->jerk->get() / unit_vec[idx]));
+    }
+    return (limit_value * SEC_PER_MIN_CU);
+}
+
 float limit_rate_by_axis_maximum(float* unit_vec) {
     uint8_t idx;
     float limit_value = SOME_LARGE_VALUE;
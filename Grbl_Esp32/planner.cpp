@@ -25,13 +25,15 @@
 
 #include "grbl.h"
 #include <stdlib.h> // PSoc Required for labs
+#include <esp_heap_caps.h>
 
 
-static plan_block_t block_buffer[BLOCK_BUFFER_SIZE];  // A ring buffer for motion instructions
-static uint8_t block_buffer_tail;     // Index of the block to process now
-static uint8_t block_buffer_head;     // Index of the next block to be pushed
-static uint8_t next_buffer_head;      // Index of the next buffer head
-static uint8_t block_buffer_planned;  // Index of the optimally planned block
+static plan_block_t* block_buffer;     // A ring buffer for motion instructions. Allocated by plan_init().
+static uint16_t block_buffer_size;     // Number of blocks in the ring buffer
+static uint16_t block_buffer_tail;     // Index of the block to process now
+static uint16_t block_buffer_head;     // Index of the next block to be pushed
+static uint16_t next_buffer_head;      // Index of the next buffer head
+static uint16_t block_buffer_planned;  // Index of the optimally planned block
 
 // Define planner variables
 typedef struct {
@@ -40,21 +42,32 @@ typedef struct {
     // i.e. arcs, canned cycles, and backlash compensation.
     float previous_unit_vec[N_AXIS];   // Unit vector of previous path line segment
     float previous_nominal_speed;  // Nominal speed of previous path line segment
+    float previous_target[N_AXIS];     // Target of previous path line segment in mm. Valid if target_valid.
+    bool target_valid;                 // Cleared when the planner position is synced to the machine.
+
+    // G64 merge state of the last queued block, saved as it was when the block was added.
+    bool merge_valid;                          // Last block can absorb following lines
+    uint8_t merge_lines;                       // Lines already merged into the last block
+    float merge_start[N_AXIS];                 // Start of the last block in mm
+    int32_t merge_position[N_AXIS];            // Start of the last block in steps
+    float merge_previous_unit_vec[N_AXIS];     // Unit vector of the block before it
+    float merge_previous_nominal_speed;        // Nominal speed of the block before it
+    float merge_points[PLAN_MERGE_MAX_LINES][N_AXIS]; // Interior points the last block now skips
 } planner_t;
 static planner_t pl;
 
 
 // Returns the index of the next block in the ring buffer. Also called by stepper segment buffer.
-uint8_t plan_next_block_index(uint8_t block_index) {
+uint16_t plan_next_block_index(uint16_t block_index) {
     block_index++;
-    if (block_index == BLOCK_BUFFER_SIZE)  block_index = 0;
+    if (block_index == block_buffer_size)  block_index = 0;
     return (block_index);
 }
 
 
 // Returns the index of the previous block in the ring buffer
-static uint8_t plan_prev_block_index(uint8_t block_index) {
-    if (block_index == 0)  block_index = BLOCK_BUFFER_SIZE;
+static uint16_t plan_prev_block_index(uint16_t block_index) {
+    if (block_index == 0)  block_index = block_buffer_size;
     block_index--;
     return (block_index);
 }
@@ -124,10 +137,15 @@ static uint8_t plan_prev_block_index(uint8_t block_index) {
   to compute an optimal plan, so select carefully. The Arduino 328p memory is already maxed out, but future
   ARM versions should have enough memory and speed for look-ahead blocks numbering up to a hundred or more.
 
+  NOTE: On the ESP32 the buffer size is set at boot by $Planner/Blocks. A deep buffer does not make each
+  new block more expensive to plan. The reverse pass stops at block_buffer_planned and the forward pass
+  pushes it toward the head, so a steady stream of short blocks is recomputed only back to the last
+  junction that is already optimal, not over the whole buffer.
+
 */
-static void planner_recalculate() {
+static void planner_recalculate_blocks() {
     // Initialize block index to the last block in the planner buffer.
-    uint8_t block_index = plan_prev_block_index(block_buffer_head);
+    uint16_t block_index = plan_prev_block_index(block_buffer_head);
     // Bail. Can't do anything with one only one plan-able block.
     if (block_index == block_buffer_planned)  return;
     // Reverse Pass: Coarsely maximize all possible deceleration curves back-planning from the last
@@ -186,24 +204,63 @@ static void planner_recalculate() {
     }
 }
 
+static void planner_recalculate() {
+    uint32_t profile_start = motion_profile_start();
+    planner_recalculate_blocks();
+    motion_profile_stop(PROFILE_RECALCULATE, profile_start);
+}
+
+
+void plan_init() {
+    // Try internal RAM first since the planner walks these blocks often. Fall back to PSRAM for very
+    // deep buffers, then to the compiled default and the minimum if neither heap can satisfy the
+    // request. Without even the minimum there is nothing to run, so stop there.
+    uint16_t size = planner_blocks->get();
+    size_t bytes = size * sizeof(plan_block_t);
+    block_buffer = (plan_block_t*)heap_caps_malloc(bytes, MALLOC_CAP_INTERNAL | MALLOC_CAP_8BIT);
+    if (block_buffer == NULL)
+        block_buffer = (plan_block_t*)heap_caps_malloc(bytes, MALLOC_CAP_SPIRAM | MALLOC_CAP_8BIT);
+    if (block_buffer == NULL && size > BLOCK_BUFFER_SIZE) {
+        grbl_msg_sendf(CLIENT_SERIAL, MSG_LEVEL_ERROR, "Planner: %d blocks unavailable, using %d", size, BLOCK_BUFFER_SIZE);
+        size = BLOCK_BUFFER_SIZE;
+        block_buffer = (plan_block_t*)malloc(size * sizeof(plan_block_t));
+    }
+    if (block_buffer == NULL) {
+        grbl_msg_sendf(CLIENT_SERIAL, MSG_LEVEL_ERROR, "Planner: %d blocks unavailable, using %d", size, MIN_BLOCK_BUFFER_SIZE);
+        size = MIN_BLOCK_BUFFER_SIZE;
+        block_buffer = (plan_block_t*)malloc(size * sizeof(plan_block_t));
+    }
+    if (block_buffer == NULL) {
+        grbl_msg_sendf(CLIENT_SERIAL, MSG_LEVEL_ERROR, "Planner: out of memory, halted");
+        while (true)
+            delay(1000);
+    }
+    block_buffer_size = size;
+    grbl_msg_sendf(CLIENT_SERIAL, MSG_LEVEL_INFO, "Planner blocks %d", block_buffer_size);
+}
+
 
 void plan_reset() {
+    st_prep_lock();
     memset(&pl, 0, sizeof(planner_t)); // Clear planner struct
     plan_reset_buffer();
+    st_prep_unlock();
 }
 
 
 void plan_reset_buffer() {
+    st_prep_lock();
     block_buffer_tail = 0;
     block_buffer_head = 0; // Empty = tail
     next_buffer_head = 1; // plan_next_block_index(block_buffer_head)
     block_buffer_planned = 0; // = block_buffer_tail;
+    st_prep_unlock();
 }
 
 
 void plan_discard_current_block() {
     if (block_buffer_head != block_buffer_tail) { // Discard non-empty buffer.
-        uint8_t block_index = plan_next_block_index(block_buffer_tail);
+        uint16_t block_index = plan_next_block_index(block_buffer_tail);
         // Push block_buffer_planned pointer, if encountered.
         if (block_buffer_tail == block_buffer_planned)  block_buffer_planned = block_index;
         block_buffer_tail = block_index;
@@ -225,7 +282,7 @@ plan_block_t* plan_get_current_block() {
 
 
 float plan_get_exec_block_exit_speed_sqr() {
-    uint8_t block_index = plan_next_block_index(block_buffer_tail);
+    uint16_t block_index = plan_next_block_index(block_buffer_tail);
     if (block_index == block_buffer_head)  return (0.0);
     return (block_buffer[block_index].entry_speed_sqr);
 }
@@ -264,7 +321,8 @@ static void plan_compute_profile_parameters(plan_block_t* block, float nominal_s
 
 // Re-calculates buffered motions profile parameters upon a motion-based override change.
 void plan_update_velocity_profile_parameters() {
-    uint8_t block_index = block_buffer_tail;
+    st_prep_lock();
+    uint16_t block_index = block_buffer_tail;
     plan_block_t* block;
     float nominal_speed;
     float prev_nominal_speed = SOME_LARGE_VALUE; // Set high for first block nominal speed calculation.
@@ -276,33 +334,19 @@ void plan_update_velocity_profile_parameters() {
         block_index = plan_next_block_index(block_index);
     }
     pl.previous_nominal_speed = prev_nominal_speed; // Update prev nominal speed for next incoming block.
+    pl.merge_valid = false; // Saved nominal speeds are stale. Start merging again from the next block.
+    st_prep_unlock();
 }
 
 
-uint8_t plan_buffer_line(float* target, plan_line_data_t* pl_data) {
-    // Prepare and initialize new block. Copy relevant pl_data for block execution.
-    plan_block_t* block = &block_buffer[block_buffer_head];
-    memset(block, 0, sizeof(plan_block_t)); // Zero all block values.
-    block->condition = pl_data->condition;
-    block->spindle_speed = pl_data->spindle_speed;
-
-#ifdef USE_LINE_NUMBERS
-    block->line_number = pl_data->line_number;
-#endif
-    // Compute and store initial move distance data.
-    int32_t target_steps[N_AXIS], position_steps[N_AXIS];
-    float unit_vec[N_AXIS], delta_mm;
+// Computes the step counts, direction bits and length of a block moving from position_steps[] to
+// target[]. Also returns the target in absolute steps and the unit vector of the move.
+static void plan_compute_block_geometry(plan_block_t* block, int32_t* position_steps, float* target,
+                                        int32_t* target_steps, float* unit_vec) {
+    float delta_mm;
     uint8_t idx;
-    // Copy position data based on type of motion being planned.
-    if (block->condition & PL_COND_FLAG_SYSTEM_MOTION) {
-#ifdef COREXY
-        position_steps[X_AXIS] = system_convert_corexy_to_x_axis_steps(sys_position);
-        position_steps[Y_AXIS] = system_convert_corexy_to_y_axis_steps(sys_position);
-        position_steps[Z_AXIS] = sys_position[Z_AXIS];
-#else
-        memcpy(position_steps, sys_position, sizeof(sys_position));
-#endif
-    } else  memcpy(position_steps, pl.position, sizeof(pl.position));
+    block->step_event_count = 0;
+    block->direction_bits = 0;
 #ifdef COREXY
     target_steps[A_MOTOR] = lround(target[A_MOTOR] * axis_settings[A_MOTOR]->steps_per_mm->get());
     target_steps[B_MOTOR] = lround(target[B_MOTOR] * axis_settings[B_MOTOR]->steps_per_mm->get());
@@ -335,15 +379,178 @@ uint8_t plan_buffer_line(float* target, plan_line_data_t* pl_data) {
         // Set direction bits. Bit enabled always means direction is negative.
         if (delta_mm < 0.0)  block->direction_bits |= get_direction_pin_mask(idx);
     }
-    // Bail if this is a zero-length block. Highly unlikely to occur.
-    if (block->step_event_count == 0)  return (PLAN_EMPTY_BLOCK);
+    if (block->step_event_count == 0)  return;
     // Calculate the unit vector of the line move and the block maximum feed rate and acceleration scaled
     // down such that no individual axes maximum values are exceeded with respect to the line direction.
     // NOTE: This calculation assumes all axes are orthogonal (Cartesian) and works with ABC-axes,
     // if they are also orthogonal/independent. Operates on the absolute value of the unit vector.
     block->millimeters = convert_delta_vector_to_unit_vector(unit_vec);
     block->acceleration = limit_acceleration_by_axis_maximum(unit_vec);
+    block->jerk = limit_jerk_by_axis_maximum(unit_vec);
+    // An S-curve ramp takes as long as the linear ramp the planner lays out, so it peaks above the
+    // planned acceleration. Plan below the axis limits to leave it room up to them.
+    if (motion_profile->get() == MOTION_PROFILE_SCURVE) {
+        block->peak_acceleration = block->acceleration;
+        block->acceleration *= SCURVE_PLANNED_ACCELERATION;
+    } else
+        block->peak_acceleration = 0.0;
     block->rapid_rate = limit_rate_by_axis_maximum(unit_vec);
+}
+
+
+// Computes the maximum allowable entry speed (sqr) at the junction between two path line segments.
+//
+// Let a circle be tangent to both previous and current path line segments, where the junction
+// deviation is defined as the distance from the junction to the closest edge of the circle,
+// colinear with the circle center. The circular segment joining the two paths represents the
+// path of centripetal acceleration. Solve for max velocity based on max acceleration about the
+// radius of the circle, defined indirectly by junction deviation. This may be also viewed as
+// path width or max_jerk in the previous Grbl version. This approach does not actually deviate
+// from path, but used as a robust way to compute cornering speeds, as it takes into account the
+// nonlinearities of both the junction angle and junction velocity.
+//
+// NOTE: If the junction deviation value is finite, Grbl executes the motions in an exact path
+// mode (G61). If the junction deviation value is zero, Grbl will execute the motion in an exact
+// stop mode (G61.1) manner. G64 P does not change this: its tolerance only bounds how far
+// plan_merge_line() may fold nearly collinear lines together. Corners are still driven through
+// their vertex, so the cornering speed stays limited by the junction deviation alone.
+static float plan_compute_junction_speed_sqr(float* previous_unit_vec, float* unit_vec) {
+    float junction_unit_vec[N_AXIS];
+    float junction_cos_theta = 0.0;
+    uint8_t idx;
+    for (idx = 0; idx < N_AXIS; idx++) {
+        junction_cos_theta -= previous_unit_vec[idx] * unit_vec[idx];
+        junction_unit_vec[idx] = unit_vec[idx] - previous_unit_vec[idx];
+    }
+    // NOTE: Computed without any expensive trig, sin() or acos(), by trig half angle identity of cos(theta).
+    if (junction_cos_theta > 0.999999) {
+        //  For a 0 degree acute junction, just set minimum junction speed.
+        return (MINIMUM_JUNCTION_SPEED * MINIMUM_JUNCTION_SPEED);
+    }
+    if (junction_cos_theta < -0.999999) {
+        // Junction is a straight line or 180 degrees. Junction speed is infinite.
+        return (SOME_LARGE_VALUE);
+    }
+    convert_delta_vector_to_unit_vector(junction_unit_vec);
+    float junction_acceleration = limit_acceleration_by_axis_maximum(junction_unit_vec);
+    float sin_theta_d2 = sqrt(0.5 * (1.0 - junction_cos_theta)); // Trig half angle identity. Always positive.
+    return (MAX(MINIMUM_JUNCTION_SPEED * MINIMUM_JUNCTION_SPEED,
+                (junction_acceleration * junction_deviation->get() * sin_theta_d2) / (1.0 - sin_theta_d2)));
+}
+
+
+// Tries to extend the last queued block to the new target instead of adding a block. Used in G64
+// mode to fold runs of short, nearly collinear CAM segments into one longer block. The merge is
+// only done when every point the merged block skips stays within the path tolerance of the new
+// chord, the block is not yet executing, and the longer block can keep the entry speed it was
+// already planned with. That last check means no block ahead of it is ever replanned slower.
+// Returns true if the line was absorbed.
+static bool plan_merge_line(float* target, plan_line_data_t* pl_data) {
+    float tolerance = pl_data->path_tolerance;
+    if (!pl.merge_valid || (tolerance <= 0.0))  return (false);
+    if (pl_data->condition & (PL_COND_FLAG_SYSTEM_MOTION | PL_COND_FLAG_INVERSE_TIME))  return (false);
+    if (pl.merge_lines >= PLAN_MERGE_MAX_LINES)  return (false);
+    if (block_buffer_head == block_buffer_tail)  return (false); // Buffer empty
+    uint16_t block_index = plan_prev_block_index(block_buffer_head);
+    if (block_index == block_buffer_tail)  return (false); // Block may already be executing
+    plan_block_t* block = &block_buffer[block_index];
+    if ((block->condition != pl_data->condition) || (block->spindle_speed != pl_data->spindle_speed))  return (false);
+    if (!(block->condition & PL_COND_FLAG_RAPID_MOTION) && (block->programmed_rate != pl_data->feed_rate))  return (false);
+    // Check the skipped points against the chord from the block start to the new target.
+    float chord[N_AXIS];
+    float chord_sqr = 0.0;
+    uint8_t idx, point;
+    for (idx = 0; idx < N_AXIS; idx++) {
+        chord[idx] = target[idx] - pl.merge_start[idx];
+        chord_sqr += chord[idx] * chord[idx];
+    }
+    if (chord_sqr == 0.0)  return (false);
+    float tolerance_sqr = tolerance * tolerance;
+    for (point = 0; point <= pl.merge_lines; point++) {
+        float* vertex = (point < pl.merge_lines) ? pl.merge_points[point] : pl.previous_target;
+        float along = 0.0, offset_sqr = 0.0;
+        for (idx = 0; idx < N_AXIS; idx++) {
+            float delta = vertex[idx] - pl.merge_start[idx];
+            along += delta * chord[idx];
+            offset_sqr += delta * delta;
+        }
+        if ((along < 0.0) || (along > chord_sqr))  return (false); // Path doubles back. Not collinear.
+        offset_sqr -= along * along / chord_sqr;
+        if (offset_sqr > tolerance_sqr)  return (false);
+    }
+    // Build the merged block from the saved block start and verify it can keep its planned entry speed.
+    plan_block_t merged = *block;
+    int32_t target_steps[N_AXIS];
+    float unit_vec[N_AXIS];
+    plan_compute_block_geometry(&merged, pl.merge_position, target, target_steps, unit_vec);
+    if (merged.step_event_count == 0)  return (false);
+    if (merged.condition & PL_COND_FLAG_RAPID_MOTION)  merged.programmed_rate = merged.rapid_rate;
+    if (block->max_junction_speed_sqr > 0.0) { // Zero means this block was planned to start from rest.
+        merged.max_junction_speed_sqr = plan_compute_junction_speed_sqr(pl.merge_previous_unit_vec, unit_vec);
+    }
+    float nominal_speed = plan_compute_profile_nominal_speed(&merged);
+    plan_compute_profile_parameters(&merged, nominal_speed, pl.merge_previous_nominal_speed);
+    if ((merged.max_entry_speed_sqr < block->entry_speed_sqr) ||
+            (2 * merged.acceleration * merged.millimeters < block->entry_speed_sqr))
+        return (false);
+#ifdef USE_LINE_NUMBERS
+    merged.line_number = pl_data->line_number;
+#endif
+    *block = merged;
+    memcpy(pl.merge_points[pl.merge_lines++], pl.previous_target, sizeof(pl.previous_target));
+    memcpy(pl.previous_target, target, sizeof(pl.previous_target));
+    memcpy(pl.previous_unit_vec, unit_vec, sizeof(unit_vec));
+    memcpy(pl.position, target_steps, sizeof(target_steps));
+    pl.previous_nominal_speed = nominal_speed;
+    // The block is no longer known to be optimal. Step the planned pointer back so it is replanned.
+    if (block_buffer_planned == block_index)  block_buffer_planned = plan_prev_block_index(block_index);
+    planner_recalculate();
+    motion_stats.lines_merged++;
+    return (true);
+}
+
+
+static uint8_t plan_add_line(float* target, plan_line_data_t* pl_data);
+
+uint8_t plan_buffer_line(float* target, plan_line_data_t* pl_data) {
+    // The segment prep task may be reading the blocks this replans.
+    st_prep_lock();
+    uint32_t profile_start = motion_profile_start();
+    uint8_t status = plan_add_line(target, pl_data);
+    motion_profile_stop(PROFILE_PLAN, profile_start);
+    st_prep_unlock();
+    return (status);
+}
+
+static uint8_t plan_add_line(float* target, plan_line_data_t* pl_data) {
+    // In G64 mode, first try to fold this line into the last queued block.
+    if (plan_merge_line(target, pl_data))  return (PLAN_OK);
+    // Prepare and initialize new block. Copy relevant pl_data for block execution.
+    plan_block_t* block = &block_buffer[block_buffer_head];
+    memset(block, 0, sizeof(plan_block_t)); // Zero all block values.
+    block->condition = pl_data->condition;
+    block->spindle_speed = pl_data->spindle_speed;
+
+#ifdef USE_LINE_NUMBERS
+    block->line_number = pl_data->line_number;
+#endif
+    block->job_line = pl_data->job_line;
+    // Compute and store initial move distance data.
+    int32_t target_steps[N_AXIS], position_steps[N_AXIS];
+    float unit_vec[N_AXIS];
+    // Copy position data based on type of motion being planned.
+    if (block->condition & PL_COND_FLAG_SYSTEM_MOTION) {
+#ifdef COREXY
+        position_steps[X_AXIS] = system_convert_corexy_to_x_axis_steps(sys_position);
+        position_steps[Y_AXIS] = system_convert_corexy_to_y_axis_steps(sys_position);
+        position_steps[Z_AXIS] = sys_position[Z_AXIS];
+#else
+        memcpy(position_steps, sys_position, sizeof(sys_position));
+#endif
+    } else  memcpy(position_steps, pl.position, sizeof(pl.position));
+    plan_compute_block_geometry(block, position_steps, target, target_steps, unit_vec);
+    // Bail if this is a zero-length block. Highly unlikely to occur.
+    if (block->step_event_count == 0)  return (PLAN_EMPTY_BLOCK);
     // Store programmed rate.
     if (block->condition & PL_COND_FLAG_RAPID_MOTION)  block->programmed_rate = block->rapid_rate;
     else {
@@ -358,51 +565,23 @@ uint8_t plan_buffer_line(float* target, plan_line_data_t* pl_data) {
         block->max_junction_speed_sqr = 0.0; // Starting from rest. Enforce start from zero velocity.
     } else {
         // Compute maximum allowable entry speed at junction by centripetal acceleration approximation.
-        // Let a circle be tangent to both previous and current path line segments, where the junction
-        // deviation is defined as the distance from the junction to the closest edge of the circle,
-        // colinear with the circle center. The circular segment joining the two paths represents the
-        // path of centripetal acceleration. Solve for max velocity based on max acceleration about the
-        // radius of the circle, defined indirectly by junction deviation. This may be also viewed as
-        // path width or max_jerk in the previous Grbl version. This approach does not actually deviate
-        // from path, but used as a robust way to compute cornering speeds, as it takes into account the
-        // nonlinearities of both the junction angle and junction velocity.
-        //
-        // NOTE: If the junction deviation value is finite, Grbl executes the motions in an exact path
-        // mode (G61). If the junction deviation value is zero, Grbl will execute the motion in an exact
-        // stop mode (G61.1) manner. In the future, if continuous mode (G64) is desired, the math here
-        // is exactly the same. Instead of motioning all the way to junction point, the machine will
-        // just follow the arc circle defined here. The Arduino doesn't have the CPU cycles to perform
-        // a continuous mode path, but ARM-based microcontrollers most certainly do.
-        //
         // NOTE: The max junction speed is a fixed value, since machine acceleration limits cannot be
         // changed dynamically during operation nor can the line move geometry. This must be kept in
         // memory in the event of a feedrate override changing the nominal speeds of blocks, which can
         // change the overall maximum entry speed conditions of all blocks.
-        float junction_unit_vec[N_AXIS];
-        float junction_cos_theta = 0.0;
-        for (idx = 0; idx < N_AXIS; idx++) {
-            junction_cos_theta -= pl.previous_unit_vec[idx] * unit_vec[idx];
-            junction_unit_vec[idx] = unit_vec[idx] - pl.previous_unit_vec[idx];
-        }
-        // NOTE: Computed without any expensive trig, sin() or acos(), by trig half angle identity of cos(theta).
-        if (junction_cos_theta > 0.999999) {
-            //  For a 0 degree acute junction, just set minimum junction speed.
-            block->max_junction_speed_sqr = MINIMUM_JUNCTION_SPEED * MINIMUM_JUNCTION_SPEED;
-        } else {
-            if (junction_cos_theta < -0.999999) {
-                // Junction is a straight line or 180 degrees. Junction speed is infinite.
-                block->max_junction_speed_sqr = SOME_LARGE_VALUE;
-            } else {
-                convert_delta_vector_to_unit_vector(junction_unit_vec);
-                float junction_acceleration = limit_acceleration_by_axis_maximum(junction_unit_vec);
-                float sin_theta_d2 = sqrt(0.5 * (1.0 - junction_cos_theta)); // Trig half angle identity. Always positive.
-                block->max_junction_speed_sqr = MAX(MINIMUM_JUNCTION_SPEED * MINIMUM_JUNCTION_SPEED,
-                                                    (junction_acceleration * junction_deviation->get() * sin_theta_d2) / (1.0 - sin_theta_d2));
-            }
-        }
+        block->max_junction_speed_sqr = plan_compute_junction_speed_sqr(pl.previous_unit_vec, unit_vec);
     }
     // Block system motion from updating this data to ensure next g-code motion is computed correctly.
     if (!(block->condition & PL_COND_FLAG_SYSTEM_MOTION)) {
+        // Save the block start, so following G64 lines can be merged into this block.
+        pl.merge_valid = pl.target_valid && !(block->condition & PL_COND_FLAG_INVERSE_TIME);
+        pl.merge_lines = 0;
+        memcpy(pl.merge_start, pl.previous_target, sizeof(pl.previous_target));
+        memcpy(pl.merge_position, position_steps, sizeof(position_steps));
+        memcpy(pl.merge_previous_unit_vec, pl.previous_unit_vec, sizeof(pl.previous_unit_vec));
+        pl.merge_previous_nominal_speed = pl.previous_nominal_speed;
+        memcpy(pl.previous_target, target, sizeof(pl.previous_target));
+        pl.target_valid = true;
         float nominal_speed = plan_compute_profile_nominal_speed(block);
         plan_compute_profile_parameters(block, nominal_speed, pl.previous_nominal_speed);
         pl.previous_nominal_speed = nominal_speed;
@@ -415,6 +594,7 @@ uint8_t plan_buffer_line(float* target, plan_line_data_t* pl_data) {
         // Finish up by recalculating the plan with the new block.
         planner_recalculate();
     }
+    motion_stats.blocks_planned++;
     return (PLAN_OK);
 }
 
@@ -423,6 +603,9 @@ void plan_sync_position() {
     // TODO: For motor configurations not in the same coordinate frame as the machine position,
     // this function needs to be updated to accomodate the difference.
     uint8_t idx;
+    // The mm target of the last line no longer matches the planner position, so stop merging.
+    pl.target_valid = false;
+    pl.merge_valid = false;
     for (idx = 0; idx < N_AXIS; idx++) {
 #ifdef COREXY
         if (idx == X_AXIS)
@@ -439,17 +622,22 @@ void plan_sync_position() {
 
 
 // Returns the number of available blocks are in the planner buffer.
-uint8_t plan_get_block_buffer_available() {
-    if (block_buffer_head >= block_buffer_tail)  return ((BLOCK_BUFFER_SIZE - 1) - (block_buffer_head - block_buffer_tail));
+uint16_t plan_get_block_buffer_available() {
+    if (block_buffer_head >= block_buffer_tail)  return ((block_buffer_size - 1) - (block_buffer_head - block_buffer_tail));
     return ((block_buffer_tail - block_buffer_head - 1));
 }
 
 
 // Returns the number of active blocks are in the planner buffer.
 // NOTE: Deprecated. Not used unless classic status reports are enabled in config.h
-uint8_t plan_get_block_buffer_count() {
+uint16_t plan_get_block_buffer_count() {
     if (block_buffer_head >= block_buffer_tail)  return (block_buffer_head - block_buffer_tail);
-    return (BLOCK_BUFFER_SIZE - (block_buffer_tail - block_buffer_head));
+    return (block_buffer_size - (block_buffer_tail - block_buffer_head));
+}
+
+
+uint16_t plan_get_block_buffer_size() {
+    return (block_buffer_size);
 }
 
 
@@ -457,7 +645,9 @@ uint8_t plan_get_block_buffer_count() {
 // Called after a steppers have come to a complete stop for a feed hold and the cycle is stopped.
 void plan_cycle_reinitialize() {
     // Re-plan from a complete stop. Reset planner entry speeds and buffer planned pointer.
+    st_prep_lock();
     st_update_plan_block_parameters();
     block_buffer_planned = block_buffer_tail;
     planner_recalculate();
+    st_prep_unlock();
 }
@@ -25,7 +25,8 @@
 #ifndef planner_h
 #define planner_h
 
-// The number of linear motions that can be in the plan at any give time
+// The default number of linear motions that can be in the plan at any give time. The actual
+// ring size is read from $Planner/Blocks once at boot and may be up to MAX_BLOCK_BUFFER_SIZE.
 #ifndef BLOCK_BUFFER_SIZE
     #ifdef USE_LINE_NUMBERS
         #define BLOCK_BUFFER_SIZE 15
@@ -34,6 +35,16 @@
     #endif
 #endif
 
+#define MIN_BLOCK_BUFFER_SIZE 8
+#ifndef MAX_BLOCK_BUFFER_SIZE
+    #define MAX_BLOCK_BUFFER_SIZE 512
+#endif
+
+// Maximum number of G64 lines folded into one planner block. Bounds the tolerance check per new line.
+#ifndef PLAN_MERGE_MAX_LINES
+    #define PLAN_MERGE_MAX_LINES 8
+#endif
+
 // Returned status message from planner.
 #define PLAN_OK true
 #define PLAN_EMPTY_BLOCK false
@@ -66,6 +77,7 @@ typedef struct {
 #ifdef USE_LINE_NUMBERS
     int32_t line_number;  // Block line number for real-time reporting. Copied from pl_line_data.
 #endif
+    uint32_t job_line;      // SD job line of the block, for the power loss checkpoint. Copied from pl_line_data.
 
     // Fields used by the motion planner to manage acceleration. Some of these values may be updated
     // by the stepper module during execution of special motion cases for replanning purposes.
@@ -73,6 +85,8 @@ typedef struct {
     float max_entry_speed_sqr; // Maximum allowable entry speed based on the minimum of junction limit and
     //   neighboring nominal speeds with overrides in (mm/min)^2
     float acceleration;        // Axis-limit adjusted line acceleration in (mm/min^2). Does not change.
+    float jerk;                // Axis-limit adjusted line jerk in (mm/min^3). Used by S-curve ramps only.
+    float peak_acceleration;   // Highest acceleration an S-curve ramp may reach (mm/min^2). Zero when not planned for S-curves.
     float millimeters;         // The remaining distance for this block to be executed in (mm).
     // NOTE: This value may be altered by stepper algorithm during execution.
 
@@ -92,13 +106,18 @@ typedef struct {
     float feed_rate;          // Desired feed rate for line motion. Value is ignored, if rapid motion.
     uint32_t spindle_speed;      // Desired spindle speed through line motion.
     uint8_t condition;        // Bitflag variable to indicate planner conditions. See defines above.
+    float path_tolerance;     // G64 merge tolerance in mm. Zero for exact path (G61) and system motions.
 #ifdef USE_LINE_NUMBERS
     int32_t line_number;    // Desired line number to report when executing.
 #endif
+    uint32_t job_line;        // SD job line the motion came from. Set by mc_line().
 } plan_line_data_t;
 
 
 
+// Allocates the block ring buffer. Called once at boot after the settings are loaded.
+void plan_init();
+
 // Initialize and reset the motion plan subsystem
 void plan_reset(); // Reset all
 void plan_reset_buffer(); // Reset buffer only.
@@ -119,7 +138,7 @@ plan_block_t* plan_get_system_motion_block();
 plan_block_t* plan_get_current_block();
 
 // Called periodically by step segment buffer. Mostly used internally by planner.
-uint8_t plan_next_block_index(uint8_t block_index);
+uint16_t plan_next_block_index(uint16_t block_index);
 
 // Called by step segment buffer when computing executing block velocity profile.
 float plan_get_exec_block_exit_speed_sqr();
@@ -137,11 +156,14 @@ void plan_sync_position();
 void plan_cycle_reinitialize();
 
 // Returns the number of available blocks are in the planner buffer.
-uint8_t plan_get_block_buffer_available();
+uint16_t plan_get_block_buffer_available();
 
 // Returns the number of active blocks are in the planner buffer.
 // NOTE: Deprecated. Not used unless classic status reports are enabled in config.h
-uint8_t plan_get_block_buffer_count();
+uint16_t plan_get_block_buffer_count();
+
+// Returns the number of blocks in the ring buffer, as allocated by plan_init().
+uint16_t plan_get_block_buffer_size();
 
 // Returns the status of the block ring buffer. True, if buffer is full.
 uint8_t plan_check_full_buffer();
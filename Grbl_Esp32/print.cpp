@@ -76,13 +76,13 @@ void print_uint8_base2_ndigit(uint8_t n, uint8_t digits) {
         n /= 2;
     }
     for (; i > 0; i--)
-        Serial.print('0' + buf[i - 1]);
+        serial_write('0' + buf[i - 1]);
 }
 
 
 void print_uint32_base10(uint32_t n) {
     if (n == 0) {
-        Serial.print('0');
+        serial_write('0');
         return;
     }
     unsigned char buf[10];
@@ -92,13 +92,13 @@ void print_uint32_base10(uint32_t n) {
         n /= 10;
     }
     for (; i > 0; i--)
-        Serial.print('0' + buf[i - 1]);
+        serial_write('0' + buf[i - 1]);
 }
 
 
 void printInteger(long n) {
     if (n < 0) {
-        Serial.print('-');
+        serial_write('-');
         print_uint32_base10(-n);
     } else
         print_uint32_base10(n);
@@ -111,7 +111,9 @@ void printInteger(long n) {
 // NOTE: AVR '%' and '/' integer operations are very efficient. Bitshifting speed-up
 // techniques are actually just slightly slower. Found this out the hard way.
 void printFloat(float n, uint8_t decimal_places) {
-    Serial.print(n, decimal_places);
+    char buffer[20];
+    snprintf(buffer, sizeof(buffer), "%.*f", decimal_places, n);
+    serial_write_text(buffer);
 }
 
 
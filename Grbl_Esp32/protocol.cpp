@@ -86,6 +86,45 @@ err_t execute_line(char* line, uint8_t client, auth_t auth_level) {
     return gc_execute_line(line, client);
 }
 
+#ifdef ENABLE_SD_CARD
+// Runs lines from a SD job back to back until the planner is full, instead of one line per pass
+// through the main loop. A successful line sets SD_ready_next again in report_status_message(),
+// an error stops the job there and reports the line number, so the loop ends either way as soon
+// as a line fails. Clients are polled again once the planner has enough to keep the machine busy,
+// or after SD_LINES_PER_PASS lines, since in check mode or on lines that plan nothing the planner
+// never fills.
+static void protocol_execute_sd_lines() {
+    char fileLine[255];
+    uint8_t lines = 0;
+    while (SD_ready_next && !plan_check_full_buffer() && lines++ < SD_LINES_PER_PASS) {
+        err_t status = STATUS_OK;
+        bool more;
+        if (job_cache_running())
+            more = job_cache_execute_next(&status); // Precompiled, see job_cache.h
+        else {
+            job_index_before_line();
+            more = readFileLine(fileLine, 255);
+            if (more)
+                status = gc_execute_line(fileLine, SD_client);
+        }
+        if (!more) {
+            char temp[50];
+            sd_get_current_filename(temp);
+            grbl_notifyf("SD print done", "%s print is successful", temp);
+            job_index_finish(true);
+            job_checkpoint_finish();
+            closeFile(); // close file and clear SD ready/running flags
+            return;
+        }
+        SD_ready_next = false;
+        report_status_message(status, SD_client);
+        protocol_execute_realtime(); // Runtime command check point.
+        if (sys.abort)
+            return;
+    }
+}
+#endif
+
 /*
   GRBL PRIMARY LOOP:
 */
@@ -125,22 +164,19 @@ void protocol_main_loop() {
     uint8_t c;
     for (;;) {
 #ifdef ENABLE_SD_CARD
-        if (SD_ready_next) {
-            char fileLine[255];
-            if (readFileLine(fileLine, 255)) {
-                SD_ready_next = false;
-                report_status_message(gc_execute_line(fileLine, SD_client), SD_client);
-            } else {
-                char temp[50];
-                sd_get_current_filename(temp);
-                grbl_notifyf("SD print done", "%s print is successful", temp);
-                closeFile(); // close file and clear SD ready/running flags
-            }
+        protocol_execute_sd_lines();
+        if (sys.abort) {
+            return;   // Bail to calling function upon system abort
         }
 #endif
         // Receive one line of incoming serial data, as the data becomes available.
         // Filtering, if necessary, is done later in gc_execute_line(), so the
         // filtering is the same with serial and file input.
+        // Moves from a client in binary stream mode are already parsed. See binary_stream.h
+        binary_stream_execute();
+        if (sys.abort) {
+            return;   // Bail to calling function upon system abort
+        }
         uint8_t client = CLIENT_SERIAL;
         char* line;
         for (client = 0; client < CLIENT_COUNT; client++) {
@@ -190,12 +226,13 @@ void protocol_main_loop() {
 // Block until all buffered steps are executed or in a cycle state. Works with feed hold
 // during a synchronize call, if it should happen. Also, waits for clean cycle end.
 void protocol_buffer_synchronize() {
+    mc_line_queue_flush();
     // If system is queued, ensure cycle resumes if the auto start flag is present.
     protocol_auto_cycle_start();
     do {
         protocol_execute_realtime();   // Check and execute run-time commands
         if (sys.abort)  return;   // Check for system abort
-    } while (plan_get_current_block() || (sys.state == STATE_CYCLE));
+    } while (plan_get_current_block() || (sys.state == STATE_CYCLE) || mc_line_queue_count());
 }
 
 
@@ -388,11 +425,14 @@ void protocol_exec_rt_system() {
                 // Motion complete. Includes CYCLE/JOG/HOMING states and jog cancel/motion cancel/soft limit events.
                 // NOTE: Motion and jog cancel both immediately return to idle after the hold completes.
                 if (sys.suspend & SUSPEND_JOG_CANCEL) {   // For jog cancel, flush buffers and sync positions.
+                    st_prep_lock(); // Keep the prep task out until both buffers are flushed
                     sys.step_control = STEP_CONTROL_NORMAL_OP;
+                    mc_line_queue_reset();
                     plan_reset();
                     st_reset();
                     gc_sync_position();
                     plan_sync_position();
+                    st_prep_unlock();
                 }
                 if (sys.suspend & SUSPEND_SAFETY_DOOR_AJAR) { // Only occurs when safety door opens during jog.
                     sys.suspend &= ~(SUSPEND_JOG_CANCEL);
@@ -490,7 +530,8 @@ void protocol_exec_rt_system() {
         sys_rt_exec_debug = 0;
     }
 #endif
-    // Reload step segment buffer
+    // Plan lines parsed ahead while the planner was full, then reload step segment buffer
+    mc_line_queue_flush();
     if (sys.state & (STATE_CYCLE | STATE_HOLD | STATE_SAFETY_DOOR | STATE_HOMING | STATE_SLEEP | STATE_JOG))
         st_prep_buffer();
 }
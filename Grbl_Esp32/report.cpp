@@ -70,53 +70,148 @@ void grbl_send(uint8_t client, const char* text) {
         telnet_server.write((const uint8_t*)text, strlen(text));
 #endif
     if (client == CLIENT_SERIAL || client == CLIENT_ALL)
-        Serial.print(text);
+        serial_write_text(text);
 }
 
-// This is a formating version of the grbl_send(CLIENT_ALL,...) function that work like printf
+ReportWriter::ReportWriter(char* buffer, size_t size) {
+    _buffer = buffer;
+    _size = size;
+    _length = 0;
+    _truncated = false;
+    _buffer[0] = '\0';
+}
+
+void ReportWriter::put(char c) {
+    if (_length + 1 >= _size) {
+        _truncated = true;
+        return;
+    }
+    _buffer[_length++] = c;
+    _buffer[_length] = '\0';
+}
+
+void ReportWriter::put(const char* text) {
+    put(text, strlen(text));
+}
+
+void ReportWriter::put(const char* text, size_t length) {
+    if (_length + length >= _size) {
+        length = _size - 1 - _length;
+        _truncated = true;
+    }
+    memcpy(_buffer + _length, text, length);
+    _length += length;
+    _buffer[_length] = '\0';
+}
+
+// Writes the digits backwards into a scratch buffer, then appends them in one go.
+void ReportWriter::put_uint64(uint64_t value, uint8_t min_digits) {
+    char digits[20];
+    uint8_t count = 0;
+    do {
+        digits[sizeof(digits) - ++count] = '0' + (value % 10);
+        value /= 10;
+    } while (value || count < min_digits);
+    put(digits + sizeof(digits) - count, count);
+}
+
+void ReportWriter::put_uint(uint32_t value) {
+    put_uint64(value, 1);
+}
+
+void ReportWriter::put_int(int32_t value) {
+    if (value < 0) {
+        put('-');
+        put_uint64(-(int64_t)value, 1);
+    } else
+        put_uint64(value, 1);
+}
+
+static const uint32_t fixed_scale[] = { 1, 10, 100, 1000, 10000, 100000, 1000000 };
+
+void ReportWriter::put_fixed(float value, uint8_t decimals) {
+    if (isnan(value)) {
+        put("nan");
+        return;
+    }
+    if (isinf(value)) {
+        put(value < 0 ? "-inf" : "inf");
+        return;
+    }
+    decimals = MIN(decimals, 6);
+    // A float has 24 bits of mantissa, so the product is exact in a double and rounds just like
+    // printf, which rounds the exact value, half to even.
+    double scaled = fabs((double)value * fixed_scale[decimals]);
+    if (scaled >= 1e18) {
+        put(value < 0 ? "-inf" : "inf"); // Far beyond any machine
+        return;
+    }
+    uint64_t whole = (uint64_t)scaled;
+    double fraction = scaled - (double)whole;
+    if (fraction > 0.5 || (fraction == 0.5 && (whole & 1)))
+        whole++;
+    if (signbit(value))
+        put('-'); // printf gives -0.000 as well
+    put_uint64(whole / fixed_scale[decimals], 1);
+    if (decimals) {
+        put('.');
+        put_uint64(whole % fixed_scale[decimals], decimals);
+    }
+}
+
+// Comma separated, mm to 3 decimals or inches to 4.
+void ReportWriter::put_axes(float* values) {
+    bool inches = report_inches->get();
+    for (uint8_t idx = 0; idx < N_AXIS; idx++) {
+        if (idx)
+            put(',');
+        if (inches)
+            put_fixed(values[idx] * (float)(1.0 / MM_PER_INCH), 4);
+        else
+            put_fixed(values[idx], 3);
+    }
+}
+
+void ReportWriter::put_vformat(const char* format, va_list args) {
+    int length = vsnprintf(_buffer + _length, _size - _length, format, args);
+    if (length < 0)
+        return;
+    if (_length + length >= _size) {
+        _length = _size - 1;
+        _truncated = true;
+    } else
+        _length += length;
+}
+
+// This is a formating version of the grbl_send(CLIENT_ALL,...) function that work like printf.
+// The text is built on the stack. A line longer than GRBL_SENDF_SIZE is cut short, but still ends
+// with its line break.
 void grbl_sendf(uint8_t client, const char* format, ...) {
     if (client == CLIENT_INPUT) return;
-    char loc_buf[64];
-    char* temp = loc_buf;
+    char buffer[GRBL_SENDF_SIZE];
+    ReportWriter line(buffer, sizeof(buffer));
     va_list arg;
-    va_list copy;
     va_start(arg, format);
-    va_copy(copy, arg);
-    size_t len = vsnprintf(NULL, 0, format, arg);
-    va_end(copy);
-    if (len >= sizeof(loc_buf)) {
-        temp = new char[len + 1];
-        if (temp == NULL)
-            return;
-    }
-    len = vsnprintf(temp, len + 1, format, arg);
-    grbl_send(client, temp);
+    line.put_vformat(format, arg);
     va_end(arg);
-    if (len > 64)
-        delete[] temp;
+    size_t format_length = strlen(format);
+    if (line.truncated() && format_length && format[format_length - 1] == '\n')
+        strcpy(buffer + sizeof(buffer) - 3, "\r\n");
+    grbl_send(client, buffer);
 }
 // Use to send [MSG:xxxx] Type messages. The level allows messages to be easily suppressed
 void grbl_msg_sendf(uint8_t client, uint8_t level, const char* format, ...) {
     if (client == CLIENT_INPUT) return;
     if (level > GRBL_MSG_LEVEL) return;
-    char loc_buf[100];
-    char* temp = loc_buf;
+    char buffer[GRBL_SENDF_SIZE];
+    ReportWriter msg(buffer, sizeof(buffer) - 3); // Room for the "]\r\n"
+    msg.put("[MSG:");
     va_list arg;
-    va_list copy;
     va_start(arg, format);
-    va_copy(copy, arg);
-    size_t len = vsnprintf(NULL, 0, format, arg);
-    va_end(copy);
-    if (len >= sizeof(loc_buf)) {
-        temp = new char[len + 1];
-        if (temp == NULL)
-            return;
-    }
-    len = vsnprintf(temp, len + 1, format, arg);
-    grbl_sendf(client, "[MSG:%s]\r\n", temp);
+    msg.put_vformat(format, arg);
     va_end(arg);
-    if (len > 100)
-        delete[] temp;
+    strcpy(buffer + msg.length(), "]\r\n");
+    grbl_send(client, buffer);
 }
 
 //function to notify
@@ -147,23 +242,9 @@ void grbl_notifyf(const char* title, const char* format, ...) {
         delete[] temp;
 }
 
-// formats axis values into a string and returns that string in rpt
-static void report_util_axis_values(float* axis_value, char* rpt) {
-    uint8_t idx;
-    char axisVal[20];
-    float unit_conv = 1.0; // unit conversion multiplier..default is mm
-    rpt[0] = '\0';
-    if (report_inches->get())
-        unit_conv = 1.0 / MM_PER_INCH;
-    for (idx = 0; idx < N_AXIS; idx++) {
-        if (report_inches->get())
-            sprintf(axisVal, "%4.4f", axis_value[idx] * unit_conv);  // Report inches to 4 decimals
-        else
-            sprintf(axisVal, "%4.3f", axis_value[idx] * unit_conv);  // Report mm to 3 decimals
-        strcat(rpt, axisVal);
-        if (idx < (N_AXIS - 1))
-            strcat(rpt, ",");
-    }
+// appends axis values to rpt
+static void report_util_axis_values(float* axis_value, ReportWriter& rpt) {
+    rpt.put_axes(axis_value);
 }
 
 void get_state(char* foo) {
@@ -286,15 +367,15 @@ void report_probe_parameters(uint8_t client) {
     // Report in terms of machine position.
     float print_position[N_AXIS];
     char probe_rpt[100];	// the probe report we are building here
-    char temp[60];
-    strcpy(probe_rpt, "[PRB:"); // initialize the string with the first characters
+    ReportWriter rpt(probe_rpt, sizeof(probe_rpt));
+    rpt.put("[PRB:"); // initialize the string with the first characters
     // get the machine position and put them into a string and append to the probe report
     system_convert_array_steps_to_mpos(print_position, sys_probe_position);
-    report_util_axis_values(print_position, temp);
-    strcat(probe_rpt, temp);
+    report_util_axis_values(print_position, rpt);
     // add the success indicator and add closing characters
-    sprintf(temp, ":%d]\r\n", sys.probe_succeeded);
-    strcat(probe_rpt, temp);
+    rpt.put(':');
+    rpt.put_uint(sys.probe_succeeded);
+    rpt.put("]\r\n");
     grbl_send(client, probe_rpt); // send the report
 }
 
@@ -305,38 +386,32 @@ void report_probe_parameters(uint8_t client) {
 void report_ngc_parameters(uint8_t client) {
     float coord_data[N_AXIS];
     uint8_t coord_select;
-    char temp[60];
     char ngc_rpt[500];
-    ngc_rpt[0] = '\0';
+    ReportWriter rpt(ngc_rpt, sizeof(ngc_rpt));
     for (coord_select = 0; coord_select <= SETTING_INDEX_NCOORD; coord_select++) {
         if (!(settings_read_coord_data(coord_select, coord_data))) {
             report_status_message(STATUS_SETTING_READ_FAIL, CLIENT_SERIAL);
             return;
         }
-        strcat(ngc_rpt, "[G");
+        rpt.put("[G");
         switch (coord_select) {
-        case 6: strcat(ngc_rpt, "28"); break;
-        case 7: strcat(ngc_rpt, "30"); break;
-        default:
-            sprintf(temp, "%d", coord_select + 54);
-            strcat(ngc_rpt, temp);
-            break; // G54-G59
+        case 6: rpt.put("28"); break;
+        case 7: rpt.put("30"); break;
+        default: rpt.put_uint(coord_select + 54); break; // G54-G59
         }
-        strcat(ngc_rpt, ":");
-        report_util_axis_values(coord_data, temp);
-        strcat(ngc_rpt, temp);
-        strcat(ngc_rpt, "]\r\n");
-    }
-    strcat(ngc_rpt, "[G92:"); // Print G92,G92.1 which are not persistent in memory
-    report_util_axis_values(gc_state.coord_offset, temp);
-    strcat(ngc_rpt, temp);
-    strcat(ngc_rpt, "]\r\n");
-    strcat(ngc_rpt, "[TLO:"); // Print tool length offset value
+        rpt.put(':');
+        report_util_axis_values(coord_data, rpt);
+        rpt.put("]\r\n");
+    }
+    rpt.put("[G92:"); // Print G92,G92.1 which are not persistent in memory
+    report_util_axis_values(gc_state.coord_offset, rpt);
+    rpt.put("]\r\n");
+    rpt.put("[TLO:"); // Print tool length offset value
     if (report_inches->get())
-        sprintf(temp, "%4.3f]\r\n", gc_state.tool_length_offset * INCH_PER_MM);
+        rpt.put_fixed(gc_state.tool_length_offset * INCH_PER_MM, 3);
     else
-        sprintf(temp, "%4.3f]\r\n", gc_state.tool_length_offset);
-    strcat(ngc_rpt, temp);
+        rpt.put_fixed(gc_state.tool_length_offset, 3);
+    rpt.put("]\r\n");
     grbl_send(client, ngc_rpt);
     report_probe_parameters(client);
 }
@@ -346,10 +421,12 @@ void report_ngc_parameters(uint8_t client) {
 // Print current gcode parser mode state
 void report_gcode_modes(uint8_t client) {
     char temp[20];
-    char modes_rpt[75];
+    char modes_rpt[80];
     strcpy(modes_rpt, "[GC:G");
     if (gc_state.modal.motion >= MOTION_MODE_PROBE_TOWARD)
         sprintf(temp, "38.%d", gc_state.modal.motion - (MOTION_MODE_PROBE_TOWARD - 2));
+    else if (gc_state.modal.motion == MOTION_MODE_QUADRATIC_SPLINE)
+        strcpy(temp, "5.1");
     else
         sprintf(temp, "%d", gc_state.modal.motion);
     strcat(modes_rpt, temp);
@@ -363,6 +440,8 @@ void report_gcode_modes(uint8_t client) {
     strcat(modes_rpt, temp);
     sprintf(temp, " G%d", 94 - gc_state.modal.feed_rate);
     strcat(modes_rpt, temp);
+    if (gc_state.modal.control == CONTROL_MODE_CONTINUOUS)
+        strcat(modes_rpt, " G64");  // G61 is the default and is not reported, as in stock Grbl
     if (gc_state.modal.program_flow) {
         //report_util_gcode_modes_M();
         switch (gc_state.modal.program_flow) {
@@ -497,51 +576,77 @@ void report_echo_line_received(char* line, uint8_t client) {
 // specific needs, but the desired real-time data report must be as short as possible. This is
 // requires as it minimizes the computational overhead and allows grbl to keep running smoothly,
 // especially during g-code programs with fast, short line segments and high frequency reports (5-20Hz).
-void report_realtime_status(uint8_t client) {
+#ifdef REPORT_FIELD_BUFFER_STATE
+// Appends the planner and serial read buffer states.
+static void report_buffer_state(ReportWriter& status, uint8_t client) {
+    if (bit_isfalse(status_mask->get(), BITFLAG_RT_STATUS_BUFFER_STATE))
+        return;
+    int bufsize = DEFAULTBUFFERSIZE;
+#if defined (ENABLE_WIFI) && defined(ENABLE_TELNET)
+    if (client == CLIENT_TELNET)
+        bufsize = telnet_server.get_rx_buffer_available();
+#endif //ENABLE_WIFI && ENABLE_TELNET
+#if defined(ENABLE_BLUETOOTH)
+    if (client == CLIENT_BT) {
+        //TODO FIXME
+        bufsize = 512 - SerialBT.available();
+    }
+#endif //ENABLE_BLUETOOTH
+    if (client == CLIENT_SERIAL)
+        bufsize = serial_get_rx_buffer_available(CLIENT_SERIAL);
+    status.put("|Bf:");
+    status.put_int(plan_get_block_buffer_available());
+    status.put(',');
+    status.put_int(bufsize);
+}
+#endif
+
+// Builds a status report without the closing ">\r\n". An autoreport is one snapshot for all its
+// subscribers, so it leaves out the per client Bf: field and always carries WCO: and Ov:, without
+// touching the refresh counters of the polled reports.
+static void report_realtime_fields(ReportWriter& status, uint8_t client, bool autoreport) {
     uint8_t idx;
     int32_t current_position[N_AXIS]; // Copy current state of the system position variable
     memcpy(current_position, sys_position, sizeof(sys_position));
     float print_position[N_AXIS];
-    char status[200];
-    char temp[80];
     system_convert_array_steps_to_mpos(print_position, current_position);
     // Report current machine state and sub-states
-    strcpy(status, "<");
+    status.put('<');
     switch (sys.state) {
-    case STATE_IDLE: strcat(status, "Idle"); break;
-    case STATE_CYCLE: strcat(status, "Run"); break;
+    case STATE_IDLE: status.put("Idle"); break;
+    case STATE_CYCLE: status.put("Run"); break;
     case STATE_HOLD:
         if (!(sys.suspend & SUSPEND_JOG_CANCEL)) {
-            strcat(status, "Hold:");
-            if (sys.suspend & SUSPEND_HOLD_COMPLETE)  strcat(status, "0");   // Ready to resume
-            else  strcat(status, "1");   // Actively holding
+            status.put("Hold:");
+            if (sys.suspend & SUSPEND_HOLD_COMPLETE)  status.put("0");   // Ready to resume
+            else  status.put("1");   // Actively holding
             break;
         } // Continues to print jog state during jog cancel.
-    case STATE_JOG: strcat(status, "Jog"); break;
-    case STATE_HOMING: strcat(status, "Home"); break;
-    case STATE_ALARM: strcat(status, "Alarm"); break;
-    case STATE_CHECK_MODE: strcat(status, "Check"); break;
+    case STATE_JOG: status.put("Jog"); break;
+    case STATE_HOMING: status.put("Home"); break;
+    case STATE_ALARM: status.put("Alarm"); break;
+    case STATE_CHECK_MODE: status.put("Check"); break;
     case STATE_SAFETY_DOOR:
-        strcat(status, "Door:");
+        status.put("Door:");
         if (sys.suspend & SUSPEND_INITIATE_RESTORE) {
-            strcat(status, "3"); // Restoring
+            status.put("3"); // Restoring
         } else {
             if (sys.suspend & SUSPEND_RETRACT_COMPLETE) {
                 if (sys.suspend & SUSPEND_SAFETY_DOOR_AJAR) {
-                    strcat(status, "1"); // Door ajar
+                    status.put("1"); // Door ajar
                 } else
-                    strcat(status, "0");
+                    status.put("0");
                 // Door closed and ready to resume
             } else {
-                strcat(status, "2"); // Retracting
+                status.put("2"); // Retracting
             }
         }
         break;
-    case STATE_SLEEP: strcat(status, "Sleep"); break;
+    case STATE_SLEEP: status.put("Sleep"); break;
     }
     float wco[N_AXIS];
     if (bit_isfalse(status_mask->get(), BITFLAG_RT_STATUS_POSITION_TYPE) ||
-            (sys.report_wco_counter == 0)) {
+            (sys.report_wco_counter == 0) || autoreport) {
         for (idx = 0; idx < N_AXIS; idx++) {
             // Apply work coordinate offsets and tool length offset to current position.
             wco[idx] = gc_state.coord_system[idx] + gc_state.coord_offset[idx];
@@ -552,34 +657,18 @@ void report_realtime_status(uint8_t client) {
     }
     // Report machine position
     if (bit_istrue(status_mask->get(), BITFLAG_RT_STATUS_POSITION_TYPE))
-        strcat(status, "|MPos:");
+        status.put("|MPos:");
     else {
 #ifdef USE_FWD_KINEMATIC
         forward_kinematics(print_position);
 #endif
-        strcat(status, "|WPos:");
+        status.put("|WPos:");
     }
-    report_util_axis_values(print_position, temp);
-    strcat(status, temp);
+    report_util_axis_values(print_position, status);
     // Returns planner and serial read buffer states.
 #ifdef REPORT_FIELD_BUFFER_STATE
-    if (bit_istrue(status_mask->get(), BITFLAG_RT_STATUS_BUFFER_STATE)) {
-        int bufsize = DEFAULTBUFFERSIZE;
-#if defined (ENABLE_WIFI) && defined(ENABLE_TELNET)
-        if (client == CLIENT_TELNET)
-            bufsize = telnet_server.get_rx_buffer_available();
-#endif //ENABLE_WIFI && ENABLE_TELNET
-#if defined(ENABLE_BLUETOOTH)
-        if (client == CLIENT_BT) {
-            //TODO FIXME
-            bufsize = 512 - SerialBT.available();
-        }
-#endif //ENABLE_BLUETOOTH
-        if (client == CLIENT_SERIAL)
-            bufsize = serial_get_rx_buffer_available(CLIENT_SERIAL);
-        sprintf(temp, "|Bf:%d,%d", plan_get_block_buffer_available(), bufsize);
-        strcat(status, temp);
-    }
+    if (!autoreport)
+        report_buffer_state(status, client);
 #endif
 #ifdef USE_LINE_NUMBERS
 #ifdef REPORT_FIELD_LINE_NUMBERS
@@ -588,100 +677,311 @@ void report_realtime_status(uint8_t client) {
     if (cur_block != NULL) {
         uint32_t ln = cur_block->line_number;
         if (ln > 0) {
-            sprintf(temp, "|Ln:%d", ln);
-            strcat(status, temp);
+            status.put("|Ln:");
+            status.put_uint(ln);
         }
     }
 #endif
 #endif
     // Report realtime feed speed
 #ifdef REPORT_FIELD_CURRENT_FEED_SPEED
+    status.put("|FS:");
     if (report_inches->get())
-        sprintf(temp, "|FS:%.1f,%d", st_get_realtime_rate()/ MM_PER_INCH, sys.spindle_speed);
+        status.put_fixed(st_get_realtime_rate() / MM_PER_INCH, 1);
     else
-        sprintf(temp, "|FS:%.0f,%d", st_get_realtime_rate(), sys.spindle_speed);
-    strcat(status, temp);
+        status.put_fixed(st_get_realtime_rate(), 0);
+    status.put(',');
+    status.put_uint(sys.spindle_speed);
 #endif
 #ifdef REPORT_FIELD_PIN_STATE
     uint8_t lim_pin_state = limits_get_state();
     uint8_t ctrl_pin_state = system_control_get_state();
     uint8_t prb_pin_state = probe_get_state();
     if (lim_pin_state | ctrl_pin_state | prb_pin_state) {
-        strcat(status, "|Pn:");
-        if (prb_pin_state)  strcat(status, "P");
+        status.put("|Pn:");
+        if (prb_pin_state)  status.put("P");
         if (lim_pin_state) {
-            if (bit_istrue(lim_pin_state, bit(X_AXIS)))  strcat(status, "X");
-            if (bit_istrue(lim_pin_state, bit(Y_AXIS)))  strcat(status, "Y");
-            if (bit_istrue(lim_pin_state, bit(Z_AXIS)))  strcat(status, "Z");
+            if (bit_istrue(lim_pin_state, bit(X_AXIS)))  status.put("X");
+            if (bit_istrue(lim_pin_state, bit(Y_AXIS)))  status.put("Y");
+            if (bit_istrue(lim_pin_state, bit(Z_AXIS)))  status.put("Z");
 #if (N_AXIS > A_AXIS)
-            if (bit_istrue(lim_pin_state, bit(A_AXIS)))  strcat(status, "A");
+            if (bit_istrue(lim_pin_state, bit(A_AXIS)))  status.put("A");
 #endif
 #if (N_AXIS > B_AXIS)
-            if (bit_istrue(lim_pin_state, bit(B_AXIS)))  strcat(status, "B");
+            if (bit_istrue(lim_pin_state, bit(B_AXIS)))  status.put("B");
 #endif
 #if (N_AXIS > C_AXIS)
-            if (bit_istrue(lim_pin_state, bit(C_AXIS)))  strcat(status, "C");
+            if (bit_istrue(lim_pin_state, bit(C_AXIS)))  status.put("C");
 #endif
         }
         if (ctrl_pin_state) {
 #ifdef ENABLE_SAFETY_DOOR_INPUT_PIN
-            if (bit_istrue(ctrl_pin_state, CONTROL_PIN_INDEX_SAFETY_DOOR))  strcat(status, "D");
+            if (bit_istrue(ctrl_pin_state, CONTROL_PIN_INDEX_SAFETY_DOOR))  status.put("D");
 #endif
-            if (bit_istrue(ctrl_pin_state, CONTROL_PIN_INDEX_RESET))  strcat(status, "R");
-            if (bit_istrue(ctrl_pin_state, CONTROL_PIN_INDEX_FEED_HOLD))  strcat(status, "H");
-            if (bit_istrue(ctrl_pin_state, CONTROL_PIN_INDEX_CYCLE_START))  strcat(status, "S");
+            if (bit_istrue(ctrl_pin_state, CONTROL_PIN_INDEX_RESET))  status.put("R");
+            if (bit_istrue(ctrl_pin_state, CONTROL_PIN_INDEX_FEED_HOLD))  status.put("H");
+            if (bit_istrue(ctrl_pin_state, CONTROL_PIN_INDEX_CYCLE_START))  status.put("S");
         }
     }
 #endif
 #ifdef REPORT_FIELD_WORK_COORD_OFFSET
-    if (sys.report_wco_counter > 0)  sys.report_wco_counter--;
+    if (sys.report_wco_counter > 0 && !autoreport)  sys.report_wco_counter--;
     else {
-        if (sys.state & (STATE_HOMING | STATE_CYCLE | STATE_HOLD | STATE_JOG | STATE_SAFETY_DOOR)) {
-            sys.report_wco_counter = (REPORT_WCO_REFRESH_BUSY_COUNT - 1); // Reset counter for slow refresh
-        } else  sys.report_wco_counter = (REPORT_WCO_REFRESH_IDLE_COUNT - 1);
-        if (sys.report_ovr_counter == 0)  sys.report_ovr_counter = 1;   // Set override on next report.
-        strcat(status, "|WCO:");
-        report_util_axis_values(wco, temp);
-        strcat(status, temp);
+        if (!autoreport) {
+            if (sys.state & (STATE_HOMING | STATE_CYCLE | STATE_HOLD | STATE_JOG | STATE_SAFETY_DOOR)) {
+                sys.report_wco_counter = (REPORT_WCO_REFRESH_BUSY_COUNT - 1); // Reset counter for slow refresh
+            } else  sys.report_wco_counter = (REPORT_WCO_REFRESH_IDLE_COUNT - 1);
+            if (sys.report_ovr_counter == 0)  sys.report_ovr_counter = 1;   // Set override on next report.
+        }
+        status.put("|WCO:");
+        report_util_axis_values(wco, status);
     }
 #endif
 #ifdef REPORT_FIELD_OVERRIDES
-    if (sys.report_ovr_counter > 0)  sys.report_ovr_counter--;
+    if (sys.report_ovr_counter > 0 && !autoreport)  sys.report_ovr_counter--;
     else {
-        if (sys.state & (STATE_HOMING | STATE_CYCLE | STATE_HOLD | STATE_JOG | STATE_SAFETY_DOOR)) {
-            sys.report_ovr_counter = (REPORT_OVR_REFRESH_BUSY_COUNT - 1); // Reset counter for slow refresh
-        } else  sys.report_ovr_counter = (REPORT_OVR_REFRESH_IDLE_COUNT - 1);
-        sprintf(temp, "|Ov:%d,%d,%d", sys.f_override, sys.r_override, sys.spindle_speed_ovr);
-        strcat(status, temp);
+        if (!autoreport) {
+            if (sys.state & (STATE_HOMING | STATE_CYCLE | STATE_HOLD | STATE_JOG | STATE_SAFETY_DOOR)) {
+                sys.report_ovr_counter = (REPORT_OVR_REFRESH_BUSY_COUNT - 1); // Reset counter for slow refresh
+            } else  sys.report_ovr_counter = (REPORT_OVR_REFRESH_IDLE_COUNT - 1);
+        }
+        status.put("|Ov:");
+        status.put_uint(sys.f_override);
+        status.put(',');
+        status.put_uint(sys.r_override);
+        status.put(',');
+        status.put_uint(sys.spindle_speed_ovr);
         uint8_t sp_state =  spindle->get_state();
         uint8_t cl_state = coolant_get_state();
         if (sp_state || cl_state) {
-            strcat(status, "|A:");
+            status.put("|A:");
             if (sp_state) { // != SPINDLE_STATE_DISABLE
-                if (sp_state == SPINDLE_STATE_CW)  strcat(status, "S");   // CW
-                else  strcat(status, "C");   // CCW
+                if (sp_state == SPINDLE_STATE_CW)  status.put("S");   // CW
+                else  status.put("C");   // CCW
             }
-            if (cl_state & COOLANT_STATE_FLOOD)  strcat(status, "F");
+            if (cl_state & COOLANT_STATE_FLOOD)  status.put("F");
 #ifdef COOLANT_MIST_PIN // TODO Deal with M8 - Flood
-            if (cl_state & COOLANT_STATE_MIST)  strcat(status, "M");
+            if (cl_state & COOLANT_STATE_MIST)  status.put("M");
 #endif
         }
     }
 #endif
 #ifdef ENABLE_SD_CARD
     if (get_sd_state(false) == SDCARD_BUSY_PRINTING) {
-        sprintf(temp, "|SD:%4.2f,", sd_report_perc_complete());
-        strcat(status, temp);
-        sd_get_current_filename(temp);
-        strcat(status, temp);
+        char name[80];
+        status.put("|SD:");
+        status.put_fixed(sd_report_perc_complete(), 2);
+        status.put(',');
+        sd_get_current_filename(name);
+        status.put(name);
     }
 #endif
 #ifdef REPORT_HEAP
-    sprintf(temp, "|Heap:%d", esp.getHeapSize());
-    strcat(status, temp);
+    status.put("|Heap:");
+    status.put_uint(esp.getHeapSize());
 #endif
-    strcat(status, ">\r\n");
-    grbl_send(client, status);
+}
+
+void report_realtime_status(uint8_t client) {
+    char buffer[STATUS_REPORT_SIZE];
+    ReportWriter status(buffer, sizeof(buffer) - 3); // Room for the ">\r\n"
+    report_realtime_fields(status, client, false);
+    strcpy(buffer + status.length(), ">\r\n");
+    grbl_send(client, buffer);
+}
+
+typedef struct {
+    uint32_t interval;              // msec, 0 = not subscribed
+    uint32_t next;                  // millis() of the next report
+    bool changed;                   // Only send the fields that changed
+    char last[STATUS_REPORT_SIZE];  // Fields of the last report sent, for the changed fields
+} autoreport_t;
+
+static autoreport_t autoreport[CLIENT_COUNT];
+static volatile bool autoreport_any = false;
+
+static void report_autoreport_update_any() {
+    bool any = false;
+    for (uint8_t idx = 0; idx < CLIENT_COUNT; idx++)
+        any |= (autoreport[idx].interval != 0);
+    autoreport_any = any;
+}
+
+err_t report_autoreport_set(uint8_t client, uint32_t interval, bool changed) {
+    if (client >= CLIENT_COUNT)
+        return (STATUS_INVALID_VALUE);
+    if (interval && interval < AUTOREPORT_MIN_INTERVAL)
+        return (STATUS_INVALID_VALUE);
+    autoreport_t* ar = &autoreport[client];
+    ar->interval = 0; // Off while it changes, serialCheckTask() may be looking at it
+    ar->changed = changed;
+    ar->last[0] = '\0'; // The first report has all fields
+    ar->next = millis();
+    ar->interval = interval;
+    report_autoreport_update_any();
+    serial_notify_rx(); // serialCheckTask() may be asleep until a report that is no longer due
+    return (STATUS_OK);
+}
+
+// A client that went away, or was reset, has to subscribe again.
+void report_autoreport_reset(uint8_t client) {
+    for (uint8_t idx = 0; idx < CLIENT_COUNT; idx++) {
+        if (client == idx || client == CLIENT_ALL)
+            autoreport[idx].interval = 0;
+    }
+    report_autoreport_update_any();
+}
+
+void report_autoreport(uint8_t client) {
+    if (client >= CLIENT_COUNT || autoreport[client].interval == 0)
+        grbl_send(client, "[RA:0]\r\n");
+    else
+        grbl_sendf(client, "[RA:%d%s]\r\n", autoreport[client].interval, autoreport[client].changed ? ",C" : "");
+}
+
+// Finds the field of report that starts with key, which ends with its ':'. Returns its '|' or NULL.
+static const char* report_find_field(const char* report, const char* key, size_t key_length) {
+    for (const char* next = strchr(report, '|'); next; next = strchr(next + 1, '|')) {
+        if (strncmp(next + 1, key, key_length) == 0)
+            return (next);
+    }
+    return (NULL);
+}
+
+// Appends the fields of report that are not the same in last. A field that is gone is sent with
+// no value, e.g. |Pn: when the pins are released. The state always goes.
+static void report_changed_fields(ReportWriter& out, const char* report, const char* last) {
+    const char* field = strchr(report, '|');
+    size_t length = field ? field - report : strlen(report);
+    out.put(report, length);
+    while (field) {
+        const char* end = strchr(field + 1, '|');
+        length = end ? end - field : strlen(field);
+        const char* colon = strchr(field, ':');
+        const char* old = colon ? report_find_field(last, field + 1, colon - field) : NULL;
+        size_t old_length = 0;
+        if (old) {
+            const char* old_end = strchr(old + 1, '|');
+            old_length = old_end ? old_end - old : strlen(old);
+        }
+        if (old_length != length || strncmp(old, field, length) != 0)
+            out.put(field, length);
+        field = end;
+    }
+    for (field = strchr(last, '|'); field; field = strchr(field + 1, '|')) {
+        const char* colon = strchr(field, ':');
+        if (colon && !report_find_field(report, field + 1, colon - field))
+            out.put(field, colon - field + 1);
+    }
+}
+
+// Called by serialCheckTask() every time it wakes, and it sleeps no longer than the ticks this
+// returns. The report is built once for all subscribers that are due, so the cost does not grow
+// with the number of clients.
+TickType_t report_autoreport_poll() {
+    if (!autoreport_any)
+        return (portMAX_DELAY);
+    uint32_t now = millis();
+    uint32_t wait = UINT32_MAX;
+    char snapshot[STATUS_REPORT_SIZE];
+    bool built = false;
+    for (uint8_t client = 0; client < CLIENT_COUNT; client++) {
+        autoreport_t* ar = &autoreport[client];
+        if (ar->interval == 0)
+            continue;
+        if ((int32_t)(now - ar->next) < 0) {
+            wait = MIN(wait, ar->next - now);
+            continue;
+        }
+        ar->next += ar->interval;
+        if ((int32_t)(now - ar->next) >= 0)
+            ar->next = now + ar->interval; // Fell behind, do not send a burst to catch up
+        wait = MIN(wait, ar->next - now);
+        if (!built) {
+            ReportWriter fields(snapshot, sizeof(snapshot));
+            report_realtime_fields(fields, CLIENT_ALL, true);
+            built = true;
+        }
+        char buffer[STATUS_REPORT_SIZE];
+        ReportWriter fields(buffer, sizeof(buffer) - 3); // Room for the ">\r\n"
+        fields.put(snapshot);
+#ifdef REPORT_FIELD_BUFFER_STATE
+        report_buffer_state(fields, client);
+#endif
+        if (ar->changed) {
+            char changed[STATUS_REPORT_SIZE + 32];
+            ReportWriter status(changed, sizeof(changed) - 3);
+            report_changed_fields(status, buffer, ar->last);
+            strcpy(ar->last, buffer);
+            strcpy(changed + status.length(), ">\r\n");
+            grbl_send(client, changed);
+        } else {
+            strcpy(buffer + fields.length(), ">\r\n");
+            grbl_send(client, buffer);
+        }
+    }
+    if (wait == UINT32_MAX)
+        return (portMAX_DELAY);
+    return (MAX(pdMS_TO_TICKS(wait), 1));
+}
+
+// Times building a status report, and the axis values with sprintf against ReportWriter. Also
+// checks that both give the same digits over a spread of values.
+void report_benchmark(uint8_t client) {
+    const uint32_t runs = 100;
+    char buffer[STATUS_REPORT_SIZE];
+    char expected[24];
+    float axes[N_AXIS];
+    for (uint8_t idx = 0; idx < N_AXIS; idx++)
+        axes[idx] = (idx & 1) ? -1234.5678f / (idx + 1) : 98.7654f * (idx + 1);
+    // Keep the best of several passes to filter out interrupts and cache misses.
+    uint32_t best_report = UINT32_MAX;
+    uint32_t best_sprintf = UINT32_MAX;
+    uint32_t best_writer = UINT32_MAX;
+    for (uint8_t pass = 0; pass < 8; pass++) {
+        uint32_t start = ESP.getCycleCount();
+        for (uint32_t run = 0; run < runs; run++) {
+            ReportWriter status(buffer, sizeof(buffer));
+            report_realtime_fields(status, CLIENT_ALL, true);
+        }
+        best_report = MIN(best_report, ESP.getCycleCount() - start);
+        start = ESP.getCycleCount();
+        for (uint32_t run = 0; run < runs; run++) {
+            buffer[0] = '\0';
+            for (uint8_t idx = 0; idx < N_AXIS; idx++) {
+                sprintf(expected, "%4.3f", axes[idx]);
+                strcat(buffer, expected);
+                if (idx < (N_AXIS - 1))
+                    strcat(buffer, ",");
+            }
+        }
+        best_sprintf = MIN(best_sprintf, ESP.getCycleCount() - start);
+        start = ESP.getCycleCount();
+        for (uint32_t run = 0; run < runs; run++) {
+            ReportWriter values(buffer, sizeof(buffer));
+            for (uint8_t idx = 0; idx < N_AXIS; idx++) {
+                if (idx)
+                    values.put(',');
+                values.put_fixed(axes[idx], 3);
+            }
+        }
+        best_writer = MIN(best_writer, ESP.getCycleCount() - start);
+    }
+    uint32_t mismatches = 0;
+    for (int32_t step = -1000; step <= 1000; step++) {
+        float value = step * 12.3457f + step * 0.00005f;
+        for (uint8_t decimals = 0; decimals <= 4; decimals++) {
+            ReportWriter digits(buffer, sizeof(buffer));
+            digits.put_fixed(value, decimals);
+            sprintf(expected, "%.*f", decimals, value);
+            if (strcmp(buffer, expected))
+                mismatches++;
+        }
+    }
+    grbl_sendf(client, "[MSG:Status report %d cycles]\r\n", best_report / runs);
+    grbl_sendf(client, "[MSG:%d axes sprintf %d cycles writer %d cycles]\r\n", N_AXIS, best_sprintf / runs,
+               best_writer / runs);
+    grbl_sendf(client, "[MSG:Writer mismatches %d]\r\n", mismatches);
 }
 
 void report_realtime_steps() {
@@ -61,6 +61,7 @@
 #define STATUS_GCODE_G43_DYNAMIC_AXIS_ERROR 37
 #define STATUS_GCODE_MAX_VALUE_EXCEEDED 38
 #define STATUS_P_PARAM_MAX_EXCEEDED 39
+#define STATUS_GCODE_SPLINE_PLANE 40
 
 #define STATUS_SD_FAILED_MOUNT 60 // SD Failed to mount
 #define STATUS_SD_FAILED_READ 61 // SD Failed to read file
@@ -129,6 +130,32 @@ const char* errorString(err_t errorNumber);
 #define MSG_LEVEL_DEBUG		4
 #define MSG_LEVEL_VERBOSE	5
 
+// Appends text and numbers to a caller buffer, without the heap and without libc float
+// formatting. Output that does not fit is cut short and the buffer stays terminated.
+class ReportWriter {
+  public:
+    ReportWriter(char* buffer, size_t size);
+    void put(char c);
+    void put(const char* text);
+    void put(const char* text, size_t length);
+    void put_int(int32_t value);
+    void put_uint(uint32_t value);
+    void put_fixed(float value, uint8_t decimals);       // Same digits as printf("%.<decimals>f")
+    void put_axes(float* values);                        // Axis values in the report units
+    void put_vformat(const char* format, va_list args);  // For [MSG:] text. Floats still go through libc.
+    const char* c_str() { return _buffer; }
+    size_t length() { return _length; }
+    bool truncated() { return _truncated; }
+  private:
+    void put_uint64(uint64_t value, uint8_t min_digits);
+    char* _buffer;
+    size_t _size;
+    size_t _length;
+    bool _truncated;
+};
+
+#define GRBL_SENDF_SIZE 256  // Longest line of grbl_sendf() and grbl_msg_sendf(), on the stack
+
 // functions to send data to the user.
 void grbl_send(uint8_t client, const char* text);
 void grbl_sendf(uint8_t client, const char* format, ...);
@@ -160,9 +187,22 @@ void report_grbl_settings(uint8_t client, uint8_t show_extended);
 // Prints an echo of the pre-parsed line received right before execution.
 void report_echo_line_received(char* line, uint8_t client);
 
+#define STATUS_REPORT_SIZE 384  // 6 axes with MPos and WCO, every other field and a SD file name
+
 // Prints realtime status report
 void report_realtime_status(uint8_t client);
 
+// Autoreports push the status report to a subscribed client every interval, so senders need not
+// poll with '?'. Set with $RA=<msec>, or $RA=<msec>,C for only the fields that changed since the
+// last one; $RA=0 stops them.
+#define AUTOREPORT_MIN_INTERVAL 20  // msec
+err_t report_autoreport_set(uint8_t client, uint32_t interval, bool changed);
+// Stops the autoreports of a client, or of all of them with CLIENT_ALL.
+void report_autoreport_reset(uint8_t client);
+void report_autoreport(uint8_t client);
+// Sends the autoreports that are due. Returns the ticks until the next one.
+TickType_t report_autoreport_poll();
+
 // Prints recorded probe position
 void report_probe_parameters(uint8_t client);
 
@@ -192,4 +232,7 @@ void report_hex_msg(uint8_t* buf, const char *prefix, int len);
 
 char report_get_axis_letter(uint8_t axis);
 
+// Times the status report and the axis formatting against sprintf.
+void report_benchmark(uint8_t client);
+
 #endif
@@ -57,86 +57,215 @@
 
 #include "grbl.h"
 
-portMUX_TYPE myMutex = portMUX_INITIALIZER_UNLOCKED;
-
 static TaskHandle_t serialCheckTaskHandle = 0;
+static QueueHandle_t serial_uart_queue;
+
+static uint8_t serial_rx_storage[SERIAL_RX_BUFFER_SIZE];
+static uint8_t bt_rx_storage[BT_RX_BUFFER_SIZE];
+static uint8_t webui_rx_storage[WEBUI_RX_BUFFER_SIZE];
+static uint8_t telnet_rx_storage[TELNET_RX_BUFFER_SIZE];
+static uint8_t input_rx_storage[INPUT_RX_BUFFER_SIZE];
+
+RxRing client_buffer[CLIENT_COUNT];  // create a buffer for each client
+
+void RxRing::begin(uint8_t* buffer, uint16_t size) {
+    _buffer = buffer;
+    _size = size;
+    _head = 0;
+    _tail = 0;
+}
+
+bool RxRing::write(uint8_t c) {
+    uint32_t head = _head;
+    uint32_t next = head + 1;
+    if (next == _size)
+        next = 0;
+    if (next == __atomic_load_n(&_tail, __ATOMIC_ACQUIRE))
+        return false; // Full. Keep one slot free to tell full from empty.
+    _buffer[head] = c;
+    __atomic_store_n(&_head, next, __ATOMIC_RELEASE);
+    return true;
+}
+
+int RxRing::read() {
+    uint32_t tail = _tail;
+    if (tail == __atomic_load_n(&_head, __ATOMIC_ACQUIRE))
+        return -1;
+    uint8_t c = _buffer[tail];
+    if (++tail == _size)
+        tail = 0;
+    __atomic_store_n(&_tail, tail, __ATOMIC_RELEASE);
+    return c;
+}
+
+void RxRing::clear() {
+    __atomic_store_n(&_tail, __atomic_load_n(&_head, __ATOMIC_ACQUIRE), __ATOMIC_RELEASE);
+}
+
+uint16_t RxRing::available() {
+    uint32_t head = _head;
+    uint32_t tail = _tail;
+    if (head >= tail)
+        return head - tail;
+    return _size - (tail - head);
+}
+
+uint16_t RxRing::availableforwrite() {
+    return (_size - 1) - available();
+}
+
+// Returns the free space in a client buffer. For the serial port, bytes already received by the
+// UART driver but not yet moved to the ring are taken off, since they will land there.
+uint16_t serial_get_rx_buffer_available(uint8_t client) {
+    int available = client_buffer[client].availableforwrite();
+    if (client == CLIENT_SERIAL) {
+        size_t buffered = 0;
+        uart_get_buffered_data_len(SERIAL_UART, &buffered);
+        available -= buffered;
+    }
+    return (available > 0) ? available : 0;
+}
 
-InputBuffer client_buffer[CLIENT_COUNT];  // create a buffer for each client
+static void serialUartTask(void* pvParameters);
+static void serialServiceTask(void* pvParameters);
 
-// Returns the number of bytes available in a client buffer.
-uint8_t serial_get_rx_buffer_available(uint8_t client) {
-    return client_buffer[client].availableforwrite();
+// The UART runs on the ESP-IDF driver rather than the Arduino one, since only the IDF driver
+// reports received data, through its event queue.
+static void serial_uart_init() {
+    uart_config_t uart_config;
+    memset(&uart_config, 0, sizeof(uart_config));
+    uart_config.baud_rate = BAUD_RATE;
+    uart_config.data_bits = UART_DATA_8_BITS;
+    uart_config.parity = UART_PARITY_DISABLE;
+    uart_config.stop_bits = UART_STOP_BITS_1;
+    uart_config.flow_ctrl = UART_HW_FLOWCTRL_DISABLE;
+    uart_param_config(SERIAL_UART, &uart_config);
+    uart_set_pin(SERIAL_UART, SERIAL_UART_TX_PIN, SERIAL_UART_RX_PIN, UART_PIN_NO_CHANGE, UART_PIN_NO_CHANGE);
+    uart_driver_install(SERIAL_UART, SERIAL_UART_RX_BUFFER_SIZE, 0, SERIAL_UART_QUEUE_SIZE, &serial_uart_queue, 0);
+    // The driver reports data when the FIFO fills or the line has been idle for rx_timeout_thresh
+    // characters, 10 by default. Shorten the idle time, so a lone realtime command is not held.
+    uart_intr_config_t uart_intr;
+    uart_intr.intr_enable_mask = UART_RXFIFO_FULL_INT_ENA_M | UART_RXFIFO_TOUT_INT_ENA_M | UART_FRM_ERR_INT_ENA_M |
+                                 UART_RXFIFO_OVF_INT_ENA_M | UART_BRK_DET_INT_ENA_M | UART_PARITY_ERR_INT_ENA_M;
+    uart_intr.rx_timeout_thresh = SERIAL_UART_RX_TIMEOUT;
+    uart_intr.txfifo_empty_intr_thresh = 10;  // Driver default
+    uart_intr.rxfifo_full_thresh = 120;       // Driver default
+    uart_intr_config(SERIAL_UART, &uart_intr);
 }
 
 void serial_init() {
-    Serial.begin(BAUD_RATE);
+    serial_uart_init();
+    client_buffer[CLIENT_SERIAL].begin(serial_rx_storage, SERIAL_RX_BUFFER_SIZE);
+    client_buffer[CLIENT_BT].begin(bt_rx_storage, BT_RX_BUFFER_SIZE);
+    client_buffer[CLIENT_WEBUI].begin(webui_rx_storage, WEBUI_RX_BUFFER_SIZE);
+    client_buffer[CLIENT_TELNET].begin(telnet_rx_storage, TELNET_RX_BUFFER_SIZE);
+    client_buffer[CLIENT_INPUT].begin(input_rx_storage, INPUT_RX_BUFFER_SIZE);
     // reset all buffers
     serial_reset_read_buffer(CLIENT_ALL);
     grbl_send(CLIENT_SERIAL, "\r\n"); // create some white space after ESP32 boot info
     serialCheckTaskHandle = 0;
-    // create a task to check for incoming data
+    // create a task to check for incoming data. It sleeps until notified and only moves bytes, so
+    // it runs above the protocol loop to act on realtime commands as soon as they arrive.
     xTaskCreatePinnedToCore(serialCheckTask,     // task
                             "serialCheckTask", // name for task
                             8192,   // size of task stack
                             NULL,   // parameters
-                            1, // priority
+                            SERIAL_CHECK_TASK_PRIORITY, // priority
                             &serialCheckTaskHandle,
                             1 // core
                            );
+    xTaskCreatePinnedToCore(serialUartTask,     // task
+                            "serialUartTask", // name for task
+                            2048,   // size of task stack
+                            NULL,   // parameters
+                            SERIAL_CHECK_TASK_PRIORITY, // priority
+                            NULL,
+                            1 // core
+                           );
+    // The network, Bluetooth and WebUI services can run for a long time, e.g. to serve a file,
+    // so they stay at the priority of the protocol loop.
+    xTaskCreatePinnedToCore(serialServiceTask,     // task
+                            "serialServiceTask", // name for task
+                            8192,   // size of task stack
+                            NULL,   // parameters
+                            SERIAL_SERVICE_TASK_PRIORITY, // priority
+                            NULL,
+                            1 // core
+                           );
 }
 
 
-// this task runs and checks for data on all interfaces
-// REaltime stuff is acted upon, then characters are added to the appropriate buffer
-void serialCheckTask(void* pvParameters) {
-    uint8_t data = 0;
-    uint8_t client = CLIENT_ALL; // who sent the data
-    while (true) { // run continuously
-        while (any_client_has_data()) {
-            if (Serial.available()) {
-                client = CLIENT_SERIAL;
-                data = Serial.read();
-            } else if (inputBuffer.available()) {
-                client = CLIENT_INPUT;
-                data = inputBuffer.read();
-            } else {
-                //currently is wifi or BT but better to prepare both can be live
+// Reads up to size bytes that a client has already received, without waiting for more.
+static size_t serial_read_client(uint8_t client, uint8_t* buffer, size_t size) {
+    size_t count = 0;
+    int available;
+    switch (client) {
+    case CLIENT_SERIAL: {
+        size_t buffered = 0;
+        uart_get_buffered_data_len(SERIAL_UART, &buffered);
+        if (buffered > 0) {
+            int read = uart_read_bytes(SERIAL_UART, buffer, MIN(buffered, size), 0);
+            count = (read > 0) ? read : 0;
+        }
+        break;
+    }
+    case CLIENT_INPUT:
+        while (count < size && inputBuffer.available())
+            buffer[count++] = inputBuffer.read();
+        break;
 #ifdef ENABLE_BLUETOOTH
-                if (SerialBT.hasClient() && SerialBT.available()) {
-                    client = CLIENT_BT;
-                    data = SerialBT.read();
-                    //Serial.write(data);  // echo all data to serial
-                } else {
+    case CLIENT_BT:
+        if (SerialBT.hasClient()) {
+            available = SerialBT.available();
+            if (available > 0)
+                count = SerialBT.readBytes(buffer, MIN((size_t)available, size));
+        }
+        break;
 #endif
 #if defined (ENABLE_WIFI) && defined(ENABLE_HTTP)  && defined(ENABLE_SERIAL2SOCKET_IN)
-                    if (Serial2Socket.available()) {
-                        client = CLIENT_WEBUI;
-                        data = Serial2Socket.read();
-                    } else {
+    case CLIENT_WEBUI:
+        while (count < size && Serial2Socket.available())
+            buffer[count++] = Serial2Socket.read();
+        break;
 #endif
 #if defined (ENABLE_WIFI) && defined(ENABLE_TELNET)
-                        if (telnet_server.available()) {
-                            client = CLIENT_TELNET;
-                            data = telnet_server.read();
-                        }
-#endif
-#if defined (ENABLE_WIFI) && defined(ENABLE_HTTP)  && defined(ENABLE_SERIAL2SOCKET_IN)
-                    }
-#endif
-#ifdef ENABLE_BLUETOOTH
-                }
+    case CLIENT_TELNET:
+        while (count < size && telnet_server.available())
+            buffer[count++] = telnet_server.read();
+        break;
 #endif
-            }
-            // Pick off realtime command characters directly from the serial stream. These characters are
-            // not passed into the main buffer, but these set system state flag bits for realtime execution.
-            if (is_realtime_command(data))
-                execute_realtime_command(data, client);
-            else {
-                vTaskEnterCritical(&myMutex);
-                client_buffer[client].write(data);
-                vTaskExitCritical(&myMutex);
-            }
-        }  // if something available
+    }
+    return count;
+}
+
+// Wakes serialCheckTask(). Called by the receive paths when a client has new data. Safe from an
+// interrupt as well as from a task.
+void serial_notify_rx() {
+    if (serialCheckTaskHandle == 0)
+        return;
+    if (xPortInIsrContext()) {
+        BaseType_t higherPriorityTaskWoken = pdFALSE;
+        vTaskNotifyGiveFromISR(serialCheckTaskHandle, &higherPriorityTaskWoken);
+        if (higherPriorityTaskWoken)
+            portYIELD_FROM_ISR();
+    } else
+        xTaskNotifyGive(serialCheckTaskHandle);
+}
+
+// Passes the UART driver events on to serialCheckTask(). All of them mean there is data to read,
+// or that it was lost and the rest should be read quickly.
+static void serialUartTask(void* pvParameters) {
+    uart_event_t event;
+    while (true) {
+        if (xQueueReceive(serial_uart_queue, &event, portMAX_DELAY))
+            serial_notify_rx();
+    }
+}
+
+// Runs the network, Bluetooth and WebUI services. Telnet input wakes it early, since the telnet
+// server only moves socket data to its buffer in here.
+static void serialServiceTask(void* pvParameters) {
+    while (true) {
         COMMANDS::handle();
 #ifdef ENABLE_WIFI
         wifi_config.handle();
@@ -147,49 +276,66 @@ void serialCheckTask(void* pvParameters) {
 #if defined (ENABLE_WIFI) && defined(ENABLE_HTTP) && defined(ENABLE_SERIAL2SOCKET_IN)
         Serial2Socket.handle_flush();
 #endif
-        vTaskDelay(1 / portTICK_RATE_MS);  // Yield to other tasks
+#if defined (ENABLE_WIFI) && defined(ENABLE_TELNET)
+        telnet_server.wait(SERIAL_SERVICE_MS);
+#else
+        vTaskDelay(SERIAL_SERVICE_MS / portTICK_PERIOD_MS);
+#endif
+    }
+}
+
+// this task runs and checks for data on all interfaces
+// REaltime stuff is acted upon, then characters are added to the appropriate buffer
+void serialCheckTask(void* pvParameters) {
+    uint8_t buffer[SERIAL_READ_CHUNK];
+    while (true) { // run continuously
+        for (uint8_t client = 0; client < CLIENT_COUNT; client++) {
+            size_t count;
+            while ((count = serial_read_client(client, buffer, SERIAL_READ_CHUNK)) > 0) {
+                for (size_t i = 0; i < count; i++) {
+                    uint8_t data = buffer[i];
+                    // A client in binary stream mode has its own framing, which also handles realtime commands.
+                    if (binary_stream_receiving(client))
+                        binary_stream_receive(data);
+                    // Pick off realtime command characters directly from the serial stream. These characters are
+                    // not passed into the main buffer, but these set system state flag bits for realtime execution.
+                    else if (is_realtime_command(data))
+                        execute_realtime_command(data, client);
+                    else
+                        client_buffer[client].write(data);
+                }
+            }
+        }
+        // Sleep until a receive path has data, or the next status autoreport is due.
+        ulTaskNotifyTake(pdTRUE, report_autoreport_poll());
     }  // while(true)
 }
 
 void serial_reset_read_buffer(uint8_t client) {
     for (uint8_t client_num = 0; client_num < CLIENT_COUNT; client_num++) {
         if (client == client_num || client == CLIENT_ALL)
-            client_buffer[client_num].begin();
+            client_buffer[client_num].clear();
     }
+    binary_stream_reset(client);
+    report_autoreport_reset(client);
 }
 
 // Writes one byte to the TX serial buffer. Called by main program.
 void serial_write(uint8_t data) {
-    Serial.write((char)data);
+    uart_write_bytes(SERIAL_UART, (const char*)&data, 1);
+}
+
+// Writes a string to the TX serial buffer.
+void serial_write_text(const char* text) {
+    uart_write_bytes(SERIAL_UART, text, strlen(text));
 }
 
 // Fetches the first byte in the serial read buffer. Called by protocol loop.
 uint8_t serial_read(uint8_t client) {
-    uint8_t data;
-    vTaskEnterCritical(&myMutex);
-    if (client_buffer[client].available()) {
-        data = client_buffer[client].read();
-        vTaskExitCritical(&myMutex);
-        //Serial.write((char)data);
-        return data;
-    } else {
-        vTaskExitCritical(&myMutex);
+    int data = client_buffer[client].read();
+    if (data < 0)
         return SERIAL_NO_DATA;
-    }
-}
-
-bool any_client_has_data() {
-    return (Serial.available() || inputBuffer.available()
-#ifdef ENABLE_BLUETOOTH
-            || (SerialBT.hasClient() && SerialBT.available())
-#endif
-#if defined (ENABLE_WIFI) && defined(ENABLE_HTTP) && defined(ENABLE_SERIAL2SOCKET_IN)
-            || Serial2Socket.available()
-#endif
-#if defined (ENABLE_WIFI) && defined(ENABLE_TELNET)
-            || telnet_server.available()
-#endif
-           );
+    return data;
 }
 
 // checks to see if a character is a realtime character
@@ -24,7 +24,24 @@
 #include "grbl.h"
 
 #ifndef RX_BUFFER_SIZE
-    #define RX_BUFFER_SIZE 128
+    #define RX_BUFFER_SIZE 256
+#endif
+// Receive ring size of each client. All default to RX_BUFFER_SIZE. Streaming senders read the
+// free space from the Bf: status field, so a deeper ring lets them keep more lines in flight.
+#ifndef SERIAL_RX_BUFFER_SIZE
+    #define SERIAL_RX_BUFFER_SIZE RX_BUFFER_SIZE
+#endif
+#ifndef BT_RX_BUFFER_SIZE
+    #define BT_RX_BUFFER_SIZE RX_BUFFER_SIZE
+#endif
+#ifndef WEBUI_RX_BUFFER_SIZE
+    #define WEBUI_RX_BUFFER_SIZE RX_BUFFER_SIZE
+#endif
+#ifndef TELNET_RX_BUFFER_SIZE
+    #define TELNET_RX_BUFFER_SIZE RX_BUFFER_SIZE
+#endif
+#ifndef INPUT_RX_BUFFER_SIZE
+    #define INPUT_RX_BUFFER_SIZE RX_BUFFER_SIZE
 #endif
 #ifndef TX_BUFFER_SIZE
     #ifdef USE_LINE_NUMBERS
@@ -36,10 +53,41 @@
 
 #define SERIAL_NO_DATA 0xff
 
+#define SERIAL_CHECK_TASK_PRIORITY 2    // Above the protocol loop, below the segment prep task
+#define SERIAL_SERVICE_TASK_PRIORITY 1  // Network and WebUI services. Same as the protocol loop.
+#define SERIAL_SERVICE_MS 10            // Service period when no telnet data comes in
+#define SERIAL_READ_CHUNK 64            // Bytes read from a client at a time
+
+#define SERIAL_UART UART_NUM_0
+#define SERIAL_UART_TX_PIN 1
+#define SERIAL_UART_RX_PIN 3
+#define SERIAL_UART_RX_BUFFER_SIZE 512  // Driver ring. Must be larger than the 128 byte FIFO.
+#define SERIAL_UART_QUEUE_SIZE 20       // Driver events
+#define SERIAL_UART_RX_TIMEOUT 2        // Idle characters before received data is reported
+
+// Receive ring of one client. serialCheckTask() is the only writer and the protocol loop the only
+// reader. Each side only moves its own index and publishes it with release ordering after the data,
+// so neither needs a critical section.
+class RxRing {
+  public:
+    void begin(uint8_t* buffer, uint16_t size);
+    bool write(uint8_t c);           // Producer. False if the ring is full.
+    int read();                      // Consumer. -1 if the ring is empty.
+    void clear();                    // Consumer. Drops everything written so far.
+    uint16_t available();
+    uint16_t availableforwrite();
+  private:
+    uint8_t* _buffer;
+    uint16_t _size;
+    volatile uint32_t _head;         // Next write position. Producer only.
+    volatile uint32_t _tail;         // Next read position. Consumer only.
+};
+
 // a task to read for incoming data from serial port
 void serialCheckTask(void* pvParameters);
 
 void serial_write(uint8_t data);
+void serial_write_text(const char* text);
 // Fetches the first byte in the serial read buffer. Called by main program.
 uint8_t serial_read(uint8_t client);
 
@@ -49,11 +97,14 @@ uint8_t check_action_command(uint8_t data);
 void serial_init();
 void serial_reset_read_buffer(uint8_t client);
 
-// Returns the number of bytes available in the RX serial buffer.
-uint8_t serial_get_rx_buffer_available(uint8_t client);
+// Returns the number of bytes that can still be sent to a client without overflowing it.
+uint16_t serial_get_rx_buffer_available(uint8_t client);
 
 void execute_realtime_command(uint8_t command, uint8_t client);
-bool any_client_has_data();
+
+// Wakes the input task when a client has received data, or when it must work out its sleep again.
+// ISR safe.
+void serial_notify_rx();
 bool is_realtime_command(uint8_t data);
 
 #endif
@@ -31,6 +31,8 @@
 #include <WebSocketsServer.h>
 #include <WiFi.h>
 Serial_2_Socket Serial2Socket;
+// The receive buffer is filled by the web server in the service task and read by serialCheckTask()
+static portMUX_TYPE socket_rx_mutex = portMUX_INITIALIZER_UNLOCKED;
 
 
 Serial_2_Socket::Serial_2_Socket() {
@@ -120,6 +122,7 @@ int Serial_2_Socket::peek(void) {
 bool Serial_2_Socket::push(const char* data) {
 #if defined(ENABLE_SERIAL2SOCKET_IN)
     int data_size = strlen(data);
+    vTaskEnterCritical(&socket_rx_mutex);
     if ((data_size + _RXbufferSize) <= RXBUFFERSIZE) {
         int current = _RXbufferpos + _RXbufferSize;
         if (current > RXBUFFERSIZE) current = current - RXBUFFERSIZE;
@@ -128,9 +131,12 @@ bool Serial_2_Socket::push(const char* data) {
             _RXbuffer[current] = data[i];
             current ++;
         }
-        _RXbufferSize += strlen(data);
+        _RXbufferSize += data_size;
+        vTaskExitCritical(&socket_rx_mutex);
+        serial_notify_rx();
         return true;
     }
+    vTaskExitCritical(&socket_rx_mutex);
     return false;
 #else
     return true;
@@ -138,13 +144,16 @@ bool Serial_2_Socket::push(const char* data) {
 }
 
 int Serial_2_Socket::read(void) {
+    int v = -1;
+    vTaskEnterCritical(&socket_rx_mutex);
     if (_RXbufferSize > 0) {
-        int v = _RXbuffer[_RXbufferpos];
+        v = _RXbuffer[_RXbufferpos];
         _RXbufferpos++;
         if (_RXbufferpos > (RXBUFFERSIZE - 1))_RXbufferpos = 0;
         _RXbufferSize--;
-        return v;
-    } else return -1;
+    }
+    vTaskExitCritical(&socket_rx_mutex);
+    return v;
 }
 
 void Serial_2_Socket::handle_flush() {
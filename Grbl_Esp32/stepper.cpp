@@ -59,19 +59,7 @@ static segment_t segment_buffer[SEGMENT_BUFFER_SIZE];
 // Stepper ISR data struct. Contains the running data for the main stepper ISR.
 typedef struct {
     // Used by the bresenham line algorithm
-    uint32_t counter_x,        // Counter variables for the bresenham line tracer
-             counter_y,
-             counter_z
-#if (N_AXIS > A_AXIS)
-             , counter_a
-#endif
-#if (N_AXIS > B_AXIS)
-             , counter_b
-#endif
-#if (N_AXIS > C_AXIS)
-             , counter_c
-#endif
-             ;
+    uint32_t counter[N_AXIS];  // Counter variables for the bresenham line tracer
 #ifdef STEP_PULSE_DELAY
     uint8_t step_bits;  // Stores out_bits output to complete the step pulse delay
 #endif
@@ -96,6 +84,11 @@ static volatile uint8_t segment_buffer_tail;
 static uint8_t segment_buffer_head;
 static uint8_t segment_next_head;
 
+// Motion time in the segment buffer, in step timer ticks. Each side only writes its own running
+// total, so the difference is the queued time without any locking between the ISR and the prep.
+static volatile uint32_t segment_ticks_prepped;   // Added by st_prep_buffer()
+static volatile uint32_t segment_ticks_executed;  // Added by the stepper ISR as segments complete
+
 // Step and direction port invert masks.
 static uint8_t step_port_invert_mask;
 static uint8_t dir_port_invert_mask;
@@ -108,6 +101,13 @@ static volatile uint8_t busy;
 static plan_block_t* pl_block;     // Pointer to the planner block being prepped
 static st_block_t* st_prep_block;  // Pointer to the stepper block data being prepped
 
+// The prep state above and the planner buffer are shared by the protocol loop and the segment prep
+// task. Recursive, since the planner calls back into the stepper with the lock already held.
+static SemaphoreHandle_t st_prep_mutex = NULL;
+#ifdef USE_SEGMENT_PREP_TASK
+static TaskHandle_t segmentPrepTaskHandle = NULL;
+#endif
+
 // esp32 work around for diable in main loop
 uint64_t stepper_idle_counter; // used to count down until time to disable stepper drivers
 bool stepper_idle;
@@ -139,6 +139,17 @@ typedef struct {
     float accelerate_until; // Acceleration ramp end measured from end of block (mm)
     float decelerate_after; // Deceleration ramp start measured from end of block (mm)
 
+    // Jerk-limited ramp state, used when $Stepper/Profile is SCURVE. See st_scurve_setup().
+    bool  ramp_scurve;      // True while the current accel or decel ramp follows an S-curve
+    float ramp_start_mm;    // Distance from end of block where the ramp began (mm)
+    float ramp_end_mm;      // Distance from end of block where the ramp ends (mm)
+    float ramp_start_speed; // Speed at the start of the ramp (mm/min)
+    float ramp_time;        // Time elapsed in the ramp (min)
+    float ramp_duration;    // Total ramp time. Same as the trapezoidal ramp it replaces (min)
+    float ramp_jerk_time;   // Duration of each of the two constant-jerk phases (min)
+    float ramp_accel;       // Signed peak acceleration of the ramp (mm/min^2)
+    float ramp_jerk;        // Signed jerk of the ramp (mm/min^3)
+
 
     float inv_rate;    // Used by PWM laser mode to speed up segment calculations.
     //uint16_t current_spindle_pwm;  // todo remove
@@ -199,7 +210,7 @@ static st_prep_t prep;
 		An optional (via STEP_PULSE_DELAY in config.h) is put after this
 		The step pin is started
 		A pulse length is determine (via option $0 ... pulse_microseconds)
-		The pulse is ended
+		The pulse is ended (by RMT, I2S or the one-shot step pulse off timer)
 		Direction will remain the same until another step occurs with a change in direction.
 
 
@@ -210,10 +221,37 @@ static st_prep_t prep;
 
 static void stepper_pulse_func();
 
+// Bresenham step kernel for one axis. Each instance tail-calls the next axis, so the compiler
+// unrolls the whole N_AXIS chain into straight-line code, just like the hand-written per-axis
+// blocks it replaces. The position update is branch-free: a set direction bit means -1.
+template <uint8_t axis>
+inline __attribute__((always_inline)) void st_bresenham_axes() {
+#ifdef ADAPTIVE_MULTI_AXIS_STEP_SMOOTHING
+    st.counter[axis] += st.steps[axis];
+#else
+    st.counter[axis] += st.exec_block->steps[axis];
+#endif
+    if (st.counter[axis] > st.exec_block->step_event_count) {
+        st.step_outbits |= bit(axis);
+        st.counter[axis] -= st.exec_block->step_event_count;
+        sys_position[axis] += 1 - (int32_t)(((st.exec_block->direction_bits >> axis) & 1) << 1);
+    }
+    st_bresenham_axes<axis + 1>();
+}
+
+template <>
+inline __attribute__((always_inline)) void st_bresenham_axes<N_AXIS>() {}
+
 // TODO: Replace direct updating of the int32 position counters in the ISR somehow. Perhaps use smaller
 // int8 variables and update position counters only when a segment completes. This can get complicated
 // with probing and homing cycles that require true real-time positions.
 void IRAM_ATTR onStepperDriverTimer(void* para) { // ISR It is time to take a step =======================================================================================
+#ifdef STEPPER_ISR_TIMING
+    // The timer auto reloads at the alarm, so its count is how late this ISR started.
+    uint32_t entry = xthal_get_ccount();
+    TIMERG0.hw_timer[STEP_TIMER_INDEX].update = 1;
+    uint32_t latency = TIMERG0.hw_timer[STEP_TIMER_INDEX].cnt_low;
+#endif
     //const int timer_idx = (int)para;  // get the timer index
     TIMERG0.int_clr_timers.t0 = 1;
     if (busy) {
@@ -225,29 +263,56 @@ void IRAM_ATTR onStepperDriverTimer(void* para) { // ISR It is time to take a st
 
     TIMERG0.hw_timer[STEP_TIMER_INDEX].config.alarm_en = TIMER_ALARM_EN;
     busy = false;
+#ifdef STEPPER_ISR_TIMING
+#ifdef USE_RMT_STEPS
+    st_timing_record(ST_TIMING_RMT, entry, xthal_get_ccount(), latency);
+#else
+    st_timing_record(ST_TIMING_GPIO, entry, xthal_get_ccount(), latency);
+#endif
+#endif
 }
 
-/**
- * This phase of the ISR should ONLY create the pulses for the steppers.
- * This prevents jitter caused by the interval between the start of the
- * interrupt and the start of the pulses. DON'T add any logic ahead of the
- * call to this method that might cause variation in the timing. The aim
- * is to keep pulse timing as regular as possible.
- */
-static void stepper_pulse_func() {
-    motors_set_direction_pins(st.dir_outbits);
-#ifdef USE_RMT_STEPS
-    stepperRMT_Outputs();
+#if defined(STEPPER_ISR_TIMING) && defined(USE_I2S_OUT_STREAM)
+// The I2S task runs the pulse callback ahead of the DMA output, so only its duration means anything.
+static void stepper_timed_pulse_func() {
+    uint32_t entry = xthal_get_ccount();
+    stepper_pulse_func();
+    st_timing_record(ST_TIMING_I2S, entry, xthal_get_ccount(), UINT32_MAX);
+}
+#define STEPPER_I2S_PULSE_CALLBACK stepper_timed_pulse_func
 #else
-    set_stepper_pins_on(st.step_outbits);
-#ifndef USE_I2S_OUT_STREAM
-    uint64_t step_pulse_start_time = esp_timer_get_time();
+#define STEPPER_I2S_PULSE_CALLBACK stepper_pulse_func
 #endif
+
+#if !defined(USE_RMT_STEPS) && !defined(USE_I2S_OUT_STREAM)
+// ISR It is time to end the step pulse. The step ISR arms this one-shot alarm when it sets the
+// step pins, so it can return right away instead of spinning for the $0 pulse time.
+void IRAM_ATTR onStepperOffTimer(void* para) {
+    TIMERG0.int_clr_timers.t1 = 1;
+    set_stepper_pins_on(0); // turn all off
+}
 #endif
 
-    // some motor objects, like unipolar, handle steps themselves
-    motors_step(st.step_outbits, st.dir_outbits);
+// Wakes the segment prep task. The step ISR and the I2S task both consume segments, so this
+// checks which context it is called from.
+static inline void st_prep_notify() {
+#ifdef USE_SEGMENT_PREP_TASK
+    if (segmentPrepTaskHandle == NULL)
+        return;
+    if (xPortInIsrContext()) {
+        BaseType_t higherPriorityTaskWoken = pdFALSE;
+        vTaskNotifyGiveFromISR(segmentPrepTaskHandle, &higherPriorityTaskWoken);
+        if (higherPriorityTaskWoken)
+            portYIELD_FROM_ISR();
+    } else
+        xTaskNotifyGive(segmentPrepTaskHandle);
+#endif
+}
 
+// Loads the next segment if needed and runs one Bresenham step for it, leaving the step bits to
+// output on the next step period in st.step_outbits. Returns false when the segment buffer ran
+// dry and the steppers were stopped. Shared by the step ISR and the I2S segment renderer.
+static inline bool stepper_next_step() {
     // If there is no step segment, attempt to pop one from the stepper buffer
     if (st.exec_segment == NULL) {
         // Anything in the buffer? If so, load and initialize next step segment.
@@ -263,24 +328,14 @@ static void stepper_pulse_func() {
                 st.exec_block_index = st.exec_segment->st_block_index;
                 st.exec_block = &st_block_buffer[st.exec_block_index];
                 // Initialize Bresenham line and distance counters
-                st.counter_x = st.counter_y = st.counter_z = (st.exec_block->step_event_count >> 1);
-                // TODO ABC
+                for (uint8_t idx = 0; idx < N_AXIS; idx++)
+                    st.counter[idx] = (st.exec_block->step_event_count >> 1);
             }
             st.dir_outbits = st.exec_block->direction_bits ^ dir_invert_mask->get();
 #ifdef ADAPTIVE_MULTI_AXIS_STEP_SMOOTHING
             // With AMASS enabled, adjust Bresenham axis increment counters according to AMASS level.
-            st.steps[X_AXIS] = st.exec_block->steps[X_AXIS] >> st.exec_segment->amass_level;
-            st.steps[Y_AXIS] = st.exec_block->steps[Y_AXIS] >> st.exec_segment->amass_level;
-            st.steps[Z_AXIS] = st.exec_block->steps[Z_AXIS] >> st.exec_segment->amass_level;
-#if (N_AXIS > A_AXIS)
-            st.steps[A_AXIS] = st.exec_block->steps[A_AXIS] >> st.exec_segment->amass_level;
-#endif
-#if (N_AXIS > B_AXIS)
-            st.steps[B_AXIS] = st.exec_block->steps[B_AXIS] >> st.exec_segment->amass_level;
-#endif
-#if (N_AXIS > C_AXIS)
-            st.steps[C_AXIS] = st.exec_block->steps[C_AXIS] >> st.exec_segment->amass_level;
-#endif
+            for (uint8_t idx = 0; idx < N_AXIS; idx++)
+                st.steps[idx] = st.exec_block->steps[idx] >> st.exec_segment->amass_level;
 #endif
             // Set real-time spindle output as segment is loaded, just prior to the first step.
             spindle->set_rpm(st.exec_segment->spindle_rpm);
@@ -294,7 +349,7 @@ static void stepper_pulse_func() {
             }
 
             system_set_exec_state_flag(EXEC_CYCLE_STOP); // Flag main program for cycle end
-            return; // Nothing to do but exit.
+            return (false);
         }
     }
     // Check probing state.
@@ -303,94 +358,48 @@ static void stepper_pulse_func() {
     // Reset step out bits.
     st.step_outbits = 0;
     // Execute step displacement profile by Bresenham line algorithm
-#ifdef ADAPTIVE_MULTI_AXIS_STEP_SMOOTHING
-    st.counter_x += st.steps[X_AXIS];
-#else
-    st.counter_x += st.exec_block->steps[X_AXIS];
-#endif
-    if (st.counter_x > st.exec_block->step_event_count) {
-        st.step_outbits |= bit(X_AXIS);
-        st.counter_x -= st.exec_block->step_event_count;
-        if (st.exec_block->direction_bits & bit(X_AXIS))
-            sys_position[X_AXIS]--;
-        else
-            sys_position[X_AXIS]++;
-    }
-#ifdef ADAPTIVE_MULTI_AXIS_STEP_SMOOTHING
-    st.counter_y += st.steps[Y_AXIS];
-#else
-    st.counter_y += st.exec_block->steps[Y_AXIS];
-#endif
-    if (st.counter_y > st.exec_block->step_event_count) {
-        st.step_outbits |= bit(Y_AXIS);
-        st.counter_y -= st.exec_block->step_event_count;
-        if (st.exec_block->direction_bits & bit(Y_AXIS))
-            sys_position[Y_AXIS]--;
-        else
-            sys_position[Y_AXIS]++;
-    }
-#ifdef ADAPTIVE_MULTI_AXIS_STEP_SMOOTHING
-    st.counter_z += st.steps[Z_AXIS];
-#else
-    st.counter_z += st.exec_block->steps[Z_AXIS];
-#endif
-    if (st.counter_z > st.exec_block->step_event_count) {
-        st.step_outbits |= bit(Z_AXIS);
-        st.counter_z -= st.exec_block->step_event_count;
-        if (st.exec_block->direction_bits & bit(Z_AXIS))
-            sys_position[Z_AXIS]--;
-        else
-            sys_position[Z_AXIS]++;
-    }
-#if (N_AXIS > A_AXIS)
-#ifdef ADAPTIVE_MULTI_AXIS_STEP_SMOOTHING
-    st.counter_a += st.steps[A_AXIS];
-#else
-    st.counter_a += st.exec_block->steps[A_AXIS];
-#endif
-    if (st.counter_a > st.exec_block->step_event_count) {
-        st.step_outbits |= bit(A_AXIS);
-        st.counter_a -= st.exec_block->step_event_count;
-        if (st.exec_block->direction_bits & bit(A_AXIS))  sys_position[A_AXIS]--;
-        else  sys_position[A_AXIS]++;
-    }
-#endif
-#if (N_AXIS > B_AXIS)
-#ifdef ADAPTIVE_MULTI_AXIS_STEP_SMOOTHING
-    st.counter_b += st.steps[B_AXIS];
-#else
-    st.counter_b += st.exec_block->steps[B_AXIS];
-#endif
-    if (st.counter_b > st.exec_block->step_event_count) {
-        st.step_outbits |= bit(B_AXIS);
-        st.counter_b -= st.exec_block->step_event_count;
-        if (st.exec_block->direction_bits & bit(B_AXIS))  sys_position[B_AXIS]--;
-        else  sys_position[B_AXIS]++;
-    }
-#endif
-#if (N_AXIS > C_AXIS)
-#ifdef ADAPTIVE_MULTI_AXIS_STEP_SMOOTHING
-    st.counter_c += st.steps[C_AXIS];
-#else
-    st.counter_c += st.exec_block->steps[C_AXIS];
-#endif
-    if (st.counter_c > st.exec_block->step_event_count) {
-        st.step_outbits |= bit(C_AXIS);
-        st.counter_c -= st.exec_block->step_event_count;
-        if (st.exec_block->direction_bits & bit(C_AXIS))  sys_position[C_AXIS]--;
-        else  sys_position[C_AXIS]++;
-    }
-#endif
+    st_bresenham_axes<X_AXIS>();
     // During a homing cycle, lock out and prevent desired axes from moving.
     if (sys.state == STATE_HOMING)
         st.step_outbits &= sys.homing_axis_lock;
     st.step_count--; // Decrement step events count
     if (st.step_count == 0) {
         // Segment is complete. Discard current segment and advance segment indexing.
+        segment_ticks_executed += (uint32_t)st.exec_segment->n_step * st.exec_segment->cycles_per_tick;
         st.exec_segment = NULL;
         if (++segment_buffer_tail == SEGMENT_BUFFER_SIZE)
             segment_buffer_tail = 0;
+        st_prep_notify(); // A slot is free. Have the prep task refill it.
     }
+    return (true);
+}
+
+/**
+ * This phase of the ISR should ONLY create the pulses for the steppers.
+ * This prevents jitter caused by the interval between the start of the
+ * interrupt and the start of the pulses. DON'T add any logic ahead of the
+ * call to this method that might cause variation in the timing. The aim
+ * is to keep pulse timing as regular as possible.
+ */
+static void stepper_pulse_func() {
+    motors_set_direction_pins(st.dir_outbits);
+#ifdef USE_RMT_STEPS
+    stepperRMT_Outputs();
+#else
+    set_stepper_pins_on(st.step_outbits);
+#ifndef USE_I2S_OUT_STREAM
+    // Start the pulse off timer. The alarm value is loaded from $0 in st_wake_up().
+    // The alarm disables itself when it fires, so it only needs re-enabling here.
+    timer_set_counter_value(STEP_PULSE_OFF_TIMER_GROUP, STEP_PULSE_OFF_TIMER_INDEX, 0x00000000ULL);
+    TIMERG0.hw_timer[STEP_PULSE_OFF_TIMER_INDEX].config.alarm_en = TIMER_ALARM_EN;
+#endif
+#endif
+
+    // some motor objects, like unipolar, handle steps themselves
+    motors_step(st.step_outbits, st.dir_outbits);
+
+    if (!stepper_next_step())
+        return; // Nothing to do but exit.
 
 #ifndef USE_RMT_STEPS
 #ifdef USE_I2S_OUT_STREAM
@@ -403,19 +412,206 @@ static void stepper_pulse_func() {
     set_stepper_pins_on(0); // turn all off
 #else
     st.step_outbits ^= step_port_invert_mask;  // Apply step port invert mask
-    // wait for step pulse time to complete...some of it should have expired during code above
-    while (esp_timer_get_time() - step_pulse_start_time < pulse_microseconds->get()) {
-        NOP(); // spin here until time to turn off step
-    }
-    set_stepper_pins_on(0); // turn all off
+    // The pulse off timer turns the step pins off. See onStepperOffTimer().
 #endif
 #endif
     return;
 }
 
+#ifdef USE_I2S_OUT_SEGMENT_RENDER
+/*
+   I2S segment renderer. Instead of the I2S task calling stepper_pulse_func() once per step period
+   and padding the DMA buffer one sample at a time in between, the I2S task hands a whole DMA buffer
+   to stepper_render_samples(). That runs the Bresenham step for each step period and then fills
+   the pulse and the idle gap of the period with two tight store loops. The step bits are written
+   straight into the port word through per axis masks, so no pin writes happen per step.
+*/
+static uint32_t i2s_step_mask[N_AXIS];   // I2S port bits pulsed by a step on each axis
+static uint32_t i2s_render_period;        // Current step period (usec). Set by Stepper_Timer_WritePeriod()
+static uint32_t i2s_render_pulse_samples; // Step pulse length ($0) in samples
+static uint32_t i2s_render_pulse_word;    // Port word of the current pulse, with the step bits set
+static uint32_t i2s_render_pulse_left;    // Pulse samples still to write for the current step period
+static uint32_t i2s_render_gap_left;      // Idle samples still to write for the current step period
+static uint32_t i2s_render_time_carry;    // Part of a sample carried over between step periods (usec)
+
+// Adds the I2S port bit of a step pin to the axis mask. Returns false for a pin that is not on the
+// I2S expander, since the renderer cannot drive it.
+static bool st_i2s_add_step_pin(uint8_t axis, uint8_t pin) {
+    if (pin < I2S_OUT_PIN_BASE)
+        return false;
+    i2s_step_mask[axis] |= (1UL << (pin - I2S_OUT_PIN_BASE));
+    return true;
+}
+
+// Builds the per axis step masks for the current ganged mode. Returns false if any step pin
+// cannot be rendered.
+static bool st_i2s_build_step_masks() {
+    bool ok = true;
+    memset(i2s_step_mask, 0, sizeof(i2s_step_mask));
+#ifdef X_STEP_PIN
+#ifndef X2_STEP_PIN // if not a ganged axis
+    ok &= st_i2s_add_step_pin(X_AXIS, X_STEP_PIN);
+#else // is a ganged axis
+    if ((ganged_mode == SQUARING_MODE_DUAL) || (ganged_mode == SQUARING_MODE_A))
+        ok &= st_i2s_add_step_pin(X_AXIS, X_STEP_PIN);
+    if ((ganged_mode == SQUARING_MODE_DUAL) || (ganged_mode == SQUARING_MODE_B))
+        ok &= st_i2s_add_step_pin(X_AXIS, X2_STEP_PIN);
+#endif
+#endif
+#ifdef Y_STEP_PIN
+#ifndef Y2_STEP_PIN // if not a ganged axis
+    ok &= st_i2s_add_step_pin(Y_AXIS, Y_STEP_PIN);
+#else // is a ganged axis
+    if ((ganged_mode == SQUARING_MODE_DUAL) || (ganged_mode == SQUARING_MODE_A))
+        ok &= st_i2s_add_step_pin(Y_AXIS, Y_STEP_PIN);
+    if ((ganged_mode == SQUARING_MODE_DUAL) || (ganged_mode == SQUARING_MODE_B))
+        ok &= st_i2s_add_step_pin(Y_AXIS, Y2_STEP_PIN);
+#endif
+#endif
+#ifdef Z_STEP_PIN
+#ifndef Z2_STEP_PIN // if not a ganged axis
+    ok &= st_i2s_add_step_pin(Z_AXIS, Z_STEP_PIN);
+#else // is a ganged axis
+    if ((ganged_mode == SQUARING_MODE_DUAL) || (ganged_mode == SQUARING_MODE_A))
+        ok &= st_i2s_add_step_pin(Z_AXIS, Z_STEP_PIN);
+    if ((ganged_mode == SQUARING_MODE_DUAL) || (ganged_mode == SQUARING_MODE_B))
+        ok &= st_i2s_add_step_pin(Z_AXIS, Z2_STEP_PIN);
+#endif
+#endif
+#ifdef A_STEP_PIN
+#ifndef A2_STEP_PIN // if not a ganged axis
+    ok &= st_i2s_add_step_pin(A_AXIS, A_STEP_PIN);
+#else // is a ganged axis
+    if ((ganged_mode == SQUARING_MODE_DUAL) || (ganged_mode == SQUARING_MODE_A))
+        ok &= st_i2s_add_step_pin(A_AXIS, A_STEP_PIN);
+    if ((ganged_mode == SQUARING_MODE_DUAL) || (ganged_mode == SQUARING_MODE_B))
+        ok &= st_i2s_add_step_pin(A_AXIS, A2_STEP_PIN);
+#endif
+#endif
+#ifdef B_STEP_PIN
+#ifndef B2_STEP_PIN // if not a ganged axis
+    ok &= st_i2s_add_step_pin(B_AXIS, B_STEP_PIN);
+#else // is a ganged axis
+    if ((ganged_mode == SQUARING_MODE_DUAL) || (ganged_mode == SQUARING_MODE_A))
+        ok &= st_i2s_add_step_pin(B_AXIS, B_STEP_PIN);
+    if ((ganged_mode == SQUARING_MODE_DUAL) || (ganged_mode == SQUARING_MODE_B))
+        ok &= st_i2s_add_step_pin(B_AXIS, B2_STEP_PIN);
+#endif
+#endif
+#ifdef C_STEP_PIN
+#ifndef C2_STEP_PIN // if not a ganged axis
+    ok &= st_i2s_add_step_pin(C_AXIS, C_STEP_PIN);
+#else // is a ganged axis
+    if ((ganged_mode == SQUARING_MODE_DUAL) || (ganged_mode == SQUARING_MODE_A))
+        ok &= st_i2s_add_step_pin(C_AXIS, C_STEP_PIN);
+    if ((ganged_mode == SQUARING_MODE_DUAL) || (ganged_mode == SQUARING_MODE_B))
+        ok &= st_i2s_add_step_pin(C_AXIS, C2_STEP_PIN);
+#endif
+#endif
+    return ok;
+}
+
+// I2S render callback. Fills buf with up to num samples and returns the number written. Returns
+// early, with at least one sample, when the segment buffer runs dry and stepping stops.
+static uint32_t IRAM_ATTR stepper_render_samples(uint32_t* buf, uint32_t num) {
+#ifdef STEPPER_ISR_TIMING
+    uint32_t entry = xthal_get_ccount();
+#endif
+    uint32_t pos = 0;
+    while (pos < num) {
+        if (i2s_render_pulse_left) {
+            uint32_t word = i2s_render_pulse_word;
+            while (i2s_render_pulse_left && (pos < num)) {
+                buf[pos++] = word;
+                i2s_render_pulse_left--;
+            }
+            continue;
+        }
+        if (i2s_render_gap_left) {
+            uint32_t word = i2s_out_get_port_data();
+            while (i2s_render_gap_left && (pos < num)) {
+                buf[pos++] = word;
+                i2s_render_gap_left--;
+            }
+            continue;
+        }
+        // Start of a step period. Output the step bits computed in the last period, then compute
+        // the next ones, exactly like stepper_pulse_func() does.
+        motors_set_direction_pins(st.dir_outbits);
+        uint32_t idle_word = i2s_out_get_port_data();
+        uint8_t step_bits = st.step_outbits ^ step_port_invert_mask;
+        motors_step(st.step_outbits, st.dir_outbits);
+        if (!stepper_next_step()) {
+            if (pos == 0)
+                buf[pos++] = idle_word; // A DMA buffer cannot be empty
+            break;
+        }
+        st.step_outbits ^= step_port_invert_mask;  // Apply step port invert mask
+        uint32_t pulse_word = idle_word;
+        for (uint8_t idx = 0; idx < N_AXIS; idx++) {
+            if (step_bits & bit(idx))
+                pulse_word ^= i2s_step_mask[idx];
+        }
+        // Split the step period into pulse and idle samples, carrying the remainder forward so
+        // the average step rate is exact.
+        uint32_t period = i2s_render_period + i2s_render_time_carry;
+        uint32_t samples = period / I2S_OUT_USEC_PER_PULSE;
+        i2s_render_time_carry = period - samples * I2S_OUT_USEC_PER_PULSE;
+        if (samples == 0)
+            samples = 1;
+        i2s_render_pulse_word = pulse_word;
+        i2s_render_pulse_left = MIN(i2s_render_pulse_samples, samples);
+        i2s_render_gap_left = samples - i2s_render_pulse_left;
+    }
+#ifdef STEPPER_ISR_TIMING
+    st_timing_record(ST_TIMING_I2S_RENDER, entry, xthal_get_ccount(), UINT32_MAX);
+#endif
+    return pos;
+}
+#endif
+
+#ifdef USE_SEGMENT_PREP_TASK
+// Refills the segment buffer each time the stepper retires a segment, so the refill latency does
+// not depend on what the protocol loop is busy with. The timeout is a backstop for new planner
+// blocks arriving while the segment buffer already has room.
+static void segmentPrepTask(void* pvParameters) {
+    while (true) {
+        ulTaskNotifyTake(pdTRUE, pdMS_TO_TICKS(SEGMENT_PREP_TASK_POLL_MS));
+        if (sys.state & (STATE_CYCLE | STATE_HOLD | STATE_SAFETY_DOOR | STATE_HOMING | STATE_SLEEP | STATE_JOG)) {
+            mc_line_queue_flush(); // Refill planner blocks freed by the last prep
+            st_prep_buffer();
+        }
+    }
+}
+#endif
+
+void st_prep_lock() {
+    if (st_prep_mutex != NULL)
+        xSemaphoreTakeRecursive(st_prep_mutex, portMAX_DELAY);
+}
+
+void st_prep_unlock() {
+    if (st_prep_mutex != NULL)
+        xSemaphoreGiveRecursive(st_prep_mutex);
+}
+
 void stepper_init() {
 
     grbl_msg_sendf(CLIENT_SERIAL, MSG_LEVEL_INFO, "Axis count %d", N_AXIS);
+#ifdef STEPPER_ISR_TIMING
+    st_timing_reset();
+#endif
+    st_prep_mutex = xSemaphoreCreateRecursiveMutex();
+#ifdef USE_SEGMENT_PREP_TASK
+    xTaskCreatePinnedToCore(segmentPrepTask,     // task
+                            "segmentPrepTask", // name for task
+                            4096,   // size of task stack
+                            NULL,   // parameters
+                            SEGMENT_PREP_TASK_PRIORITY, // priority
+                            &segmentPrepTaskHandle,
+                            CONFIG_ARDUINO_RUNNING_CORE // same core as the protocol loop
+                           );
+#endif
     // make the step pins outputs
 #ifdef USE_RMT_STEPS
     grbl_msg_sendf(CLIENT_SERIAL, MSG_LEVEL_INFO, "RMT Steps");
@@ -427,7 +623,17 @@ void stepper_init() {
 
 #ifdef USE_I2S_OUT_STREAM
     // I2S stepper do not use timer interrupt but callback
-    i2s_out_set_pulse_callback(stepper_pulse_func);
+#ifdef USE_I2S_OUT_SEGMENT_RENDER
+    if (st_i2s_build_step_masks()) {
+        grbl_msg_sendf(CLIENT_SERIAL, MSG_LEVEL_INFO, "I2S segment rendering");
+        i2s_out_set_render_callback(stepper_render_samples);
+    } else {
+        grbl_msg_sendf(CLIENT_SERIAL, MSG_LEVEL_INFO, "I2S segment rendering needs I2S step pins, using pulse callback");
+        i2s_out_set_pulse_callback(STEPPER_I2S_PULSE_CALLBACK);
+    }
+#else
+    i2s_out_set_pulse_callback(STEPPER_I2S_PULSE_CALLBACK);
+#endif
 #else
     timer_config_t config;
     config.divider     = F_TIMERS / F_STEPPER_TIMER;
@@ -440,6 +646,16 @@ void stepper_init() {
     timer_set_counter_value(STEP_TIMER_GROUP, STEP_TIMER_INDEX, 0x00000000ULL);
     timer_enable_intr(STEP_TIMER_GROUP, STEP_TIMER_INDEX);
     timer_isr_register(STEP_TIMER_GROUP, STEP_TIMER_INDEX, onStepperDriverTimer, NULL, 0, NULL);
+#ifndef USE_RMT_STEPS
+    // Free running one-shot timer for the end of the step pulse. Same tick rate as the step timer.
+    config.counter_en  = TIMER_START;
+    config.alarm_en    = TIMER_ALARM_DIS; // Armed by each step
+    config.auto_reload = false;
+    timer_init(STEP_PULSE_OFF_TIMER_GROUP, STEP_PULSE_OFF_TIMER_INDEX, &config);
+    timer_set_counter_value(STEP_PULSE_OFF_TIMER_GROUP, STEP_PULSE_OFF_TIMER_INDEX, 0x00000000ULL);
+    timer_enable_intr(STEP_PULSE_OFF_TIMER_GROUP, STEP_PULSE_OFF_TIMER_INDEX);
+    timer_isr_register(STEP_PULSE_OFF_TIMER_GROUP, STEP_PULSE_OFF_TIMER_INDEX, onStepperOffTimer, NULL, 0, NULL);
+#endif
 #endif
 
 }
@@ -460,6 +676,15 @@ void st_wake_up() {
 #else // Normal operation
     // Set step pulse time. Ad hoc computation from oscilloscope. Uses two's complement.
     st.step_pulse_time = -(((pulse_microseconds->get() - 2) * TICKS_PER_MICROSECOND) >> 3);
+#endif
+#ifdef USE_I2S_OUT_SEGMENT_RENDER
+    // Ganged mode may have changed for squaring, so the step masks are rebuilt for every cycle.
+    st_i2s_build_step_masks();
+    i2s_render_pulse_samples = MAX(1, pulse_microseconds->get() / I2S_OUT_USEC_PER_PULSE);
+#endif
+#if !defined(USE_RMT_STEPS) && !defined(USE_I2S_OUT_STREAM)
+    timer_set_alarm_value(STEP_PULSE_OFF_TIMER_GROUP, STEP_PULSE_OFF_TIMER_INDEX,
+                          (uint64_t)pulse_microseconds->get() * TICKS_PER_MICROSECOND);
 #endif
     // Enable Stepper Driver Interrupt
     Stepper_Timer_Start();
@@ -470,6 +695,7 @@ void st_reset() {
 #ifdef ESP_DEBUG
     //Serial.println("st_reset()");
 #endif
+    st_prep_lock();
     // Initialize stepper driver idle state.
 #ifdef USE_I2S_OUT_STREAM
     i2s_out_reset();
@@ -483,9 +709,17 @@ void st_reset() {
     segment_buffer_tail = 0;
     segment_buffer_head = 0; // empty = tail
     segment_next_head = 1;
+    segment_ticks_prepped = 0;
+    segment_ticks_executed = 0;
     busy = false;
+#ifdef USE_I2S_OUT_SEGMENT_RENDER
+    i2s_render_pulse_left = 0;
+    i2s_render_gap_left = 0;
+    i2s_render_time_carry = 0;
+#endif
     st_generate_step_dir_invert_masks();
     st.dir_outbits = dir_port_invert_mask; // Initialize direction bits to default.
+    st_prep_unlock();
     // TODO do we need to turn step pins off?
 }
 
@@ -698,16 +932,19 @@ void st_go_idle() {
 
 // Called by planner_recalculate() when the executing block is updated by the new plan.
 void st_update_plan_block_parameters() {
+    st_prep_lock();
     if (pl_block != NULL) { // Ignore if at start of a new block.
         prep.recalculate_flag |= PREP_FLAG_RECALCULATE;
         pl_block->entry_speed_sqr = prep.current_speed * prep.current_speed; // Update entry speed.
         pl_block = NULL; // Flag st_prep_segment() to load and check active velocity profile.
     }
+    st_prep_unlock();
 }
 
 #ifdef PARKING_ENABLE
 // Changes the run state of the step segment buffer to execute the special parking motion.
 void st_parking_setup_buffer() {
+    st_prep_lock();
     // Store step execution data of partially completed block, if necessary.
     if (prep.recalculate_flag & PREP_FLAG_HOLD_PARTIAL_BLOCK) {
         prep.last_st_block_index = prep.st_block_index;
@@ -719,11 +956,13 @@ void st_parking_setup_buffer() {
     prep.recalculate_flag |= PREP_FLAG_PARKING;
     prep.recalculate_flag &= ~(PREP_FLAG_RECALCULATE);
     pl_block = NULL; // Always reset parking motion to reload new block.
+    st_prep_unlock();
 }
 
 
 // Restores the step segment buffer to the normal run state after a parking motion.
 void st_parking_restore_buffer() {
+    st_prep_lock();
     // Restore step execution data and flags of partially completed block, if necessary.
     if (prep.recalculate_flag & PREP_FLAG_HOLD_PARTIAL_BLOCK) {
         st_prep_block = &st_block_buffer[prep.last_st_block_index];
@@ -736,6 +975,7 @@ void st_parking_restore_buffer() {
     } else
         prep.recalculate_flag = false;
     pl_block = NULL; // Set to reload next block.
+    st_prep_unlock();
 }
 #endif
 
@@ -763,6 +1003,83 @@ static uint8_t st_next_block_index(uint8_t block_index) {
     return (block_index);
 }
 
+/* Jerk-limited (S-curve) ramps. A ramp between two speeds is split into the 7-phase S-curve
+   pieces that apply to it: jerk up, constant acceleration, jerk down, and the mirrored three
+   phases for deceleration. The cruise phase is the planner's own.
+   The S-curve ramp keeps the duration and distance of the trapezoidal ramp it replaces, so the
+   planner's junction speeds and block lengths are untouched. Only the shape of the speed curve
+   inside the ramp changes. Since the mean speed is fixed, the peak acceleration rises above the
+   planned value, by up to 2x as the jerk limit gets tight. The planner therefore plans S-curve
+   blocks at SCURVE_PLANNED_ACCELERATION of the axis limits, and a ramp whose peak would still
+   exceed the limits stays linear. A ramp too short for any profile within the jerk limit stays
+   linear as well. That also keeps chains of short blocks at constant acceleration instead of
+   pulsing it on each block. */
+static void st_scurve_setup(float mm_start, float mm_end, float end_speed) {
+    prep.ramp_scurve = false;
+    if (motion_profile->get() != MOTION_PROFILE_SCURVE)
+        return;
+    float delta_speed = end_speed - prep.current_speed;
+    float avg_speed = 0.5 * (prep.current_speed + end_speed);
+    if (delta_speed == 0.0 || avg_speed <= 0.0 || mm_start <= mm_end)
+        return;
+    float duration = (mm_start - mm_end) / avg_speed;
+    float jerk = pl_block->jerk;
+    // Solve delta_speed = accel * (duration - accel/jerk) for the smallest peak acceleration.
+    float discriminant = duration * duration - 4.0 * fabs(delta_speed) / jerk;
+    if (discriminant < 0.0)
+        return; // Too short to limit jerk. Keep the linear ramp.
+    float accel = 0.5 * jerk * (duration - sqrt(discriminant));
+    if (accel > pl_block->peak_acceleration)
+        return; // Would peak above the axis limits, or the block was planned for linear ramps.
+    prep.ramp_start_mm = mm_start;
+    prep.ramp_end_mm = mm_end;
+    prep.ramp_start_speed = prep.current_speed;
+    prep.ramp_time = 0.0;
+    prep.ramp_duration = duration;
+    prep.ramp_jerk_time = accel / jerk;
+    prep.ramp_accel = (delta_speed > 0.0) ? accel : -accel;
+    prep.ramp_jerk = (delta_speed > 0.0) ? jerk : -jerk;
+    prep.ramp_scurve = true;
+}
+
+// Returns the distance traveled since the start of the S-curve ramp at ramp time t, and the speed.
+static float st_scurve_distance(float t, float* speed) {
+    float v0 = prep.ramp_start_speed;
+    float tj = prep.ramp_jerk_time;
+    float a = prep.ramp_accel;
+    float j = prep.ramp_jerk;
+    if (t <= tj) { // Jerk into the ramp
+        *speed = v0 + 0.5 * j * t * t;
+        return t * (v0 + j * t * t / 6.0);
+    }
+    float T = prep.ramp_duration;
+    if (t < T - tj) { // Constant acceleration
+        float u = t - tj;
+        float vj = v0 + 0.5 * a * tj;
+        *speed = vj + a * u;
+        return tj * (v0 + a * tj / 6.0) + u * (vj + 0.5 * a * u);
+    }
+    // Jerk out of the ramp, mirrored from the end speed.
+    float v1 = v0 + a * (T - tj);
+    float w = T - t;
+    *speed = v1 - 0.5 * j * w * w;
+    return 0.5 * (v0 + v1) * T - w * (v1 - j * w * w / 6.0);
+}
+
+// Advances the S-curve ramp by time_var. Returns true at the end of the ramp, with time_var trimmed
+// to the time actually spent in it. Otherwise updates mm_remaining and prep.current_speed.
+static bool st_scurve_step(float* time_var, float* mm_remaining) {
+    prep.ramp_time += *time_var;
+    if (prep.ramp_time >= prep.ramp_duration) {
+        *time_var -= prep.ramp_time - prep.ramp_duration;
+        prep.ramp_scurve = false;
+        return true;
+    }
+    float mm = prep.ramp_start_mm - st_scurve_distance(prep.ramp_time, &prep.current_speed);
+    *mm_remaining = MAX(mm, prep.ramp_end_mm); // Guard against round-off past the ramp end
+    return false;
+}
+
 /* Prepares step segment buffer. Continuously called from main program.
 
    The segment buffer is an intermediary buffer interface between the execution of steps
@@ -773,14 +1090,30 @@ static uint8_t st_next_block_index(uint8_t block_index) {
    The number of steps "checked-out" from the planner buffer and the number of segments in
    the segment buffer is sized and computed such that no operation in the main program takes
    longer than the time it takes the stepper algorithm to empty it before refilling it.
-   Currently, the segment buffer conservatively holds roughly up to 40-50 msec of steps.
+   The segment buffer is filled up to $Stepper/BufferTime msec of steps, or until it is full.
    NOTE: Computation units are in steps, millimeters, and minutes.
 */
+static void st_prep_fill_buffer();
+
 void st_prep_buffer() {
+    // Called from both the segment prep task and the protocol loop.
+    st_prep_lock();
+    uint32_t profile_start = motion_profile_start();
+    st_prep_fill_buffer();
+    motion_profile_stop(PROFILE_PREP, profile_start);
+    st_prep_unlock();
+}
+
+static void st_prep_fill_buffer() {
     // Block step prep buffer, while in a suspend state and there is no suspend motion to execute.
     if (bit_istrue(sys.step_control, STEP_CONTROL_END_MOTION))
         return;
+    // Fill to a target time of queued motion rather than to a slot count, so the protection against
+    // main loop stalls is the same at any feed rate and segment length.
+    uint32_t target_ticks = (uint32_t)segment_buffer_time->get() * (1000 * TICKS_PER_MICROSECOND);
     while (segment_buffer_tail != segment_next_head) { // Check if we need to fill the buffer.
+        if ((uint32_t)(segment_ticks_prepped - segment_ticks_executed) >= target_ticks)
+            return; // Enough motion queued.
         // Determine if we need to load a new planner block or if the block needs to be recomputed.
         if (pl_block == NULL) {
             // Query planner for a queued block
@@ -929,6 +1262,13 @@ void st_prep_buffer() {
                     prep.maximum_speed = prep.exit_speed;
                 }
             }
+            // Shape the first ramp of the profile. Later ramps are set up at their junctions.
+            if (prep.ramp_type == RAMP_ACCEL)
+                st_scurve_setup(pl_block->millimeters, prep.accelerate_until, prep.maximum_speed);
+            else if (prep.ramp_type == RAMP_DECEL)
+                st_scurve_setup(pl_block->millimeters, prep.mm_complete, prep.exit_speed);
+            else
+                prep.ramp_scurve = false;
 
             bit_true(sys.step_control, STEP_CONTROL_UPDATE_SPINDLE_RPM); // Force update whenever updating block.
 
@@ -977,19 +1317,28 @@ void st_prep_buffer() {
                 break;
             case RAMP_ACCEL:
                 // NOTE: Acceleration ramp only computes during first do-while loop.
-                speed_var = pl_block->acceleration * time_var;
-                mm_remaining -= time_var * (prep.current_speed + 0.5 * speed_var);
-                if (mm_remaining < prep.accelerate_until) { // End of acceleration ramp.
-                    // Acceleration-cruise, acceleration-deceleration ramp junction, or end of block.
+                if (prep.ramp_scurve) {
+                    if (!st_scurve_step(&time_var, &mm_remaining))
+                        break; // Mid S-curve acceleration.
+                    mm_remaining = prep.accelerate_until;
+                } else {
+                    speed_var = pl_block->acceleration * time_var;
+                    mm_remaining -= time_var * (prep.current_speed + 0.5 * speed_var);
+                    if (mm_remaining >= prep.accelerate_until) {
+                        prep.current_speed += speed_var; // Acceleration only.
+                        break;
+                    }
                     mm_remaining = prep.accelerate_until; // NOTE: 0.0 at EOB
                     time_var = 2.0 * (pl_block->millimeters - mm_remaining) / (prep.current_speed + prep.maximum_speed);
-                    if (mm_remaining == prep.decelerate_after)
-                        prep.ramp_type = RAMP_DECEL;
-                    else
-                        prep.ramp_type = RAMP_CRUISE;
-                    prep.current_speed = prep.maximum_speed;
-                } else   // Acceleration only.
-                    prep.current_speed += speed_var;
+                }
+                // End of acceleration ramp.
+                // Acceleration-cruise, acceleration-deceleration ramp junction, or end of block.
+                prep.current_speed = prep.maximum_speed;
+                if (mm_remaining == prep.decelerate_after) {
+                    prep.ramp_type = RAMP_DECEL;
+                    st_scurve_setup(mm_remaining, prep.mm_complete, prep.exit_speed);
+                } else
+                    prep.ramp_type = RAMP_CRUISE;
                 break;
             case RAMP_CRUISE:
                 // NOTE: mm_var used to retain the last mm_remaining for incomplete segment time_var calculations.
@@ -1001,10 +1350,18 @@ void st_prep_buffer() {
                     time_var = (mm_remaining - prep.decelerate_after) / prep.maximum_speed;
                     mm_remaining = prep.decelerate_after; // NOTE: 0.0 at EOB
                     prep.ramp_type = RAMP_DECEL;
+                    st_scurve_setup(mm_remaining, prep.mm_complete, prep.exit_speed);
                 } else   // Cruising only.
                     mm_remaining = mm_var;
                 break;
             default: // case RAMP_DECEL:
+                if (prep.ramp_scurve) {
+                    if (!st_scurve_step(&time_var, &mm_remaining))
+                        break; // Mid S-curve deceleration.
+                    mm_remaining = prep.mm_complete;
+                    prep.current_speed = prep.exit_speed;
+                    break;
+                }
                 // NOTE: mm_var used as a misc worker variable to prevent errors when near zero speed.
                 speed_var = pl_block->acceleration * time_var; // Used as delta speed (mm/min)
                 if (prep.current_speed > speed_var) { // Check if at or below zero speed.
@@ -1137,9 +1494,11 @@ void st_prep_buffer() {
         }
 #endif
         // Segment complete! Increment segment buffer indices, so stepper ISR can immediately execute it.
+        segment_ticks_prepped += (uint32_t)prep_segment->n_step * prep_segment->cycles_per_tick;
         segment_buffer_head = segment_next_head;
         if (++segment_next_head == SEGMENT_BUFFER_SIZE)
             segment_next_head = 0;
+        motion_stats.segments_prepped++;
         // Update the appropriate planner and segment data.
         pl_block->millimeters = mm_remaining;
         prep.steps_remaining = n_steps_remaining;
@@ -1172,6 +1531,41 @@ void st_prep_buffer() {
 
 
 
+// Times the Bresenham kernel in CPU cycles on a synthetic block where every axis moves, with
+// mixed directions. Borrows the stepper state and restores it, so only call it while idle.
+void st_benchmark_kernel(uint8_t client) {
+    const uint32_t ticks = 1000;
+    stepper_t saved_st = st;
+    int32_t saved_position[N_AXIS];
+    memcpy(saved_position, sys_position, sizeof(sys_position));
+    st_block_t block;
+    memset(&block, 0, sizeof(st_block_t));
+    block.step_event_count = ticks;
+    block.direction_bits = 0x2A; // Every other axis negative
+    st.exec_block = &block;
+    for (uint8_t idx = 0; idx < N_AXIS; idx++) {
+        block.steps[idx] = ticks - idx * (ticks / (N_AXIS + 1));
+#ifdef ADAPTIVE_MULTI_AXIS_STEP_SMOOTHING
+        st.steps[idx] = block.steps[idx];
+#endif
+        st.counter[idx] = ticks >> 1;
+    }
+    // Keep the best of several passes to filter out interrupts and cache misses.
+    uint32_t best = UINT32_MAX;
+    for (uint8_t pass = 0; pass < 8; pass++) {
+        uint32_t start = ESP.getCycleCount();
+        for (uint32_t tick = 0; tick < ticks; tick++) {
+            st.step_outbits = 0;
+            st_bresenham_axes<X_AXIS>();
+        }
+        best = MIN(best, ESP.getCycleCount() - start);
+    }
+    st = saved_st;
+    memcpy(sys_position, saved_position, sizeof(sys_position));
+    grbl_sendf(client, "[MSG:Bresenham %d axes %.1f cycles/tick]\r\n", N_AXIS, (float)best / ticks);
+}
+
+
 // Called by realtime status reporting to fetch the current speed being executed. This value
 // however is not exactly the current speed, but the speed computed in the last step segment
 // in the segment buffer. It will always be behind by up to the number of segment blocks (-1)
@@ -1187,6 +1581,9 @@ void IRAM_ATTR Stepper_Timer_WritePeriod(uint64_t alarm_val) {
     // 1 tick = F_TIMERS / F_STEPPER_TIMER
     // Pulse ISR is called for each tick of alarm_val.
     i2s_out_set_pulse_period(alarm_val / 60);
+#ifdef USE_I2S_OUT_SEGMENT_RENDER
+    i2s_render_period = alarm_val / 60;
+#endif
 #else
     timer_set_alarm_value(STEP_TIMER_GROUP, STEP_TIMER_INDEX, alarm_val);
 #endif
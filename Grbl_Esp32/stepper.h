@@ -25,8 +25,10 @@
 #ifndef stepper_h
 #define stepper_h
 
+// Step segment ring size. st_prep_buffer() fills it up to $Stepper/BufferTime of queued motion,
+// so this only needs to be deep enough to hold that time in short segments. Must be < 256.
 #ifndef SEGMENT_BUFFER_SIZE
-    #define SEGMENT_BUFFER_SIZE 6
+    #define SEGMENT_BUFFER_SIZE 64
 #endif
 
 
@@ -42,6 +44,16 @@
 #define RAMP_DECEL 2
 #define RAMP_DECEL_OVERRIDE 3
 
+// Velocity profile shapes selected by $Stepper/Profile
+#define MOTION_PROFILE_TRAPEZOID 0
+#define MOTION_PROFILE_SCURVE 1
+
+// Share of the axis acceleration the planner uses for blocks planned for S-curve ramps. The rest
+// is headroom for the peak of the S-curve. Ramps that would need more stay linear.
+#ifndef SCURVE_PLANNED_ACCELERATION
+    #define SCURVE_PLANNED_ACCELERATION 0.75
+#endif
+
 #define PREP_FLAG_RECALCULATE bit(0)
 #define PREP_FLAG_HOLD_PARTIAL_BLOCK bit(1)
 #define PREP_FLAG_PARKING bit(2)
@@ -72,6 +84,14 @@
 #define STEP_TIMER_GROUP TIMER_GROUP_0
 #define STEP_TIMER_INDEX TIMER_0
 
+// One-shot timer that ends the step pulse in the GPIO (Timed Steps) path
+#define STEP_PULSE_OFF_TIMER_GROUP TIMER_GROUP_0
+#define STEP_PULSE_OFF_TIMER_INDEX TIMER_1
+
+// Segment prep task. See USE_SEGMENT_PREP_TASK in config.h
+#define SEGMENT_PREP_TASK_PRIORITY 3  // Above the protocol loop and the serial task
+#define SEGMENT_PREP_TASK_POLL_MS 10  // Longest wait without a notification
+
 // esp32 work around for diable in main loop
 extern uint64_t stepper_idle_counter;
 extern bool stepper_idle;
@@ -80,7 +100,7 @@ extern uint8_t ganged_mode;
 
 // -- Task handles for use in the notifications
 void IRAM_ATTR onSteppertimer();
-void IRAM_ATTR onStepperOffTimer();
+void IRAM_ATTR onStepperOffTimer(void* para);
 
 void stepper_init();
 
@@ -105,12 +125,19 @@ void st_parking_restore_buffer();
 // Reloads step segment buffer. Called continuously by realtime execution system.
 void st_prep_buffer();
 
+// Guards the planner and segment prep state against the segment prep task. Recursive.
+void st_prep_lock();
+void st_prep_unlock();
+
 // Called by planner_recalculate() when the executing block is updated by the new plan.
 void st_update_plan_block_parameters();
 
 // Called by realtime status reporting if realtime rate reporting is enabled in config.h.
 float st_get_realtime_rate();
 
+// Reports the cycle cost of the Bresenham step kernel per ISR tick. Idle only.
+void st_benchmark_kernel(uint8_t client);
+
 // disable (or enable) steppers via STEPPERS_DISABLE_PIN
 bool get_stepper_disable(); // returns the state of the pin
 
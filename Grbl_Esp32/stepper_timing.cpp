@@ -0,0 +1,99 @@
+/*
+  stepper_timing.cpp - Step interrupt duration and latency instrumentation
+  Part of Grbl_ESP32
+
+  Grbl is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  Grbl is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with Grbl.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "grbl.h"
+
+#ifdef STEPPER_ISR_TIMING
+
+static st_timing_t st_timing[ST_TIMING_BACKENDS];
+static uint32_t st_timing_cycles_per_us = 240; // Set from the CPU clock at reset
+
+static const char* const st_timing_backend_names[ST_TIMING_BACKENDS] = { "GPIO", "RMT", "I2S", "I2S render" };
+
+void st_timing_reset() {
+    memset(st_timing, 0, sizeof(st_timing));
+    for (uint8_t backend = 0; backend < ST_TIMING_BACKENDS; backend++) {
+        st_timing[backend].duration_min = UINT32_MAX;
+        st_timing[backend].latency_min = UINT32_MAX;
+    }
+    st_timing_cycles_per_us = ESP.getCpuFreqMHz();
+}
+
+void IRAM_ATTR st_timing_record(uint8_t backend, uint32_t entry, uint32_t exit, uint32_t latency) {
+    st_timing_t* t = &st_timing[backend];
+    uint32_t duration = exit - entry; // Wraps correctly across a CCOUNT rollover
+    t->calls++;
+    t->duration_total += duration;
+    if (duration < t->duration_min)
+        t->duration_min = duration;
+    if (duration > t->duration_max)
+        t->duration_max = duration;
+    uint32_t usec = duration / st_timing_cycles_per_us;
+    uint8_t bin = (usec == 0) ? 0 : (32 - __builtin_clz(usec));
+    if (bin >= ST_TIMING_BINS)
+        bin = ST_TIMING_BINS - 1;
+    t->histogram[bin]++;
+    if (latency == UINT32_MAX)
+        return;
+    t->latency_calls++;
+    t->latency_total += latency;
+    if (latency < t->latency_min)
+        t->latency_min = latency;
+    if (latency > t->latency_max)
+        t->latency_max = latency;
+}
+
+void report_st_timing(uint8_t client) {
+    bool any = false;
+    float cycles_per_us = st_timing_cycles_per_us;
+    for (uint8_t backend = 0; backend < ST_TIMING_BACKENDS; backend++) {
+        // Copy first. The ISR keeps updating the live counters while this prints.
+        st_timing_t t = st_timing[backend];
+        if (t.calls == 0)
+            continue;
+        any = true;
+        grbl_sendf(client, "[MSG:%s %u calls]\r\n", st_timing_backend_names[backend], t.calls);
+        grbl_sendf(client, "[MSG:Duration min %.2f avg %.2f max %.2f us]\r\n",
+                   t.duration_min / cycles_per_us,
+                   (float)t.duration_total / t.calls / cycles_per_us,
+                   t.duration_max / cycles_per_us);
+        if (t.latency_calls) {
+            grbl_sendf(client, "[MSG:Latency min %.2f avg %.2f max %.2f jitter %.2f us]\r\n",
+                       (float)t.latency_min / TICKS_PER_MICROSECOND,
+                       (float)t.latency_total / t.latency_calls / TICKS_PER_MICROSECOND,
+                       (float)t.latency_max / TICKS_PER_MICROSECOND,
+                       (float)(t.latency_max - t.latency_min) / TICKS_PER_MICROSECOND);
+        }
+        // Bin b counts durations below 2^b usec. The last one takes everything above the others.
+        char buffer[24 + ST_TIMING_BINS * 20];
+        ReportWriter histogram(buffer, sizeof(buffer));
+        histogram.put("[MSG:Histogram");
+        for (uint8_t bin = 0; bin < ST_TIMING_BINS; bin++) {
+            histogram.put((bin < ST_TIMING_BINS - 1) ? " <" : " >=");
+            histogram.put_uint((bin < ST_TIMING_BINS - 1) ? (1UL << bin) : (1UL << (bin - 1)));
+            histogram.put(':');
+            histogram.put_uint(t.histogram[bin]);
+        }
+        histogram.put(" us]\r\n");
+        grbl_send(client, histogram.c_str());
+    }
+    if (!any)
+        grbl_sendf(client, "[MSG:No step timing samples]\r\n");
+}
+
+#endif
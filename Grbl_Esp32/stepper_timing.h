@@ -0,0 +1,62 @@
+/*
+  stepper_timing.h - Step interrupt duration and latency instrumentation
+  Part of Grbl_ESP32
+
+  Grbl is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  Grbl is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with Grbl.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifndef stepper_timing_h
+#define stepper_timing_h
+
+#include "grbl.h"
+
+// Step output backends. Only the one compiled in collects samples, but keeping them apart means
+// a report can never be mistaken for another build's numbers.
+#define ST_TIMING_GPIO 0        // Timed steps, pulse ended by the one-shot timer
+#define ST_TIMING_RMT 1         // Timed steps, pulse generated by the RMT
+#define ST_TIMING_I2S 2         // Pulse callback from the I2S task, once per step period
+#define ST_TIMING_I2S_RENDER 3  // Segment render callback from the I2S task, once per DMA buffer
+#define ST_TIMING_BACKENDS 4
+
+// Duration histogram bins, doubling in width: <1, <2, <4 ... and an open last bin. With 8 bins
+// that is ... <64 and >=64 usec. $ST prints as many as are defined.
+#ifndef ST_TIMING_BINS
+    #define ST_TIMING_BINS 8
+#endif
+
+typedef struct {
+    uint32_t calls;
+    uint32_t duration_min;        // CPU cycles
+    uint32_t duration_max;
+    uint64_t duration_total;
+    uint32_t latency_calls;       // Calls with a latency sample. Timer ISR backends only.
+    uint32_t latency_min;         // Step timer ticks from the alarm to the ISR reading the timer
+    uint32_t latency_max;
+    uint64_t latency_total;
+    uint32_t histogram[ST_TIMING_BINS];
+} st_timing_t;
+
+#ifdef STEPPER_ISR_TIMING
+// Clears all samples.
+void st_timing_reset();
+
+// Records one call of the step function. entry and exit are CCOUNT values. latency is the step
+// timer count at entry, or UINT32_MAX when the backend is not driven by the step timer.
+void IRAM_ATTR st_timing_record(uint8_t backend, uint32_t entry, uint32_t exit, uint32_t latency);
+
+// Prints duration, latency and histogram for each backend that has samples.
+void report_st_timing(uint8_t client);
+#endif
+
+#endif
@@ -29,8 +29,11 @@
 #include "telnet_server.h"
 #include "wificonfig.h"
 #include <WiFi.h>
+#include <lwip/sockets.h>
 
 Telnet_Server telnet_server;
+// The receive buffer is filled by the service task and read by serialCheckTask()
+static portMUX_TYPE telnet_rx_mutex = portMUX_INITIALIZER_UNLOCKED;
 bool Telnet_Server::_setupdone = false;
 uint16_t Telnet_Server::_port = 0;
 WiFiServer* Telnet_Server::_telnetserver = NULL;
@@ -145,6 +148,7 @@ void Telnet_Server::handle() {
                 if (readlen > 0) {
                     _telnetClients[i].read(buf, readlen);
                     push(buf, readlen);
+                    serial_notify_rx();
                 }
                 return;
             }
@@ -154,12 +158,49 @@ void Telnet_Server::handle() {
                 _telnetClientsIP[i] = IPAddress(0, 0, 0, 0);
 #endif
                 _telnetClients[i].stop();
+                // The clients share CLIENT_TELNET, so its autoreports stop with the last one
+                uint8_t j;
+                for (j = 0; j < MAX_TLNT_CLIENTS; j++) {
+                    if (_telnetClients[j] && _telnetClients[j].connected())
+                        break;
+                }
+                if (j >= MAX_TLNT_CLIENTS)
+                    report_autoreport_reset(CLIENT_TELNET);
             }
         }
         COMMANDS::wait(0);
     }
 }
 
+// Sleeps until a telnet client sends something, or for timeout msec. Lets the service task pick
+// up telnet input as it arrives instead of on its next round.
+void Telnet_Server::wait(uint32_t timeout) {
+    fd_set readfds;
+    FD_ZERO(&readfds);
+    int maxfd = -1;
+    if (_setupdone && _telnetserver != NULL && get_rx_buffer_available() > 0) {
+        for (uint8_t i = 0; i < MAX_TLNT_CLIENTS; i++) {
+            if (!_telnetClients[i] || !_telnetClients[i].connected())
+                continue;
+            if (_telnetClients[i].available())
+                return; // Already read from the socket, but not yet taken by handle()
+            int fd = _telnetClients[i].fd();
+            if (fd >= 0) {
+                FD_SET(fd, &readfds);
+                maxfd = MAX(maxfd, fd);
+            }
+        }
+    }
+    if (maxfd < 0) {
+        vTaskDelay(timeout / portTICK_PERIOD_MS);
+        return;
+    }
+    struct timeval tv;
+    tv.tv_sec = timeout / 1000;
+    tv.tv_usec = (timeout % 1000) * 1000;
+    select(maxfd + 1, &readfds, NULL, NULL, &tv);
+}
+
 int Telnet_Server::peek(void) {
     if (_RXbufferSize > 0)return _RXbuffer[_RXbufferpos];
     else return -1;
@@ -175,19 +216,22 @@ int Telnet_Server::get_rx_buffer_available() {
 
 bool Telnet_Server::push(uint8_t data) {
     log_i("[TELNET]push %c", data);
+    vTaskEnterCritical(&telnet_rx_mutex);
     if ((1 + _RXbufferSize) <= TELNETRXBUFFERSIZE) {
         int current = _RXbufferpos + _RXbufferSize;
         if (current > TELNETRXBUFFERSIZE) current = current - TELNETRXBUFFERSIZE;
         if (current > (TELNETRXBUFFERSIZE - 1)) current = 0;
         _RXbuffer[current] = data;
         _RXbufferSize++;
-        log_i("[TELNET]buffer size %d", _RXbufferSize);
+        vTaskExitCritical(&telnet_rx_mutex);
         return true;
     }
+    vTaskExitCritical(&telnet_rx_mutex);
     return false;
 }
 
 bool Telnet_Server::push(const uint8_t* data, int data_size) {
+    vTaskEnterCritical(&telnet_rx_mutex);
     if ((data_size + _RXbufferSize) <= TELNETRXBUFFERSIZE) {
         int data_processed = 0;
         int current = _RXbufferpos + _RXbufferSize;
@@ -199,24 +243,26 @@ bool Telnet_Server::push(const uint8_t* data, int data_size) {
                 current ++;
                 data_processed++;
             }
-            COMMANDS::wait(0);
-            //vTaskDelay(1 / portTICK_RATE_MS);  // Yield to other tasks
         }
         _RXbufferSize += data_processed;
+        vTaskExitCritical(&telnet_rx_mutex);
         return true;
     }
+    vTaskExitCritical(&telnet_rx_mutex);
     return false;
 }
 
 int Telnet_Server::read(void) {
+    int v = -1;
+    vTaskEnterCritical(&telnet_rx_mutex);
     if (_RXbufferSize > 0) {
-        int v = _RXbuffer[_RXbufferpos];
-        //log_d("[TELNET]read %c",char(v));
+        v = _RXbuffer[_RXbufferpos];
         _RXbufferpos++;
         if (_RXbufferpos > (TELNETRXBUFFERSIZE - 1))_RXbufferpos = 0;
         _RXbufferSize--;
-        return v;
-    } else return -1;
+    }
+    vTaskExitCritical(&telnet_rx_mutex);
+    return v;
 }
 
 #endif // Enable TELNET && ENABLE_WIFI
@@ -39,6 +39,7 @@ class Telnet_Server {
     bool begin();
     void end();
     void handle();
+    void wait(uint32_t timeout);
     size_t write(const uint8_t* buffer, size_t size);
     int read(void);
     int peek(void);
@@ -0,0 +1,36 @@
+/*
+    host_sim.h
+    Part of Grbl_ESP32
+
+    Machine of the host build in tests/host. A plain 3 axis machine with
+    timed steps, so the simulated step timer drives the same stepper code
+    as a GPIO stepping board. The pins are only recorded.
+
+    Grbl_ESP32 is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    Grbl is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with Grbl_ESP32.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#define MACHINE_NAME            "Host simulation"
+
+#ifdef USE_RMT_STEPS
+    #undef USE_RMT_STEPS  // The simulated timer replaces the RMT
+#endif
+
+#define X_STEP_PIN              GPIO_NUM_12
+#define X_DIRECTION_PIN         GPIO_NUM_14
+#define Y_STEP_PIN              GPIO_NUM_26
+#define Y_DIRECTION_PIN         GPIO_NUM_15
+#define Z_STEP_PIN              GPIO_NUM_27
+#define Z_DIRECTION_PIN         GPIO_NUM_33
+
+#define SPINDLE_TYPE            SPINDLE_TYPE_NONE
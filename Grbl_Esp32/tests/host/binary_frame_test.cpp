@@ -0,0 +1,356 @@
+/*
+  binary_frame_test.cpp - Host test of the binary stream frame decoder
+  Part of Grbl_ESP32
+
+  Feeds byte streams through binary_frame.cpp on a PC and checks what it queues and NAKs.
+  From the repository root:
+
+    g++ -std=c++11 -Wall -I Grbl_Esp32 Grbl_Esp32/tests/host/binary_frame_test.cpp Grbl_Esp32/binary_frame.cpp -o binary_frame_test
+    ./binary_frame_test
+
+  It is also built and run by the host tests, see CMakeLists.txt.
+
+  Grbl is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  Grbl is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with Grbl.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "binary_frame.h"
+#include <stdio.h>
+#include <string.h>
+#include <limits>
+#include <vector>
+
+static int failures = 0;
+
+#define CHECK(cond)                                                      \
+    do {                                                                 \
+        if (!(cond)) {                                                   \
+            printf("%s:%d: %s: CHECK(%s)\n", __FILE__, __LINE__, test_name, #cond); \
+            failures++;                                                  \
+        }                                                                \
+    } while (0)
+
+static const char* test_name;
+
+typedef std::vector<uint8_t> bytes_t;
+
+// What came out of feeding a run of bytes
+struct result_t {
+    int queued;  // Move frames
+    int ends;
+    int idle;    // Bytes handed back between frames
+    std::vector<int> naks;
+};
+
+static bytes_t frame(uint8_t type, uint8_t seq, uint8_t len) {
+    bytes_t f;
+    f.push_back(type);
+    f.push_back(seq);
+    f.push_back(len);
+    for (uint8_t i = 0; i < len; i++)
+        f.push_back((uint8_t)(seq + i)); // Recognizable payload
+    uint16_t crc = bin_crc16(f.data(), f.size());
+    f.push_back(crc & 0xFF);
+    f.push_back(crc >> 8);
+    f.insert(f.begin(), BIN_FRAME_SYNC);
+    return (f);
+}
+
+static bytes_t move(uint8_t seq) {
+    return (frame(BIN_FRAME_MOVE, seq, BIN_MOVE_SIZE));
+}
+
+static bytes_t moves(uint8_t first, int count) {
+    bytes_t f;
+    for (int i = 0; i < count; i++) {
+        bytes_t m = move(first + i);
+        f.insert(f.end(), m.begin(), m.end());
+    }
+    return (f);
+}
+
+// Feeds the bytes back to back at time now, one msec per 64 bytes like a fast serial line.
+static result_t feed(bin_decoder_t* decoder, const bytes_t& data, uint32_t& now) {
+    result_t r = { 0, 0, 0, {} };
+    for (size_t i = 0; i < data.size(); i++) {
+        if (i && (i % 64) == 0)
+            now++;
+        switch (bin_decoder_receive(decoder, data[i], now)) {
+            case BIN_RX_QUEUED: r.queued++; break;
+            case BIN_RX_END: r.ends++; break;
+            case BIN_RX_IDLE: r.idle++; break;
+            case BIN_RX_NAK: r.naks.push_back(decoder->nak_seq); break;
+        }
+    }
+    return (r);
+}
+
+// Pops every queued frame and returns their sequence numbers.
+static std::vector<int> drain(bin_decoder_t* decoder) {
+    std::vector<int> seqs;
+    bin_frame_t* f;
+    while ((f = bin_decoder_peek(decoder)) != NULL) {
+        seqs.push_back(f->seq);
+        bin_decoder_pop(decoder);
+    }
+    return (seqs);
+}
+
+static void test_stream() {
+    test_name = "stream";
+    bin_decoder_t decoder;
+    bin_decoder_init(&decoder);
+    uint32_t now = 1000;
+    result_t r = feed(&decoder, moves(0, 3), now);
+    CHECK(r.queued == 3 && r.naks.empty() && r.idle == 0);
+    bin_frame_t* f = bin_decoder_peek(&decoder);
+    CHECK(f != NULL && f->type == BIN_FRAME_MOVE && f->seq == 0);
+    CHECK(f->payload[0] == 0 && f->payload[BIN_MOVE_SIZE - 1] == BIN_MOVE_SIZE - 1);
+    CHECK(drain(&decoder) == std::vector<int>({ 0, 1, 2 }));
+    // Realtime commands and line ends between frames are handed back
+    r = feed(&decoder, bytes_t({ '?', '\n' }), now);
+    CHECK(r.idle == 2);
+    r = feed(&decoder, frame(BIN_FRAME_END, 3, 0), now);
+    CHECK(r.ends == 1 && r.naks.empty());
+    CHECK(drain(&decoder) == std::vector<int>({ 3 }));
+}
+
+static void test_sequence_wrap() {
+    test_name = "sequence wrap";
+    bin_decoder_t decoder;
+    bin_decoder_init(&decoder);
+    uint32_t now = 0xFFFFFF00; // The clock wraps during the stream too
+    int queued = 0;
+    for (int seq = 0; seq < 300; seq += 10) {
+        result_t r = feed(&decoder, moves(seq & 0xFF, 10), now);
+        queued += r.queued;
+        CHECK(r.naks.empty());
+        drain(&decoder);
+        now += 3;
+    }
+    CHECK(queued == 300);
+}
+
+static void test_crc_error() {
+    test_name = "crc error";
+    bin_decoder_t decoder;
+    bin_decoder_init(&decoder);
+    uint32_t now = 1000;
+    bytes_t bad = move(0);
+    bad[10] ^= 0x40;
+    // Frames after the bad one are dropped. So are payload bytes that look like realtime commands.
+    bytes_t tail = moves(1, 2);
+    tail[8] = 0x18; // Soft reset
+    tail[9] = '!';  // Feed hold
+    bad.insert(bad.end(), tail.begin(), tail.end());
+    result_t r = feed(&decoder, bad, now);
+    CHECK(r.queued == 0 && r.idle == 0);
+    CHECK(r.naks == std::vector<int>({ 0 }));
+    // A resend without a pause is still dropped
+    r = feed(&decoder, move(0), now);
+    CHECK(r.queued == 0 && r.idle == 0 && r.naks.empty());
+    // After the pause the resend goes through
+    now += BIN_FRAME_TIMEOUT_MS;
+    r = feed(&decoder, moves(0, 2), now);
+    CHECK(r.queued == 2 && r.naks.empty());
+    CHECK(drain(&decoder) == std::vector<int>({ 0, 1 }));
+}
+
+static void test_dropped_byte() {
+    test_name = "dropped byte";
+    bin_decoder_t decoder;
+    bin_decoder_init(&decoder);
+    uint32_t now = 1000;
+    bytes_t data = moves(0, 4);
+    data.erase(data.begin() + 50 + 20); // Inside frame 1
+    result_t r = feed(&decoder, data, now);
+    CHECK(r.queued == 1 && r.idle == 0);
+    CHECK(r.naks == std::vector<int>({ 1 }));
+    now += BIN_FRAME_TIMEOUT_MS;
+    r = feed(&decoder, moves(1, 3), now);
+    CHECK(r.queued == 3 && r.naks.empty());
+    CHECK(drain(&decoder) == std::vector<int>({ 0, 1, 2, 3 }));
+}
+
+static void test_sequence_gap() {
+    test_name = "sequence gap";
+    bin_decoder_t decoder;
+    bin_decoder_init(&decoder);
+    uint32_t now = 1000;
+    bytes_t data = move(0);
+    bytes_t later = moves(2, 3); // Frame 1 is lost
+    data.insert(data.end(), later.begin(), later.end());
+    result_t r = feed(&decoder, data, now);
+    CHECK(r.queued == 1);
+    CHECK(r.naks == std::vector<int>({ 1 })); // Only once per gap
+    // The frames are intact, so the resend does not need a pause
+    r = feed(&decoder, moves(1, 4), now);
+    CHECK(r.queued == 4 && r.naks.empty());
+    CHECK(drain(&decoder) == std::vector<int>({ 0, 1, 2, 3, 4 }));
+}
+
+static void test_window_overrun() {
+    test_name = "window overrun";
+    bin_decoder_t decoder;
+    bin_decoder_init(&decoder);
+    uint32_t now = 1000;
+    result_t r = feed(&decoder, moves(0, BIN_STREAM_WINDOW + 2), now);
+    CHECK(r.queued == BIN_STREAM_WINDOW);
+    CHECK(r.naks == std::vector<int>({ BIN_STREAM_WINDOW }));
+    // One frame runs, so one more fits
+    bin_decoder_pop(&decoder);
+    r = feed(&decoder, moves(BIN_STREAM_WINDOW, 2), now);
+    CHECK(r.queued == 1);
+    CHECK(r.naks == std::vector<int>({ BIN_STREAM_WINDOW + 1 }));
+    std::vector<int> seqs = drain(&decoder);
+    CHECK(seqs.size() == BIN_STREAM_WINDOW && seqs.front() == 1 && seqs.back() == BIN_STREAM_WINDOW);
+}
+
+static void test_bad_frames() {
+    test_name = "bad frames";
+    bin_decoder_t decoder;
+    bin_decoder_init(&decoder);
+    uint32_t now = 1000;
+    // Unknown type and wrong move length pass the CRC, so no resync is needed
+    result_t r = feed(&decoder, frame('X', 0, 0), now);
+    CHECK(r.queued == 0 && r.naks == std::vector<int>({ 0 }));
+    r = feed(&decoder, frame(BIN_FRAME_MOVE, 0, 8), now);
+    CHECK(r.queued == 0 && r.naks.empty());
+    r = feed(&decoder, move(0), now);
+    CHECK(r.queued == 1 && r.naks.empty());
+    // A length past the largest payload loses the framing
+    bytes_t data = { BIN_FRAME_SYNC, BIN_FRAME_MOVE, 1, BIN_FRAME_PAYLOAD_MAX + 1 };
+    bytes_t next = move(1);
+    data.insert(data.end(), next.begin(), next.end());
+    r = feed(&decoder, data, now);
+    CHECK(r.queued == 0 && r.idle == 0 && r.naks == std::vector<int>({ 1 }));
+    now += BIN_FRAME_TIMEOUT_MS;
+    r = feed(&decoder, move(1), now);
+    CHECK(r.queued == 1 && r.naks.empty());
+}
+
+static void test_stalled_frame() {
+    test_name = "stalled frame";
+    bin_decoder_t decoder;
+    bin_decoder_init(&decoder);
+    uint32_t now = 1000;
+    bytes_t data = move(0);
+    bytes_t head(data.begin(), data.begin() + 20);
+    bytes_t rest(data.begin() + 20, data.end());
+    result_t r = feed(&decoder, head, now);
+    CHECK(r.queued == 0 && r.naks.empty());
+    // The rest comes too late. It must not be read as realtime commands or a new frame.
+    now += BIN_FRAME_TIMEOUT_MS;
+    r = feed(&decoder, rest, now);
+    CHECK(r.queued == 0 && r.idle == 0 && r.naks == std::vector<int>({ 0 }));
+    now += BIN_FRAME_TIMEOUT_MS;
+    r = feed(&decoder, move(0), now);
+    CHECK(r.queued == 1 && r.naks.empty());
+    // A host pause between frames is fine
+    now += 10 * BIN_FRAME_TIMEOUT_MS;
+    r = feed(&decoder, bytes_t({ '?' }), now);
+    CHECK(r.idle == 1);
+    r = feed(&decoder, move(1), now);
+    CHECK(r.queued == 1 && r.naks.empty());
+}
+
+static void test_end() {
+    test_name = "end";
+    bin_decoder_t decoder;
+    bin_decoder_init(&decoder);
+    uint32_t now = 1000;
+    bytes_t data = moves(0, 2);
+    bytes_t end = frame(BIN_FRAME_END, 2, 0);
+    data.insert(data.end(), end.begin(), end.end());
+    result_t r = feed(&decoder, data, now);
+    CHECK(r.queued == 2 && r.ends == 1 && r.naks.empty());
+    // END with a payload is rejected
+    bin_decoder_init(&decoder);
+    r = feed(&decoder, frame(BIN_FRAME_END, 0, 4), now);
+    CHECK(r.ends == 0 && r.naks == std::vector<int>({ 0 }));
+}
+
+// A move payload with the given numbers, as a host would pack it
+static bytes_t move_payload(float x, float feed, float speed) {
+    bytes_t p(BIN_MOVE_SIZE, 0);
+    uint32_t line_id = 1234;
+    float target[BIN_MOVE_AXES] = { x, 2.0f, 3.0f, 4.0f, 5.0f, 6.0f };
+    memcpy(&p[0], &line_id, 4);
+    memcpy(&p[4], target, sizeof(target));
+    memcpy(&p[28], &feed, 4);
+    memcpy(&p[32], &speed, 4);
+    p[36] = BIN_MOVE_RAPID;
+    return (p);
+}
+
+static uint8_t check_move(bytes_t payload, uint8_t axes = 3) {
+    bin_move_t move;
+    bin_move_unpack(payload.data(), &move);
+    return (bin_move_check(&move, axes));
+}
+
+static void test_move_check() {
+    test_name = "move check";
+    const float nan = std::numeric_limits<float>::quiet_NaN();
+    const float inf = std::numeric_limits<float>::infinity();
+    bin_move_t move;
+    bin_move_unpack(move_payload(1.5f, 600.0f, 12000.0f).data(), &move);
+    CHECK(move.line_id == 1234 && move.flags == BIN_MOVE_RAPID);
+    CHECK(move.target[0] == 1.5f && move.target[5] == 6.0f);
+    CHECK(move.feed_rate == 600.0f && move.spindle_speed == 12000.0f);
+    CHECK(bin_move_check(&move, 3) == BIN_MOVE_OK);
+    // Zero speed is a spindle or laser off, and -0.0 is still zero
+    CHECK(check_move(move_payload(0.0f, 600.0f, 0.0f)) == BIN_MOVE_OK);
+    CHECK(check_move(move_payload(0.0f, 600.0f, -0.0f)) == BIN_MOVE_OK);
+    // Targets
+    CHECK(check_move(move_payload(nan, 600.0f, 0.0f)) == BIN_MOVE_NOT_FINITE);
+    CHECK(check_move(move_payload(inf, 600.0f, 0.0f)) == BIN_MOVE_NOT_FINITE);
+    CHECK(check_move(move_payload(-inf, 600.0f, 0.0f)) == BIN_MOVE_NOT_FINITE);
+    bytes_t p = move_payload(0.0f, 600.0f, 0.0f);
+    memcpy(&p[4 + 2 * 4], &nan, 4); // Z
+    CHECK(check_move(p) == BIN_MOVE_NOT_FINITE);
+    // Axes past the machine's are ignored, whatever they hold
+    p = move_payload(0.0f, 600.0f, 0.0f);
+    memcpy(&p[4 + 5 * 4], &nan, 4);
+    CHECK(check_move(p, 3) == BIN_MOVE_OK);
+    CHECK(check_move(p, 6) == BIN_MOVE_NOT_FINITE);
+    // Feed rate, even on a rapid
+    CHECK(check_move(move_payload(0.0f, nan, 0.0f)) == BIN_MOVE_NOT_FINITE);
+    CHECK(check_move(move_payload(0.0f, inf, 0.0f)) == BIN_MOVE_NOT_FINITE);
+    CHECK(check_move(move_payload(0.0f, -inf, 0.0f)) == BIN_MOVE_NOT_FINITE);
+    // Spindle speed
+    CHECK(check_move(move_payload(0.0f, 600.0f, nan)) == BIN_MOVE_NOT_FINITE);
+    CHECK(check_move(move_payload(0.0f, 600.0f, inf)) == BIN_MOVE_NOT_FINITE);
+    CHECK(check_move(move_payload(0.0f, 600.0f, -inf)) == BIN_MOVE_NOT_FINITE);
+    CHECK(check_move(move_payload(0.0f, 600.0f, -1.0f)) == BIN_MOVE_NEGATIVE_SPEED);
+    CHECK(check_move(move_payload(0.0f, 600.0f, -1e-6f)) == BIN_MOVE_NEGATIVE_SPEED);
+}
+
+int main() {
+    test_stream();
+    test_sequence_wrap();
+    test_crc_error();
+    test_dropped_byte();
+    test_sequence_gap();
+    test_window_overrun();
+    test_bad_frames();
+    test_stalled_frame();
+    test_end();
+    test_move_check();
+    if (failures) {
+        printf("%d checks failed\n", failures);
+        return (1);
+    }
+    printf("All binary frame tests passed\n");
+    return (0);
+}
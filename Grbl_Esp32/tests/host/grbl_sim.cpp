@@ -0,0 +1,212 @@
+/*
+  grbl_sim.cpp - Replays g-code files through the motion core on a PC
+  Part of Grbl_ESP32
+
+  Streams each file through gc_execute_line() as fast as the planner takes it, runs the stepper
+  on the simulated clock, and reports the parse, plan and segment rates in host CPU time along
+  with the simulated job time. See tests/host/CMakeLists.txt for the build.
+
+    grbl_sim [-q] [-t timeline.txt] [-s NAME=VALUE]... [-c] file.nc...
+
+    -q  Only print the summary of each file
+    -t  Write the step/dir timeline to a file, see sim.h for the format
+    -s  Change a setting before the replay, by its $ number or name, e.g. -s 32=1
+    -c  Check the g-code fast path instead of running the job. Each line goes through
+        gc_fast_path_compare() in check mode, as $SD/FastPathCheck does.
+
+  The exit status is not zero if a line fails, an alarm is raised, the steppers do not end up
+  where the parser put them, or the fast path disagrees with the full parser. A comment with
+  "Expected error:N" in it expects the next line that fails to fail with that status, before the
+  next such comment.
+
+  Grbl is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  Grbl is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with Grbl.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "grbl.h"
+#include "sim.h"
+#include <chrono>
+
+extern uint8_t sim_alarm;
+extern void make_settings();
+
+static bool sim_set(char* assignment) {
+    char* value = strchr(assignment, '=');
+    if (value == NULL)
+        return false;
+    *value++ = '\0';
+    for (Setting* s = Setting::List; s; s = s->next()) {
+        if ((s->getGrblName() && strcasecmp(s->getGrblName(), assignment) == 0) || strcasecmp(s->getName(), assignment) == 0)
+            return s->setStringValue(value) == STATUS_OK;
+    }
+    return false;
+}
+
+// The power-up and reset sequence of Grbl_Esp32.ino, less the serial and network clients
+static void sim_reset() {
+    memset(&sys, 0, sizeof(system_t));
+    sys.state = STATE_IDLE;
+    sys.f_override = DEFAULT_FEED_OVERRIDE;
+    sys.r_override = DEFAULT_RAPID_OVERRIDE;
+    sys.spindle_speed_ovr = DEFAULT_SPINDLE_SPEED_OVERRIDE;
+    memset(sys_probe_position, 0, sizeof(sys_probe_position));
+    sys_probe_state = 0;
+    sys_rt_exec_state = 0;
+    sys_rt_exec_alarm = 0;
+    sys_rt_exec_motion_override = 0;
+    sys_rt_exec_accessory_override = 0;
+    sim_alarm = 0;
+    gc_init();
+    spindle->stop();
+    coolant_init();
+    probe_init();
+    mc_line_queue_reset();
+    plan_reset();
+    st_reset();
+    plan_sync_position();
+    gc_sync_position();
+}
+
+static uint32_t sim_missed_error(uint8_t expected, uint32_t line) {
+    if (expected == STATUS_OK)
+        return 0;
+    printf("[MSG:No error:%d before line %u]\n", expected, line);
+    return 1;
+}
+
+// Runs one file. Returns the number of failures.
+static uint32_t sim_replay(const char* path, bool check_fast_path) {
+    FILE* file = fopen(path, "r");
+    if (file == NULL) {
+        printf("[MSG:Cannot open %s]\n", path);
+        return 1;
+    }
+    sim_reset();
+    if (check_fast_path)
+        sys.state = STATE_CHECK_MODE;
+    motion_stats_reset();
+    uint64_t start_ticks = sim_ticks;
+    auto start = std::chrono::steady_clock::now();
+
+    char line[256]; // As long as a line read from the SD card
+    uint32_t failures = 0, lines = 0, taken = 0, differ = 0;
+    uint8_t expected = STATUS_OK;
+    while (fgets(line, sizeof(line), file) != NULL) {
+        sd_current_line_number = ++lines;
+        line[strcspn(line, "\r\n")] = '\0';
+        const char* note = strstr(line, "Expected error:");
+        if (note != NULL) {
+            failures += sim_missed_error(expected, lines);
+            expected = atoi(note + strlen("Expected error:"));
+        }
+        uint8_t status;
+        if (check_fast_path) {
+            uint8_t result;
+            status = gc_fast_path_compare(line, CLIENT_SERIAL, &result);
+            if (result != GC_FAST_PATH_NOT_TAKEN)
+                taken++;
+            if (result == GC_FAST_PATH_DIFFERS) {
+                differ++;
+                printf("[MSG:Fast path differs at line %u]\n", lines);
+            }
+        } else
+            status = gc_execute_line(line, CLIENT_SERIAL);
+        if (status != STATUS_OK) {
+            if (status != expected) {
+                failures++;
+                printf("[MSG:error:%d at line %u]\n", status, lines);
+            }
+            expected = STATUS_OK;
+        }
+        protocol_execute_realtime();
+        if (sys.abort)
+            break;
+    }
+    fclose(file);
+    failures += sim_missed_error(expected, lines);
+    if (!sys.abort)
+        protocol_buffer_synchronize();
+
+    double cpu = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    double job = (sim_ticks - start_ticks) / (SIM_TICKS_PER_USEC * 1e6);
+    printf("[MSG:%s: %u lines, %u failed, %.3f s simulated, %.3f s host]\n", path, lines, failures, job, cpu);
+    if (check_fast_path) {
+        printf("[MSG:%u on the fast path, %u differ]\n", taken, differ);
+        failures += differ;
+    } else {
+        printf("[MSG:Lines %u %.1f/s]\n", motion_stats.lines_parsed, motion_stats.lines_parsed / cpu);
+        printf("[MSG:Blocks %u %.1f/s]\n", motion_stats.blocks_planned, motion_stats.blocks_planned / cpu);
+        printf("[MSG:Segments %u %.1f/s]\n", motion_stats.segments_prepped, motion_stats.segments_prepped / cpu);
+    }
+    if (sys.abort || sim_alarm) {
+        printf("[MSG:Stopped by %s %d]\n", sim_alarm ? "alarm" : "abort", sim_alarm);
+        return failures + 1;
+    }
+    if (!check_fast_path) {
+        for (uint8_t idx = 0; idx < N_AXIS; idx++) {
+            int32_t steps = lround(gc_state.position[idx] * axis_settings[idx]->steps_per_mm->get());
+            if (abs(steps - sys_position[idx]) > 1) {
+                printf("[MSG:Axis %d at step %d, the parser is at step %d]\n", idx, sys_position[idx], steps);
+                failures++;
+            }
+        }
+    }
+    return failures;
+}
+
+int main(int argc, char** argv) {
+    EEPROM.begin(EEPROM_SIZE);
+    make_settings();
+    for (Setting* s = Setting::List; s; s = s->next())
+        s->load();
+
+    bool check_fast_path = false;
+    int arg = 1;
+    for (; arg < argc && argv[arg][0] == '-'; arg++) {
+        if (strcmp(argv[arg], "-q") == 0)
+            sim_echo = false;
+        else if (strcmp(argv[arg], "-c") == 0)
+            check_fast_path = true;
+        else if (strcmp(argv[arg], "-t") == 0 && arg + 1 < argc) {
+            sim_timeline = fopen(argv[++arg], "w");
+            if (sim_timeline == NULL) {
+                printf("[MSG:Cannot write %s]\n", argv[arg]);
+                return EXIT_FAILURE;
+            }
+        } else if (strcmp(argv[arg], "-s") == 0 && arg + 1 < argc) {
+            if (!sim_set(argv[++arg])) {
+                printf("[MSG:Bad setting %s]\n", argv[arg]);
+                return EXIT_FAILURE;
+            }
+        } else {
+            printf("[MSG:Unknown option %s]\n", argv[arg]);
+            return EXIT_FAILURE;
+        }
+    }
+    if (arg == argc) {
+        printf("usage: grbl_sim [-q] [-t timeline.txt] [-s NAME=VALUE]... [-c] file.nc...\n");
+        return EXIT_FAILURE;
+    }
+
+    plan_init();
+    stepper_init();
+    spindle_select();
+    memset(sys_position, 0, sizeof(sys_position));
+
+    uint32_t failures = 0;
+    for (; arg < argc; arg++)
+        failures += sim_replay(argv[arg], check_fast_path);
+    if (sim_timeline != NULL)
+        fclose(sim_timeline);
+    return failures ? EXIT_FAILURE : EXIT_SUCCESS;
+}
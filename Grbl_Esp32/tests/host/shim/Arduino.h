@@ -0,0 +1,194 @@
+/*
+  Arduino.h - Stand-in for the ESP32 Arduino core in the host build
+  Part of Grbl_ESP32
+
+  Grbl is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  Grbl is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with Grbl.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#pragma once
+
+// Only what the motion core and the settings need. Time is the simulated clock of the host
+// build, see sim_ticks in tests/host/sim.h, and pins only record what was written to them.
+#include <stdint.h>
+#include <stdlib.h>
+#include <stddef.h>
+#include <stdio.h>
+#include <stdarg.h>
+#include <string.h>
+#include <strings.h>
+#include <ctype.h>
+#include <math.h>
+#include <string>
+#include <algorithm>
+#include <limits>
+#include <stdexcept>
+
+#include "sdkconfig.h"
+#include "binary.h"
+#include "esp_err.h"
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+#include "freertos/semphr.h"
+#include "freertos/queue.h"
+#include "driver/gpio.h"
+#include "Print.h"
+
+typedef bool boolean;
+typedef uint8_t byte;
+typedef unsigned int word;
+
+#define IRAM_ATTR
+#define DRAM_ATTR
+#define PROGMEM
+#define F(s) (s)
+
+#define HIGH 0x1
+#define LOW 0x0
+#define INPUT 0x01
+#define OUTPUT 0x02
+#define PULLUP 0x04
+#define INPUT_PULLUP 0x05
+#define PULLDOWN 0x08
+#define INPUT_PULLDOWN 0x09
+
+#define RISING 0x01
+#define FALLING 0x02
+#define CHANGE 0x03
+
+#define DEC 10
+#define HEX 16
+
+#ifndef PI
+    #define PI 3.1415926535897932384626433832795
+#endif
+
+using std::min;
+using std::max;
+
+#define bit(b) (1UL << (b))
+#define bitRead(value, b) (((value) >> (b)) & 0x01)
+#define bitSet(value, b) ((value) |= (1UL << (b)))
+#define bitClear(value, b) ((value) &= ~(1UL << (b)))
+
+#define constrain(amt, low, high) ((amt) < (low) ? (low) : ((amt) > (high) ? (high) : (amt)))
+
+uint32_t millis();
+uint32_t micros();
+void delay(uint32_t ms);
+void delayMicroseconds(uint32_t us);
+uint32_t xthal_get_ccount();  // 240 MHz CPU cycles of the simulated clock
+int64_t esp_timer_get_time();
+uint32_t getApbFrequency();
+
+void pinMode(uint8_t pin, uint8_t mode);
+void digitalWrite(uint8_t pin, uint8_t val);
+int digitalRead(uint8_t pin);
+double ledcSetup(uint8_t channel, double frequency, uint8_t resolution);
+void ledcAttachPin(uint8_t pin, uint8_t channel);
+void ledcWrite(uint8_t channel, uint32_t duty);
+void dacWrite(uint8_t pin, uint8_t value);
+void attachInterrupt(uint8_t pin, void (*handler)(void), int mode);
+void detachInterrupt(uint8_t pin);
+
+class EspClass {
+public:
+    uint32_t getCycleCount() { return xthal_get_ccount(); }
+    uint32_t getCpuFreqMHz() { return 240; }
+    uint32_t getFreeHeap() { return 200000; }
+};
+extern EspClass ESP;
+
+long random(long max);
+long random(long min, long max);
+
+// Arduino String, as far as Grbl uses it
+class String {
+public:
+    String() {}
+    String(const char* s) : _s(s ? s : "") {}
+    String(const std::string& s) : _s(s) {}
+    String(char c) : _s(1, c) {}
+    String(int v, int base = DEC) { _s = number(v, base); }
+    String(unsigned int v, int base = DEC) { _s = number(v, base); }
+    String(long v, int base = DEC) { _s = number(v, base); }
+    String(unsigned long v, int base = DEC) { _s = number(v, base); }
+    String(float v, unsigned int places = 2) { _s = fixed(v, places); }
+    String(double v, unsigned int places = 2) { _s = fixed(v, places); }
+
+    const char* c_str() const { return _s.c_str(); }
+    unsigned int length() const { return _s.length(); }
+    char operator[](unsigned int i) const { return i < _s.length() ? _s[i] : 0; }
+    char charAt(unsigned int i) const { return (*this)[i]; }
+    void setCharAt(unsigned int i, char c) { if (i < _s.length()) _s[i] = c; }
+    bool operator==(const String& o) const { return _s == o._s; }
+    bool operator==(const char* o) const { return _s == (o ? o : ""); }
+    bool operator!=(const String& o) const { return _s != o._s; }
+    bool operator!=(const char* o) const { return !(*this == o); }
+    bool operator<(const String& o) const { return _s < o._s; }
+    String& operator+=(const String& o) { _s += o._s; return *this; }
+    String& operator+=(const char* o) { _s += o ? o : ""; return *this; }
+    String& operator+=(char c) { _s += c; return *this; }
+    String& operator+=(int v) { _s += number(v, DEC); return *this; }
+    bool concat(const String& o) { _s += o._s; return true; }
+    bool concat(const char* o) { _s += o ? o : ""; return true; }
+    bool concat(char c) { _s += c; return true; }
+    friend String operator+(const String& a, const String& b) { return String(a._s + b._s); }
+    friend String operator+(const String& a, const char* b) { return String(a._s + (b ? b : "")); }
+    friend String operator+(const char* a, const String& b) { return String((a ? a : "") + b._s); }
+    friend String operator+(const String& a, char b) { return String(a._s + b); }
+    int indexOf(char c, unsigned int from = 0) const { return find(_s.find(c, from)); }
+    int indexOf(const String& s, unsigned int from = 0) const { return find(_s.find(s._s, from)); }
+    int lastIndexOf(char c) const { return find(_s.rfind(c)); }
+    String substring(unsigned int from) const { return from < _s.length() ? String(_s.substr(from)) : String(); }
+    String substring(unsigned int from, unsigned int to) const {
+        if (from > to) std::swap(from, to);
+        return from < _s.length() ? String(_s.substr(from, to - from)) : String();
+    }
+    bool startsWith(const String& s) const { return _s.compare(0, s._s.length(), s._s) == 0; }
+    bool endsWith(const String& s) const {
+        return _s.length() >= s._s.length() && _s.compare(_s.length() - s._s.length(), s._s.length(), s._s) == 0;
+    }
+    bool equalsIgnoreCase(const String& s) const { return strcasecmp(c_str(), s.c_str()) == 0; }
+    void toUpperCase() { for (auto& c : _s) c = toupper(c); }
+    void toLowerCase() { for (auto& c : _s) c = tolower(c); }
+    void trim() {
+        size_t a = _s.find_first_not_of(" \t\r\n");
+        size_t b = _s.find_last_not_of(" \t\r\n");
+        _s = (a == std::string::npos) ? "" : _s.substr(a, b - a + 1);
+    }
+    void replace(const String& from, const String& to) {
+        if (from._s.empty()) return;
+        for (size_t pos = 0; (pos = _s.find(from._s, pos)) != std::string::npos; pos += to._s.length())
+            _s.replace(pos, from._s.length(), to._s);
+    }
+    void remove(unsigned int index) { if (index < _s.length()) _s.erase(index); }
+    void remove(unsigned int index, unsigned int count) { if (index < _s.length()) _s.erase(index, count); }
+    long toInt() const { return atol(c_str()); }
+    float toFloat() const { return atof(c_str()); }
+    bool reserve(unsigned int size) { _s.reserve(size); return true; }
+
+private:
+    std::string _s;
+    static int find(size_t pos) { return pos == std::string::npos ? -1 : (int)pos; }
+    static std::string number(long v, int base) {
+        char buf[34];
+        snprintf(buf, sizeof(buf), base == HEX ? "%lx" : "%ld", v);
+        return buf;
+    }
+    static std::string fixed(double v, unsigned int places) {
+        char buf[48];
+        snprintf(buf, sizeof(buf), "%.*f", places, v);
+        return buf;
+    }
+};
@@ -0,0 +1,38 @@
+/*
+  EEPROM.h - EEPROM emulation for the host build
+  Part of Grbl_ESP32
+
+  Grbl is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  Grbl is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with Grbl.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#pragma once
+
+// Coordinate data and the other EEPROM records, kept in memory for the run
+#include <stdint.h>
+#include <stddef.h>
+
+class EEPROMClass {
+public:
+    bool begin(size_t size) { return size <= sizeof(_data); }
+    uint8_t read(int address) { return (address >= 0 && address < (int)sizeof(_data)) ? _data[address] : 0; }
+    void write(int address, uint8_t value) {
+        if (address >= 0 && address < (int)sizeof(_data))
+            _data[address] = value;
+    }
+    bool commit() { return true; }
+
+private:
+    uint8_t _data[4096];
+};
+extern EEPROMClass EEPROM;
@@ -0,0 +1,54 @@
+/*
+  WiFi.h - WiFi types for the host build
+  Part of Grbl_ESP32
+
+  Grbl is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  Grbl is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with Grbl.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#pragma once
+
+#include <Arduino.h>
+
+typedef int WiFiEvent_t;
+
+class WiFiServer;
+class WiFiClient;
+
+class IPAddress {
+public:
+    IPAddress() : _address(0) {}
+    IPAddress(uint8_t a, uint8_t b, uint8_t c, uint8_t d) : _address(a | (b << 8) | (c << 16) | ((uint32_t)d << 24)) {}
+    IPAddress(uint32_t address) : _address(address) {}
+    operator uint32_t() const { return _address; }
+    bool operator==(const IPAddress& o) const { return _address == o._address; }
+    bool operator!=(const IPAddress& o) const { return _address != o._address; }
+    bool fromString(const char* s) {
+        unsigned int a, b, c, d;
+        char end;
+        if (sscanf(s, "%u.%u.%u.%u%c", &a, &b, &c, &d, &end) != 4 || a > 255 || b > 255 || c > 255 || d > 255)
+            return false;
+        *this = IPAddress(a, b, c, d);
+        return true;
+    }
+    bool fromString(const String& s) { return fromString(s.c_str()); }
+    String toString() const {
+        char buf[16];
+        snprintf(buf, sizeof(buf), "%u.%u.%u.%u", _address & 0xff, (_address >> 8) & 0xff, (_address >> 16) & 0xff,
+                 _address >> 24);
+        return String(buf);
+    }
+
+private:
+    uint32_t _address;
+};
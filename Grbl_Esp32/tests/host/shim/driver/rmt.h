@@ -0,0 +1,36 @@
+/*
+  driver/rmt.h - RMT peripheral types for the host build
+  Part of Grbl_ESP32
+
+  Grbl is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  Grbl is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with Grbl.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#pragma once
+
+// Only the types. The host build steps with the timer, see tests/host/sim_machine.h.
+#include <stdint.h>
+
+typedef enum { RMT_CHANNEL_0 = 0, RMT_CHANNEL_MAX = 8 } rmt_channel_t;
+
+typedef struct {
+    uint32_t val;
+} rmt_item32_t;
+
+typedef struct {
+    int rmt_mode;
+    rmt_channel_t channel;
+    int gpio_num;
+    uint8_t clk_div;
+    uint8_t mem_block_num;
+} rmt_config_t;
@@ -0,0 +1,79 @@
+/*
+  driver/timer.h - ESP32 general purpose timers for the host build
+  Part of Grbl_ESP32
+
+  Grbl is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  Grbl is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with Grbl.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#pragma once
+
+// The timers are simulated in tests/host/sim.cpp. Only the handlers of timer group 0, the step
+// timer and the step pulse off timer, are ever called.
+#include "esp_err.h"
+#include <stdint.h>
+
+typedef enum { TIMER_GROUP_0 = 0, TIMER_GROUP_1 = 1, TIMER_GROUP_MAX } timer_group_t;
+typedef enum { TIMER_0 = 0, TIMER_1 = 1, TIMER_MAX } timer_idx_t;
+typedef enum { TIMER_COUNT_DOWN = 0, TIMER_COUNT_UP = 1 } timer_count_dir_t;
+typedef enum { TIMER_PAUSE = 0, TIMER_START = 1 } timer_start_t;
+typedef enum { TIMER_ALARM_DIS = 0, TIMER_ALARM_EN = 1 } timer_alarm_t;
+typedef enum { TIMER_INTR_LEVEL = 0 } timer_intr_mode_t;
+typedef enum { TIMER_AUTORELOAD_DIS = 0, TIMER_AUTORELOAD_EN = 1 } timer_autoreload_t;
+
+typedef struct {
+    timer_alarm_t alarm_en;
+    timer_start_t counter_en;
+    timer_intr_mode_t intr_type;
+    timer_count_dir_t counter_dir;
+    bool auto_reload;
+    uint32_t divider;
+} timer_config_t;
+
+typedef void* timer_isr_handle_t;
+
+// Register layout, as far as the stepper touches it
+typedef struct {
+    struct {
+        uint32_t alarm_en;
+        uint32_t autoreload;
+        uint32_t enable;
+    } config;
+    uint32_t cnt_low;
+    uint32_t cnt_high;
+    uint32_t update;
+    uint32_t alarm_low;
+    uint32_t alarm_high;
+} sim_hw_timer_t;
+
+typedef struct {
+    sim_hw_timer_t hw_timer[2];
+    struct {
+        uint32_t t0;
+        uint32_t t1;
+    } int_clr_timers;
+} sim_timg_t;
+
+extern sim_timg_t TIMERG0;
+extern sim_timg_t TIMERG1;
+
+esp_err_t timer_init(timer_group_t group, timer_idx_t timer, const timer_config_t* config);
+esp_err_t timer_set_counter_value(timer_group_t group, timer_idx_t timer, uint64_t value);
+esp_err_t timer_get_counter_value(timer_group_t group, timer_idx_t timer, uint64_t* value);
+esp_err_t timer_set_alarm_value(timer_group_t group, timer_idx_t timer, uint64_t value);
+esp_err_t timer_set_alarm(timer_group_t group, timer_idx_t timer, timer_alarm_t alarm);
+esp_err_t timer_start(timer_group_t group, timer_idx_t timer);
+esp_err_t timer_pause(timer_group_t group, timer_idx_t timer);
+esp_err_t timer_enable_intr(timer_group_t group, timer_idx_t timer);
+esp_err_t timer_isr_register(timer_group_t group, timer_idx_t timer, void (*handler)(void*), void* arg,
+                             int flags, timer_isr_handle_t* handle);
@@ -0,0 +1,57 @@
+/*
+  driver/uart.h - UART driver types for the host build
+  Part of Grbl_ESP32
+
+  Grbl is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  Grbl is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with Grbl.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#pragma once
+
+#include "esp_err.h"
+#include <stdint.h>
+#include <stddef.h>
+
+typedef enum { UART_NUM_0 = 0, UART_NUM_1 = 1, UART_NUM_2 = 2, UART_NUM_MAX } uart_port_t;
+
+// Only the RS485 spindles use a UART. Writes are dropped and reads return nothing.
+#include "freertos/FreeRTOS.h"
+#include "freertos/queue.h"
+
+typedef enum { UART_DATA_5_BITS, UART_DATA_6_BITS, UART_DATA_7_BITS, UART_DATA_8_BITS } uart_word_length_t;
+typedef enum { UART_PARITY_DISABLE, UART_PARITY_EVEN = 2, UART_PARITY_ODD } uart_parity_t;
+typedef enum { UART_STOP_BITS_1 = 1, UART_STOP_BITS_1_5, UART_STOP_BITS_2 } uart_stop_bits_t;
+typedef enum { UART_HW_FLOWCTRL_DISABLE } uart_hw_flowcontrol_t;
+typedef enum { UART_MODE_UART, UART_MODE_RS485_HALF_DUPLEX } uart_mode_t;
+
+#define UART_PIN_NO_CHANGE (-1)
+
+typedef struct {
+    int baud_rate;
+    uart_word_length_t data_bits;
+    uart_parity_t parity;
+    uart_stop_bits_t stop_bits;
+    uart_hw_flowcontrol_t flow_ctrl;
+    uint8_t rx_flow_ctrl_thresh;
+} uart_config_t;
+
+esp_err_t uart_param_config(uart_port_t port, const uart_config_t* config);
+esp_err_t uart_set_pin(uart_port_t port, int tx, int rx, int rts, int cts);
+esp_err_t uart_driver_install(uart_port_t port, int rx_size, int tx_size, int queue_size, QueueHandle_t* queue,
+                              int flags);
+esp_err_t uart_driver_delete(uart_port_t port);
+esp_err_t uart_set_mode(uart_port_t port, uart_mode_t mode);
+esp_err_t uart_flush(uart_port_t port);
+int uart_read_bytes(uart_port_t port, uint8_t* data, uint32_t length, TickType_t ticks);
+int uart_write_bytes(uart_port_t port, const char* data, size_t size);
+esp_err_t uart_get_baudrate(uart_port_t port, uint32_t* baudrate);
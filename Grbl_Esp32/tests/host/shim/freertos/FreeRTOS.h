@@ -0,0 +1,57 @@
+/*
+  freertos/FreeRTOS.h - FreeRTOS types for the host build
+  Part of Grbl_ESP32
+
+  Grbl is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  Grbl is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with Grbl.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#pragma once
+
+// The host build runs in one thread. Critical sections and mutexes have nothing to guard, and
+// tasks are never started: the simulation calls what the tasks would, see tests/host/sim.cpp.
+#include <stdint.h>
+
+typedef int32_t BaseType_t;
+typedef uint32_t UBaseType_t;
+typedef uint32_t TickType_t;
+
+#define pdFALSE 0
+#define pdTRUE 1
+#define pdPASS pdTRUE
+#define pdFAIL pdFALSE
+#define portMAX_DELAY ((TickType_t)0xffffffffUL)
+#define portTICK_PERIOD_MS 1
+#define portTICK_RATE_MS portTICK_PERIOD_MS
+#define pdMS_TO_TICKS(ms) ((TickType_t)(ms))
+#define configTICK_RATE_HZ 1000
+
+typedef struct {
+    uint32_t owner;
+    uint32_t count;
+} portMUX_TYPE;
+#define portMUX_INITIALIZER_UNLOCKED { 0, 0 }
+
+static inline void vTaskEnterCritical(portMUX_TYPE* mux) { mux->count++; }
+static inline void vTaskExitCritical(portMUX_TYPE* mux) { mux->count--; }
+#define portENTER_CRITICAL(mux) vTaskEnterCritical(mux)
+#define portEXIT_CRITICAL(mux) vTaskExitCritical(mux)
+#define portENTER_CRITICAL_ISR(mux) vTaskEnterCritical(mux)
+#define portEXIT_CRITICAL_ISR(mux) vTaskExitCritical(mux)
+#define portYIELD_FROM_ISR()
+#define portDISABLE_INTERRUPTS()
+#define portENABLE_INTERRUPTS()
+
+// True while the simulation runs an interrupt handler
+BaseType_t xPortInIsrContext();
+uint32_t xPortGetCoreID();
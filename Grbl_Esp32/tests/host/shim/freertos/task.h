@@ -0,0 +1,40 @@
+/*
+  freertos/task.h - FreeRTOS tasks for the host build
+  Part of Grbl_ESP32
+
+  Grbl is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  Grbl is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with Grbl.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#pragma once
+
+#include "freertos/FreeRTOS.h"
+
+typedef void* TaskHandle_t;
+typedef void (*TaskFunction_t)(void*);
+
+// Tasks are not run, but get a handle, so code that wakes one does. The notifications are
+// counted for the simulation, which then does what the segment prep task would, see sim.h.
+BaseType_t xTaskCreatePinnedToCore(TaskFunction_t task, const char* name, uint32_t stack, void* parameters,
+                                   UBaseType_t priority, TaskHandle_t* handle, BaseType_t core);
+BaseType_t xTaskCreate(TaskFunction_t task, const char* name, uint32_t stack, void* parameters,
+                       UBaseType_t priority, TaskHandle_t* handle);
+void vTaskDelay(TickType_t ticks);
+void vTaskDelayUntil(TickType_t* previous, TickType_t ticks);
+TickType_t xTaskGetTickCount();
+TickType_t xTaskGetTickCountFromISR();
+uint32_t ulTaskNotifyTake(BaseType_t clear, TickType_t ticks);
+BaseType_t xTaskNotifyGive(TaskHandle_t task);
+void vTaskNotifyGiveFromISR(TaskHandle_t task, BaseType_t* woken);
+TaskHandle_t xTaskGetCurrentTaskHandle();
+UBaseType_t uxTaskGetStackHighWaterMark(TaskHandle_t task);
@@ -0,0 +1,51 @@
+/*
+  nvs.h - NVS for the host build
+  Part of Grbl_ESP32
+
+  Grbl is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  Grbl is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with Grbl.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#pragma once
+
+// Keeps the values in memory, so every run starts from the defaults.
+#include "esp_err.h"
+#include <stdint.h>
+#include <stddef.h>
+
+typedef uint32_t nvs_handle;
+typedef nvs_handle nvs_handle_t;
+
+typedef enum { NVS_READONLY, NVS_READWRITE } nvs_open_mode;
+
+typedef struct {
+    size_t used_entries;
+    size_t free_entries;
+    size_t total_entries;
+    size_t namespace_count;
+} nvs_stats_t;
+
+esp_err_t nvs_open(const char* name, nvs_open_mode mode, nvs_handle* handle);
+void nvs_close(nvs_handle handle);
+esp_err_t nvs_get_i8(nvs_handle handle, const char* key, int8_t* value);
+esp_err_t nvs_set_i8(nvs_handle handle, const char* key, int8_t value);
+esp_err_t nvs_get_i32(nvs_handle handle, const char* key, int32_t* value);
+esp_err_t nvs_set_i32(nvs_handle handle, const char* key, int32_t value);
+esp_err_t nvs_get_str(nvs_handle handle, const char* key, char* value, size_t* length);
+esp_err_t nvs_set_str(nvs_handle handle, const char* key, const char* value);
+esp_err_t nvs_get_blob(nvs_handle handle, const char* key, void* value, size_t* length);
+esp_err_t nvs_set_blob(nvs_handle handle, const char* key, const void* value, size_t length);
+esp_err_t nvs_erase_key(nvs_handle handle, const char* key);
+esp_err_t nvs_erase_all(nvs_handle handle);
+esp_err_t nvs_commit(nvs_handle handle);
+esp_err_t nvs_get_stats(const char* partition, nvs_stats_t* stats);
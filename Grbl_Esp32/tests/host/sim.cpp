@@ -0,0 +1,156 @@
+/*
+  sim.cpp - Simulated clock and step timer of the host build
+  Part of Grbl_ESP32
+
+  The timers count at the step timer rate, which is the rate the stepper configures both of its
+  timers for. An alarm disables itself when it fires and the handler re-enables it, as on the
+  ESP32, and an auto reload timer restarts from zero at the alarm.
+
+  Grbl is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  Grbl is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with Grbl.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "grbl.h"
+#include "sim.h"
+
+static_assert(SIM_TICKS_PER_USEC == TICKS_PER_MICROSECOND, "The simulated clock runs at the step timer rate");
+
+uint64_t sim_ticks;
+bool sim_in_isr;
+FILE* sim_timeline;
+bool sim_echo = true;
+
+sim_timg_t TIMERG0;
+sim_timg_t TIMERG1;
+
+typedef struct {
+    void (*handler)(void*);
+    void* arg;
+    uint64_t zero;  // sim_ticks at which the counter was zero
+} sim_timer_t;
+static sim_timer_t sim_timer[TIMER_GROUP_MAX][TIMER_MAX];
+
+static sim_hw_timer_t* sim_hw(timer_group_t group, timer_idx_t timer) {
+    return &(group == TIMER_GROUP_0 ? TIMERG0 : TIMERG1).hw_timer[timer];
+}
+
+esp_err_t timer_init(timer_group_t group, timer_idx_t timer, const timer_config_t* config) {
+    sim_hw_timer_t* hw = sim_hw(group, timer);
+    hw->config.alarm_en = config->alarm_en;
+    hw->config.autoreload = config->auto_reload;
+    hw->config.enable = config->counter_en;
+    sim_timer[group][timer].zero = sim_ticks;
+    return ESP_OK;
+}
+
+esp_err_t timer_set_counter_value(timer_group_t group, timer_idx_t timer, uint64_t value) {
+    sim_timer[group][timer].zero = sim_ticks - value;
+    return ESP_OK;
+}
+
+esp_err_t timer_get_counter_value(timer_group_t group, timer_idx_t timer, uint64_t* value) {
+    *value = sim_ticks - sim_timer[group][timer].zero;
+    return ESP_OK;
+}
+
+esp_err_t timer_set_alarm_value(timer_group_t group, timer_idx_t timer, uint64_t value) {
+    sim_hw_timer_t* hw = sim_hw(group, timer);
+    hw->alarm_low = (uint32_t)value;
+    hw->alarm_high = (uint32_t)(value >> 32);
+    return ESP_OK;
+}
+
+esp_err_t timer_set_alarm(timer_group_t group, timer_idx_t timer, timer_alarm_t alarm) {
+    sim_hw(group, timer)->config.alarm_en = alarm;
+    return ESP_OK;
+}
+
+esp_err_t timer_start(timer_group_t group, timer_idx_t timer) {
+    sim_hw(group, timer)->config.enable = 1;
+    return ESP_OK;
+}
+
+esp_err_t timer_pause(timer_group_t group, timer_idx_t timer) {
+    sim_hw(group, timer)->config.enable = 0;
+    return ESP_OK;
+}
+
+esp_err_t timer_enable_intr(timer_group_t group, timer_idx_t timer) {
+    return ESP_OK;
+}
+
+esp_err_t timer_isr_register(timer_group_t group, timer_idx_t timer, void (*handler)(void*), void* arg,
+                             int flags, timer_isr_handle_t* handle) {
+    sim_timer[group][timer].handler = handler;
+    sim_timer[group][timer].arg = arg;
+    return ESP_OK;
+}
+
+// Sets due to when the alarm of a timer fires. False if it is not armed.
+static bool sim_timer_due(timer_idx_t timer, uint64_t* due) {
+    sim_hw_timer_t* hw = sim_hw(TIMER_GROUP_0, timer);
+    if (!hw->config.enable || !hw->config.alarm_en || sim_timer[TIMER_GROUP_0][timer].handler == NULL)
+        return false;
+    uint64_t alarm = ((uint64_t)hw->alarm_high << 32) | hw->alarm_low;
+    *due = sim_timer[TIMER_GROUP_0][timer].zero + alarm;
+    if (*due < sim_ticks)
+        *due = sim_ticks;  // Already past the alarm, which fires right away
+    return true;
+}
+
+static void sim_timer_fire(timer_idx_t timer, uint64_t due) {
+    sim_hw_timer_t* hw = sim_hw(TIMER_GROUP_0, timer);
+    sim_ticks = due;
+    hw->config.alarm_en = 0;
+    if (hw->config.autoreload)
+        sim_timer[TIMER_GROUP_0][timer].zero = due;
+    sim_in_isr = true;
+    sim_timer[TIMER_GROUP_0][timer].handler(sim_timer[TIMER_GROUP_0][timer].arg);
+    sim_in_isr = false;
+}
+
+// What the segment prep task does when the step ISR notifies it, see segmentPrepTask()
+static void sim_prep_task() {
+    if (sim_take_notifications() == 0)
+        return;
+    if (sys.state & (STATE_CYCLE | STATE_HOLD | STATE_SAFETY_DOOR | STATE_HOMING | STATE_SLEEP | STATE_JOG)) {
+        mc_line_queue_flush();
+        st_prep_buffer();
+    }
+}
+
+bool sim_run_next_interrupt() {
+    uint64_t step_due, off_due;
+    if (!sim_timer_due(STEP_TIMER_INDEX, &step_due))
+        return false;
+    if (sim_timer_due(STEP_PULSE_OFF_TIMER_INDEX, &off_due) && off_due <= step_due)
+        sim_timer_fire(STEP_PULSE_OFF_TIMER_INDEX, off_due);
+    sim_timer_fire(STEP_TIMER_INDEX, step_due);
+    sim_prep_task();
+    return true;
+}
+
+void sim_run_for(uint64_t ticks) {
+    uint64_t end = sim_ticks + ticks;
+    uint64_t due;
+    while (sim_timer_due(STEP_TIMER_INDEX, &due) && due <= end)
+        sim_run_next_interrupt();
+    if (sim_timer_due(STEP_PULSE_OFF_TIMER_INDEX, &due) && due <= end)
+        sim_timer_fire(STEP_PULSE_OFF_TIMER_INDEX, due);
+    sim_ticks = end;
+}
+
+void sim_timeline_event(const char* kind, uint8_t mask) {
+    if (sim_timeline != NULL)
+        fprintf(sim_timeline, "%.2f %s %02x\n", sim_ticks / (double)SIM_TICKS_PER_USEC, kind, mask);
+}
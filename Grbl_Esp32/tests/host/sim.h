@@ -0,0 +1,52 @@
+/*
+  sim.h - Simulated clock and step timer of the host build
+  Part of Grbl_ESP32
+
+  The host build runs the parser, planner and stepper in one thread. Nothing runs on its own:
+  time only advances when the firmware waits for it, in protocol_execute_realtime() and the
+  delay functions, and then the step timer interrupts that fall due are called in order.
+
+  Grbl is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  Grbl is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with Grbl.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#pragma once
+
+#include <stdint.h>
+#include <stdio.h>
+
+// Simulated time, in ticks of the step timer (F_STEPPER_TIMER)
+#define SIM_TICKS_PER_USEC 20
+extern uint64_t sim_ticks;
+
+// True while an interrupt handler runs. Returned by xPortInIsrContext().
+extern bool sim_in_isr;
+
+// Task notifications since the last sim_take_notifications(). Tasks are never run, so the only
+// one notified is the segment prep task, and the simulation does its work when it is notified.
+uint32_t sim_take_notifications();
+
+// Runs the step timer interrupts that fall due before now + ticks, then sets the clock there.
+void sim_run_for(uint64_t ticks);
+
+// Runs the next step timer interrupt, with the step pulse off interrupt before it if that is
+// due first. Returns false, without advancing the clock, if the step timer is stopped.
+bool sim_run_next_interrupt();
+
+// Step/dir timeline. When set, each step and each direction change is written as
+// "<usec> step <mask>" or "<usec> dir <mask>", with the axis masks in hex.
+extern FILE* sim_timeline;
+void sim_timeline_event(const char* kind, uint8_t mask);
+
+// Output of grbl_sendf() and the reports. Off for quiet runs.
+extern bool sim_echo;
@@ -0,0 +1,221 @@
+/*
+  sim_grbl.cpp - Grbl modules the host build replaces
+  Part of Grbl_ESP32
+
+  The host build compiles the parser, planner, stepper and what they call into. This file stands
+  in for the rest: the protocol loop, the reports, the motor drivers, the SD card and the job
+  cache. The realtime executor only handles what a replayed job can raise on its own. There is
+  nobody to resume a hold, so holds and pauses (M0) are dropped.
+
+  Grbl is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  Grbl is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with Grbl.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "grbl.h"
+#include "sim.h"
+
+// System state, as in Grbl_Esp32.ino
+system_t sys;
+int32_t sys_position[N_AXIS];
+int32_t sys_probe_position[N_AXIS];
+volatile uint8_t sys_probe_state;
+volatile uint8_t sys_rt_exec_state;
+volatile uint8_t sys_rt_exec_alarm;
+volatile uint8_t sys_rt_exec_motion_override;
+volatile uint8_t sys_rt_exec_accessory_override;
+#ifdef DEBUG
+    volatile uint8_t sys_rt_exec_debug;
+#endif
+
+Spindle* spindle;
+
+// Last alarm raised, 0 if none
+uint8_t sim_alarm;
+
+// Calls to protocol_execute_realtime() since the clock last moved. A wait that never lets time
+// pass, like a cycle that does not start, would otherwise spin forever.
+#define SIM_STALL_LIMIT 1000000
+static uint32_t sim_stalled_calls;
+static uint64_t sim_stalled_at;
+
+// Protocol
+
+void protocol_buffer_synchronize() {
+    mc_line_queue_flush();
+    protocol_auto_cycle_start();
+    do {
+        protocol_execute_realtime();
+        if (sys.abort)  return;
+    } while (plan_get_current_block() || (sys.state == STATE_CYCLE) || mc_line_queue_count());
+}
+
+void protocol_auto_cycle_start() {
+    if (plan_get_current_block() != NULL)
+        system_set_exec_state_flag(EXEC_CYCLE_START);
+}
+
+// Runs the realtime executor, then lets the machine run to its next step.
+void protocol_execute_realtime() {
+    protocol_exec_rt_system();
+    if (sys.abort)
+        return;
+    if (sim_run_next_interrupt() || sim_ticks != sim_stalled_at) {
+        sim_stalled_at = sim_ticks;
+        sim_stalled_calls = 0;
+    } else if (++sim_stalled_calls == SIM_STALL_LIMIT) {
+        grbl_msg_sendf(CLIENT_ALL, MSG_LEVEL_INFO, "Stalled in state %d with the steppers stopped", sys.state);
+        sys.abort = true;
+    }
+}
+
+void protocol_exec_rt_system() {
+    uint8_t rt_exec = sys_rt_exec_alarm;
+    if (rt_exec) {
+        sys.state = STATE_ALARM;
+        sim_alarm = rt_exec;
+        report_alarm_message(rt_exec);
+        // The firmware waits for a reset after a limit alarm. That ends the replay.
+        if ((rt_exec == EXEC_ALARM_HARD_LIMIT) || (rt_exec == EXEC_ALARM_SOFT_LIMIT))
+            sys.abort = true;
+        system_clear_exec_alarm();
+    }
+    rt_exec = sys_rt_exec_state;
+    if (!rt_exec)
+        return;
+    if (rt_exec & EXEC_RESET) {
+        sys.abort = true;
+        return;
+    }
+    if (rt_exec & EXEC_CYCLE_START) {
+        if (sys.state == STATE_IDLE) {
+            sys.step_control = STEP_CONTROL_NORMAL_OP;
+            if (plan_get_current_block()) {
+                sys.suspend = SUSPEND_DISABLE;
+                sys.state = STATE_CYCLE;
+                st_prep_buffer(); // Initialize step segment buffer before beginning cycle.
+                st_wake_up();
+            }
+        }
+    }
+    if (rt_exec & EXEC_CYCLE_STOP) {
+        if (sys.suspend & SUSPEND_JOG_CANCEL) {
+            sys.step_control = STEP_CONTROL_NORMAL_OP;
+            mc_line_queue_reset();
+            plan_reset();
+            st_reset();
+            gc_sync_position();
+            plan_sync_position();
+        }
+        sys.suspend = SUSPEND_DISABLE;
+        if (sys.state != STATE_ALARM)
+            sys.state = STATE_IDLE;
+    }
+    system_clear_exec_state_flag(EXEC_STATUS_REPORT | EXEC_CYCLE_START | EXEC_CYCLE_STOP | EXEC_FEED_HOLD |
+                                 EXEC_MOTION_CANCEL | EXEC_SAFETY_DOOR | EXEC_SLEEP);
+}
+
+// Reports
+
+void grbl_sendf(uint8_t client, const char* format, ...) {
+    if (!sim_echo || client == CLIENT_INPUT)
+        return;
+    va_list arg;
+    va_start(arg, format);
+    vprintf(format, arg);
+    va_end(arg);
+}
+
+void grbl_msg_sendf(uint8_t client, uint8_t level, const char* format, ...) {
+    if (!sim_echo || client == CLIENT_INPUT || level > GRBL_MSG_LEVEL)
+        return;
+    va_list arg;
+    va_start(arg, format);
+    printf("[MSG:");
+    vprintf(format, arg);
+    printf("]\r\n");
+    va_end(arg);
+}
+
+void report_status_message(uint8_t status_code, uint8_t client) {
+    if (status_code == STATUS_OK)
+        grbl_sendf(client, "ok\r\n");
+    else
+        grbl_sendf(client, "error:%d\r\n", status_code);
+}
+
+void report_alarm_message(uint8_t alarm_code) {
+    grbl_sendf(CLIENT_ALL, "ALARM:%d\r\n", alarm_code);
+}
+
+void report_feedback_message(uint8_t message_code) {
+    grbl_sendf(CLIENT_ALL, "[MSG:%d]\r\n", message_code);
+}
+
+void report_probe_parameters(uint8_t client) {
+    float print_position[N_AXIS];
+    system_convert_array_steps_to_mpos(print_position, sys_probe_position);
+    grbl_sendf(client, "[PRB:%.3f,%.3f,%.3f:%d]\r\n", print_position[X_AXIS], print_position[Y_AXIS],
+               print_position[Z_AXIS], sys.probe_succeeded);
+}
+
+void report_gcode_comment(char* comment) {}
+
+// Motors. Steps and direction changes go to the timeline.
+
+static uint8_t sim_dir_mask;
+
+void motors_set_homing_mode(uint8_t homing_mask, bool isHoming) {}
+void motors_set_disable(bool disable) {}
+
+void motors_set_direction_pins(uint8_t onMask) {
+    if (onMask != sim_dir_mask) {
+        sim_dir_mask = onMask;
+        sim_timeline_event("dir", onMask);
+    }
+}
+
+void motors_step(uint8_t step_mask, uint8_t dir_mask) {
+    if (step_mask)
+        sim_timeline_event("step", step_mask);
+}
+
+// SD card and job cache. There is no card, so nothing is recorded.
+
+uint32_t sd_current_line_number;
+
+uint8_t get_sd_state(bool refresh) { return SDCARD_NOT_PRESENT; }
+boolean closeFile() { return true; }
+
+bool job_cache_recording;
+
+void job_cache_record_line(float* target, plan_line_data_t* pl_data) {}
+void job_cache_record_arc(float* target, plan_line_data_t* pl_data, float* offset, float radius,
+                          uint8_t axis_0, uint8_t axis_1, uint8_t axis_linear, uint8_t is_clockwise_arc) {}
+void job_cache_record_probe() {}
+
+// Setting checks of the WiFi and web modules
+
+bool COMMANDS::isLocalPasswordValid(char* password) { return true; }
+bool WiFiConfig::isPasswordValid(const char* password) { return true; }
+
+char* trim(char* str) {
+    while (isspace((unsigned char)*str))
+        str++;
+    if (*str == 0)
+        return str;
+    char* end = str + strlen(str) - 1;
+    while (end > str && isspace((unsigned char)*end))
+        end--;
+    end[1] = '\0';
+    return str;
+}
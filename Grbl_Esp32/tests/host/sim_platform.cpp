@@ -0,0 +1,297 @@
+/*
+  sim_platform.cpp - Arduino, ESP-IDF and FreeRTOS functions of the host build
+  Part of Grbl_ESP32
+
+  Time is the simulated clock, and waiting for it runs the machine, see sim.h. Pins only keep
+  what was written to them. Queues, NVS and EEPROM are kept in memory, so every run starts
+  from the defaults.
+
+  Grbl is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  Grbl is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with Grbl.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "Arduino.h"
+#include "EEPROM.h"
+#include "nvs.h"
+#include "driver/timer.h"
+#include "driver/uart.h"
+#include "sim.h"
+#include <deque>
+#include <map>
+#include <vector>
+
+EspClass ESP;
+EEPROMClass EEPROM;
+
+// Time
+
+uint32_t millis() { return sim_ticks / (SIM_TICKS_PER_USEC * 1000); }
+uint32_t micros() { return sim_ticks / SIM_TICKS_PER_USEC; }
+int64_t esp_timer_get_time() { return sim_ticks / SIM_TICKS_PER_USEC; }
+uint32_t xthal_get_ccount() { return (uint32_t)(sim_ticks * (240 / SIM_TICKS_PER_USEC)); }
+uint32_t getApbFrequency() { return 80000000; }
+
+void delay(uint32_t ms) { sim_run_for((uint64_t)ms * 1000 * SIM_TICKS_PER_USEC); }
+void delayMicroseconds(uint32_t us) { sim_run_for((uint64_t)us * SIM_TICKS_PER_USEC); }
+
+long random(long max) { return max > 0 ? rand() % max : 0; }
+long random(long min, long max) { return min + random(max - min); }
+
+// Pins
+
+static uint8_t sim_pin_level[GPIO_NUM_MAX];
+
+extern "C" void __pinMode(uint8_t pin, uint8_t mode) {}
+
+extern "C" void __digitalWrite(uint8_t pin, uint8_t val) {
+    if (pin < GPIO_NUM_MAX)
+        sim_pin_level[pin] = val ? HIGH : LOW;
+}
+
+extern "C" int __digitalRead(uint8_t pin) { return pin < GPIO_NUM_MAX ? sim_pin_level[pin] : LOW; }
+
+double ledcSetup(uint8_t channel, double frequency, uint8_t resolution) { return frequency; }
+void ledcAttachPin(uint8_t pin, uint8_t channel) {}
+void ledcWrite(uint8_t channel, uint32_t duty) {}
+void dacWrite(uint8_t pin, uint8_t value) {}
+void attachInterrupt(uint8_t pin, void (*handler)(void), int mode) {}
+void detachInterrupt(uint8_t pin) {}
+
+// FreeRTOS
+
+static uint32_t sim_notifications;
+
+uint32_t sim_take_notifications() {
+    uint32_t n = sim_notifications;
+    sim_notifications = 0;
+    return n;
+}
+
+BaseType_t xPortInIsrContext() { return sim_in_isr; }
+uint32_t xPortGetCoreID() { return CONFIG_ARDUINO_RUNNING_CORE; }
+
+// Any address will do for a handle, since the task is never run
+static uint8_t sim_task_handles;
+
+BaseType_t xTaskCreatePinnedToCore(TaskFunction_t task, const char* name, uint32_t stack, void* parameters,
+                                   UBaseType_t priority, TaskHandle_t* handle, BaseType_t core) {
+    if (handle != NULL)
+        *handle = &sim_task_handles;
+    return pdPASS;
+}
+
+BaseType_t xTaskCreate(TaskFunction_t task, const char* name, uint32_t stack, void* parameters,
+                       UBaseType_t priority, TaskHandle_t* handle) {
+    return xTaskCreatePinnedToCore(task, name, stack, parameters, priority, handle, 0);
+}
+
+void vTaskDelay(TickType_t ticks) { delay(ticks * portTICK_PERIOD_MS); }
+
+void vTaskDelayUntil(TickType_t* previous, TickType_t ticks) {
+    *previous += ticks;
+    if (*previous > xTaskGetTickCount())
+        delay((*previous - xTaskGetTickCount()) * portTICK_PERIOD_MS);
+}
+
+TickType_t xTaskGetTickCount() { return millis() / portTICK_PERIOD_MS; }
+TickType_t xTaskGetTickCountFromISR() { return xTaskGetTickCount(); }
+
+uint32_t ulTaskNotifyTake(BaseType_t clear, TickType_t ticks) {
+    uint32_t n = sim_notifications;
+    sim_notifications = clear ? 0 : n;
+    return n;
+}
+
+BaseType_t xTaskNotifyGive(TaskHandle_t task) {
+    sim_notifications++;
+    return pdPASS;
+}
+
+void vTaskNotifyGiveFromISR(TaskHandle_t task, BaseType_t* woken) {
+    sim_notifications++;
+    if (woken != NULL)
+        *woken = pdTRUE;
+}
+
+TaskHandle_t xTaskGetCurrentTaskHandle() { return NULL; }
+UBaseType_t uxTaskGetStackHighWaterMark(TaskHandle_t task) { return 0; }
+
+struct sim_queue {
+    UBaseType_t length;
+    UBaseType_t item_size;
+    std::deque<std::vector<uint8_t>> items;
+};
+
+QueueHandle_t xQueueCreate(UBaseType_t length, UBaseType_t item_size) {
+    sim_queue* queue = new sim_queue;
+    queue->length = length;
+    queue->item_size = item_size;
+    return queue;
+}
+
+BaseType_t xQueueSend(QueueHandle_t queue, const void* item, TickType_t ticks) {
+    if (queue->items.size() >= queue->length)
+        return pdFAIL;
+    const uint8_t* bytes = (const uint8_t*)item;
+    queue->items.push_back(std::vector<uint8_t>(bytes, bytes + queue->item_size));
+    return pdPASS;
+}
+
+BaseType_t xQueueSendFromISR(QueueHandle_t queue, const void* item, BaseType_t* woken) {
+    return xQueueSend(queue, item, 0);
+}
+
+BaseType_t xQueueReceive(QueueHandle_t queue, void* item, TickType_t ticks) {
+    if (queue->items.empty())
+        return pdFAIL;
+    memcpy(item, queue->items.front().data(), queue->item_size);
+    queue->items.pop_front();
+    return pdPASS;
+}
+
+BaseType_t xQueueReset(QueueHandle_t queue) {
+    queue->items.clear();
+    return pdPASS;
+}
+
+UBaseType_t uxQueueMessagesWaiting(QueueHandle_t queue) { return queue->items.size(); }
+
+// There is only one thread, so every take succeeds
+static uint8_t sim_semaphores;
+
+SemaphoreHandle_t xSemaphoreCreateMutex() { return &sim_semaphores; }
+SemaphoreHandle_t xSemaphoreCreateRecursiveMutex() { return &sim_semaphores; }
+SemaphoreHandle_t xSemaphoreCreateBinary() { return &sim_semaphores; }
+BaseType_t xSemaphoreTake(SemaphoreHandle_t semaphore, TickType_t ticks) { return pdTRUE; }
+BaseType_t xSemaphoreGive(SemaphoreHandle_t semaphore) { return pdTRUE; }
+BaseType_t xSemaphoreTakeRecursive(SemaphoreHandle_t semaphore, TickType_t ticks) { return pdTRUE; }
+BaseType_t xSemaphoreGiveRecursive(SemaphoreHandle_t semaphore) { return pdTRUE; }
+
+// NVS. Each namespace gets its own handle.
+
+static std::vector<std::string> sim_nvs_namespaces;
+static std::map<std::string, std::vector<uint8_t>> sim_nvs;
+
+static std::string sim_nvs_key(nvs_handle handle, const char* key) {
+    return sim_nvs_namespaces[handle - 1] + "/" + key;
+}
+
+static esp_err_t sim_nvs_get(nvs_handle handle, const char* key, void* value, size_t* length) {
+    auto entry = sim_nvs.find(sim_nvs_key(handle, key));
+    if (entry == sim_nvs.end())
+        return ESP_ERR_NVS_NOT_FOUND;
+    if (value != NULL) {
+        if (*length < entry->second.size())
+            return ESP_ERR_NVS_INVALID_LENGTH;
+        memcpy(value, entry->second.data(), entry->second.size());
+    }
+    *length = entry->second.size();
+    return ESP_OK;
+}
+
+static esp_err_t sim_nvs_set(nvs_handle handle, const char* key, const void* value, size_t length) {
+    const uint8_t* bytes = (const uint8_t*)value;
+    sim_nvs[sim_nvs_key(handle, key)] = std::vector<uint8_t>(bytes, bytes + length);
+    return ESP_OK;
+}
+
+esp_err_t nvs_open(const char* name, nvs_open_mode mode, nvs_handle* handle) {
+    for (size_t i = 0; i < sim_nvs_namespaces.size(); i++) {
+        if (sim_nvs_namespaces[i] == name) {
+            *handle = i + 1;
+            return ESP_OK;
+        }
+    }
+    sim_nvs_namespaces.push_back(name);
+    *handle = sim_nvs_namespaces.size();
+    return ESP_OK;
+}
+
+void nvs_close(nvs_handle handle) {}
+
+esp_err_t nvs_get_i8(nvs_handle handle, const char* key, int8_t* value) {
+    size_t length = sizeof(*value);
+    return sim_nvs_get(handle, key, value, &length);
+}
+
+esp_err_t nvs_set_i8(nvs_handle handle, const char* key, int8_t value) {
+    return sim_nvs_set(handle, key, &value, sizeof(value));
+}
+
+esp_err_t nvs_get_i32(nvs_handle handle, const char* key, int32_t* value) {
+    size_t length = sizeof(*value);
+    return sim_nvs_get(handle, key, value, &length);
+}
+
+esp_err_t nvs_set_i32(nvs_handle handle, const char* key, int32_t value) {
+    return sim_nvs_set(handle, key, &value, sizeof(value));
+}
+
+esp_err_t nvs_get_str(nvs_handle handle, const char* key, char* value, size_t* length) {
+    return sim_nvs_get(handle, key, value, length);
+}
+
+esp_err_t nvs_set_str(nvs_handle handle, const char* key, const char* value) {
+    return sim_nvs_set(handle, key, value, strlen(value) + 1);
+}
+
+esp_err_t nvs_get_blob(nvs_handle handle, const char* key, void* value, size_t* length) {
+    return sim_nvs_get(handle, key, value, length);
+}
+
+esp_err_t nvs_set_blob(nvs_handle handle, const char* key, const void* value, size_t length) {
+    return sim_nvs_set(handle, key, value, length);
+}
+
+esp_err_t nvs_erase_key(nvs_handle handle, const char* key) {
+    return sim_nvs.erase(sim_nvs_key(handle, key)) ? ESP_OK : ESP_ERR_NVS_NOT_FOUND;
+}
+
+esp_err_t nvs_erase_all(nvs_handle handle) {
+    std::string prefix = sim_nvs_namespaces[handle - 1] + "/";
+    for (auto entry = sim_nvs.begin(); entry != sim_nvs.end();) {
+        if (entry->first.compare(0, prefix.length(), prefix) == 0)
+            entry = sim_nvs.erase(entry);
+        else
+            ++entry;
+    }
+    return ESP_OK;
+}
+
+esp_err_t nvs_commit(nvs_handle handle) { return ESP_OK; }
+
+esp_err_t nvs_get_stats(const char* partition, nvs_stats_t* stats) {
+    stats->used_entries = sim_nvs.size();
+    stats->total_entries = 504;
+    stats->free_entries = stats->total_entries - stats->used_entries;
+    stats->namespace_count = sim_nvs_namespaces.size();
+    return ESP_OK;
+}
+
+// UART. Only the RS485 spindles use it, and nothing answers them.
+
+esp_err_t uart_param_config(uart_port_t port, const uart_config_t* config) { return ESP_OK; }
+esp_err_t uart_set_pin(uart_port_t port, int tx, int rx, int rts, int cts) { return ESP_OK; }
+esp_err_t uart_driver_install(uart_port_t port, int rx_size, int tx_size, int queue_size, QueueHandle_t* queue,
+                              int flags) {
+    return ESP_OK;
+}
+esp_err_t uart_driver_delete(uart_port_t port) { return ESP_OK; }
+esp_err_t uart_set_mode(uart_port_t port, uart_mode_t mode) { return ESP_OK; }
+esp_err_t uart_flush(uart_port_t port) { return ESP_OK; }
+int uart_read_bytes(uart_port_t port, uint8_t* data, uint32_t length, TickType_t ticks) { return 0; }
+int uart_write_bytes(uart_port_t port, const char* data, size_t size) { return size; }
+esp_err_t uart_get_baudrate(uart_port_t port, uint32_t* baudrate) {
+    *baudrate = 115200;
+    return ESP_OK;
+}
@@ -1,6 +1,7 @@
 G21
 G90 (A standard comment)
 G1 Z3.810 F228.6 ; a LinuxCNC style comment
+(Expected error:25, X is given twice)
 G0x0x0 (some lowercase)
 G0 X10 (internal comment) Y0
 G0X0 (internal comment; with semi colon) Y0Z3
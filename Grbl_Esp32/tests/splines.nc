@@ -0,0 +1,45 @@
+(G5 and G5.1 splines. Run in check mode, $C, or on a machine with room around the origin.)
+(The last lines are expected to fail, see the comments.)
+G21
+G90
+G17
+G94
+G0 X0 Y0 Z1
+G1 Z0 F600
+(Cubic S curve. I,J and P,Q are incremental from the start and from the end point.)
+G5 I10 J0 P-10 Q0 X20 Y20
+(No I,J: the first control point mirrors the last P,Q, so the joint is smooth)
+G5 P0 Q-10 X40 Y0
+G5 P-5 Q5 X60 Y-10
+(Negative P,Q put the second control point behind and below the end point)
+G5 I5 J5 P-15 Q-15 X80 Y10
+(Helical spline, Z moves in proportion to the curve parameter)
+G5 I5 J10 P5 Q10 X60 Y30 Z-2
+G1 Z0
+(Relative end points, the control points stay incremental)
+G91
+G5 I0 J10 P0 Q10 X-20 Y0
+G90
+(Quadratic spline, one control point given by I,J)
+G5.1 I10 J20 X20 Y40
+G5.1 I-10 J-20 X0 Y0
+(Inverse time: the whole curve takes 1/F minutes)
+G93
+G5 I10 J10 P10 Q-10 X20 Y0 F30
+G94
+(Inches)
+G20
+G5 I0.2 J0.4 P-0.2 Q0.4 X1 Y0 F20
+G21
+G0 X0 Y0 Z1
+(Expected error:40, G5 outside the G17 plane)
+G18
+G5 I10 J0 P-10 Q0 X20 Z20
+(Expected error:40 for G5.1 as well)
+G19
+G5.1 I10 J10 Y20 Z0
+G17
+(Expected error:28, G5.1 needs I,J)
+G5.1 X10 Y10
+(Expected error:28, G5 needs P and Q)
+G5 I1 J1 P1 X10 Y10
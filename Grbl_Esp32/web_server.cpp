@@ -1568,6 +1568,8 @@ void Web_Server::handle_Websocket_Event(uint8_t num, uint8_t type, uint8_t * pay
     switch(type) {
         case WStype_DISCONNECTED:
             //USE_SERIAL.printf("[%u] Disconnected!\n", num);
+            if (_socket_server->connectedClients() == 0)
+                report_autoreport_reset(CLIENT_WEBUI);
             break;
         case WStype_CONNECTED:
             {